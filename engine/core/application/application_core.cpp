@@ -276,6 +276,14 @@ void ApplicationCore::setRenderSettings(const RenderSettings& settings)
         m_renderer->setGamma(settings.gamma);
         m_renderer->setSeed(settings.seed);
         m_renderer->setSampleCount(settings.samples);
+
+        ProgressiveRenderSettings progressive;
+        progressive.targetSpp = settings.raytraceSpp;
+        progressive.timeBudgetMs = static_cast<double>(settings.timeBudgetSeconds) * 1000.0;
+        progressive.noiseThreshold = settings.noiseThreshold;
+        progressive.adaptiveThreshold = settings.adaptiveThreshold;
+        m_renderer->setProgressiveSettings(progressive);
+        m_renderer->setSampleDensityOutput(settings.sampleDensityPath);
     }
 }
 
@@ -324,6 +332,36 @@ int ApplicationCore::getReflectionSpp() const
     return m_renderer->getReflectionSpp();
 }
 
+void ApplicationCore::setTileSchedulerSettings(const TileSchedulerSettings& settings)
+{
+    m_renderer->setTileSchedulerSettings(settings);
+}
+
+void ApplicationCore::setPathTracerSettings(const PathTracerSettings& settings)
+{
+    m_renderer->setPathTracerSettings(settings);
+}
+
+void ApplicationCore::setBVHCacheEnabled(bool enabled)
+{
+    m_renderer->setBVHCacheEnabled(enabled);
+}
+
+void ApplicationCore::setBVHBuildAlgorithm(BVHBuildAlgorithm algorithm)
+{
+    m_renderer->setBVHBuildAlgorithm(algorithm);
+}
+
+void ApplicationCore::setGBufferCacheEnabled(bool enabled)
+{
+    m_renderer->setGBufferCacheEnabled(enabled);
+}
+
+void ApplicationCore::setLightSamplingSettings(const LightSamplingSettings& settings)
+{
+    m_renderer->setLightSamplingSettings(settings);
+}
+
 void ApplicationCore::handleMouseMove(double xpos, double ypos)
 {
     if (m_firstMouse) {
@@ -369,6 +407,7 @@ void ApplicationCore::handleMouseMove(double xpos, double ypos)
                 if (m_dragObjectIndex >= 0) {
                     auto& obj = m_scene->getObjects()[m_dragObjectIndex];
                     obj.modelMatrix = glm::translate(glm::mat4(1.0f), delta) * m_modelStart;
+                    m_scene->notifyObjectChanged(m_dragObjectIndex, SceneChangeType::TransformChanged);
                 } else if (m_dragLightIndex >= 0 && m_dragLightIndex < (int)m_lights->m_lights.size()) {
                     m_lights->m_lights[(size_t)m_dragLightIndex].position = m_dragOriginWorld + delta;
                 }
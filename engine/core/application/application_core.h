@@ -11,6 +11,10 @@
 #include <glm/glm.hpp>
 #include "gizmo.h"
 #include "render_settings.h"
+#include "tile_scheduler.h"
+#include "path_integrator.h"
+#include "light_sampler.h"
+#include "bvh_builder.h"
 
 // Forward declarations
 struct GLFWwindow;
@@ -102,6 +106,30 @@ public:
     /// @brief Returns the current reflection samples-per-pixel count.
     /// @return Active reflection SPP value.
     int getReflectionSpp() const;
+
+    /// @brief Sets raytracer tile size, tile order, and render thread count.
+    /// @param settings Scheduler parameters to apply.
+    void setTileSchedulerSettings(const TileSchedulerSettings& settings);
+
+    /// @brief Selects the raytracer integrator and its bounce limits.
+    /// @param settings Integrator parameters to apply.
+    void setPathTracerSettings(const PathTracerSettings& settings);
+
+    /// @brief Enables or disables the on-disk cache of raytracer mesh BVHs.
+    /// @param enabled True to load and store BVHs under the user cache directory.
+    void setBVHCacheEnabled(bool enabled);
+
+    /// @brief Selects the builder for raytracer mesh BVHs.
+    /// @param algorithm Binned SAH for final renders, LBVH for faster builds.
+    void setBVHBuildAlgorithm(BVHBuildAlgorithm algorithm);
+
+    /// @brief Enables or disables the raytracer's first-hit G-buffer cache.
+    /// @param enabled True to reshade cached camera hits when only lights or materials change.
+    void setGBufferCacheEnabled(bool enabled);
+
+    /// @brief Selects how the raytracer picks lights in scenes with many lights.
+    /// @param settings Light selection parameters to apply.
+    void setLightSamplingSettings(const LightSamplingSettings& settings);
     
     /// @brief Configures schema validation behavior for JSON inputs.
     /// @param enabled True to enforce schema validation.
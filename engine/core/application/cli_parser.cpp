@@ -61,6 +61,8 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
     result.options.enableDenoise = hasFlag("--denoise");
     result.options.forceRaytrace = hasFlag("--raytrace");
     result.options.strictSchema = hasFlag("--strict-schema");
+    result.options.bvhCache = !hasFlag("--no-bvh-cache");
+    result.options.gbufferCache = hasFlag("--gbuffer-cache");
     
     // Parse values
     result.options.opsFile = getValue("--ops");
@@ -70,12 +72,24 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
     result.options.outputHeight = getIntValue("--h", 1024);
     result.options.reflectionSpp = getIntValue("--refl-spp", 8);
     int samplesVal = getIntValue("--samples", 1);
+    int threadsVal = getIntValue("--threads", 0);
+    int tileSizeVal = getIntValue("--tile-size", result.options.tileScheduler.tileSize);
+    std::string tileOrderStr = getValue("--tile-order", tileOrderName(result.options.tileScheduler.order));
+    std::string integratorStr = getValue("--integrator", integratorTypeName(result.options.pathTracer.integrator));
+    int maxBouncesVal = getIntValue("--max-bounces", result.options.pathTracer.maxBounces);
+    std::string lightSamplingStr = getValue("--light-sampling", lightSamplingModeName(result.options.lightSampling.mode));
+    int lightSamplesVal = getIntValue("--light-samples", result.options.lightSampling.samplesPerPoint);
+    std::string bvhBuilderStr = getValue("--bvh-builder", bvhBuildAlgorithmName(result.options.bvhBuilder));
     
     // Parse render settings
     std::string seedStr = getValue("--seed", "0");
     std::string toneStr = getValue("--tone", "linear");
     std::string exposureStr = getValue("--exposure", "0.0");
     std::string gammaStr = getValue("--gamma", "2.2");
+    int sppVal = getIntValue("--spp", 1);
+    std::string timeBudgetStr = getValue("--time-budget");
+    std::string noiseThresholdStr = getValue("--noise-threshold");
+    std::string adaptiveStr = getValue("--adaptive");
 
     // Validate samples when flag provided
     if (hasFlag("--samples")) {
@@ -164,6 +178,59 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
         }
         result.options.renderSettings.gamma = parseGamma(gammaStr);
     }
+
+    // Progressive raytracing budgets
+    if (hasFlag("--spp")) {
+        if (sppVal < 1) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid spp value: must be >= 1";
+            return result;
+        }
+        result.options.renderSettings.raytraceSpp = sppVal;
+    }
+
+    auto parseNonNegative = [](const std::string& str, float& value) -> bool {
+        try {
+            size_t pos = 0;
+            value = std::stof(str, &pos);
+            return pos == str.size() && value >= 0.0f;
+        } catch (...) {
+            return false;
+        }
+    };
+
+    if (hasFlag("--time-budget")) {
+        if (!parseNonNegative(timeBudgetStr, result.options.renderSettings.timeBudgetSeconds)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid time budget: " + timeBudgetStr + " (expected seconds >= 0)";
+            return result;
+        }
+    }
+
+    if (hasFlag("--noise-threshold")) {
+        if (!parseNonNegative(noiseThresholdStr, result.options.renderSettings.noiseThreshold)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid noise threshold: " + noiseThresholdStr + " (expected a float >= 0)";
+            return result;
+        }
+    }
+
+    if (hasFlag("--adaptive")) {
+        if (!parseNonNegative(adaptiveStr, result.options.renderSettings.adaptiveThreshold)) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Invalid adaptive threshold: " + adaptiveStr + " (expected a float >= 0)";
+            return result;
+        }
+    }
+
+    if (hasFlag("--sample-density")) {
+        result.options.renderSettings.sampleDensityPath = getValue("--sample-density");
+        if (result.options.renderSettings.sampleDensityPath.empty()) {
+            result.exitCode = CLIExitCode::UnknownFlag;
+            result.errorMessage = "Missing value for --sample-density (expected a PNG path)";
+            return result;
+        }
+    }
     
     // Validate render settings
     if (hasFlag("--seed")) {
@@ -261,6 +328,59 @@ CLIParseResult CLIParser::parse(int argc, char** argv)
         result.errorMessage = "Reflection samples per pixel (--refl-spp) must be a positive integer";
         return result;
     }
+
+    // Validate raytracer scheduling
+    if (threadsVal < 0) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Render threads (--threads) must be 0 (all cores) or a positive integer";
+        return result;
+    }
+    result.options.tileScheduler.threadCount = static_cast<unsigned>(threadsVal);
+
+    if (tileSizeVal <= 0) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Tile size (--tile-size) must be a positive integer";
+        return result;
+    }
+    result.options.tileScheduler.tileSize = tileSizeVal;
+
+    if (!parseTileOrder(tileOrderStr, result.options.tileScheduler.order)) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Invalid tile order: " + tileOrderStr + " (expected scanline|morton|spiral)";
+        return result;
+    }
+
+    if (!parseIntegratorType(integratorStr, result.options.pathTracer.integrator)) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Invalid integrator: " + integratorStr + " (expected whitted|path)";
+        return result;
+    }
+
+    if (maxBouncesVal < 0) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Max bounces (--max-bounces) must be a non-negative integer";
+        return result;
+    }
+    result.options.pathTracer.maxBounces = maxBouncesVal;
+
+    if (!parseLightSamplingMode(lightSamplingStr, result.options.lightSampling.mode)) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Invalid light sampling mode: " + lightSamplingStr + " (expected auto|all|power|tree)";
+        return result;
+    }
+
+    if (lightSamplesVal <= 0) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Light samples (--light-samples) must be a positive integer";
+        return result;
+    }
+    result.options.lightSampling.samplesPerPoint = lightSamplesVal;
+
+    if (!parseBVHBuildAlgorithm(bvhBuilderStr, result.options.bvhBuilder)) {
+        result.exitCode = CLIExitCode::UnknownFlag;
+        result.errorMessage = "Invalid BVH builder: " + bvhBuilderStr + " (expected sah|lbvh)";
+        return result;
+    }
     
     return result;
 }
@@ -326,7 +446,22 @@ std::vector<std::string> CLIParser::getValidFlags()
         "--h",
         "--samples",
         "--refl-spp",
+        "--threads",
+        "--tile-size",
+        "--tile-order",
+        "--integrator",
+        "--max-bounces",
+        "--light-sampling",
+        "--light-samples",
+        "--no-bvh-cache",
+        "--bvh-builder",
+        "--gbuffer-cache",
         "--denoise",
+        "--spp",
+        "--time-budget",
+        "--noise-threshold",
+        "--adaptive",
+        "--sample-density",
         "--raytrace",
         "--strict-schema",
         "--schema-version",
@@ -1,5 +1,5 @@
 // Machine Summary Block
-// {"file":"engine/core/application/cli_parser.h","purpose":"Declares CLI parsing utilities and logging helpers for the legacy application path.","exports":["CLIExitCode","LogLevel","CLIOptions","CLIParser","Logger"],"depends_on":["render_settings.h","<string>","<vector>"],"notes":["legacy_cli_parser","exit_code_contract","logging_utilities"]}
+// {"file":"engine/core/application/cli_parser.h","purpose":"Declares CLI parsing utilities and logging helpers for the legacy application path.","exports":["CLIExitCode","LogLevel","CLIOptions","CLIParser","Logger"],"depends_on":["render_settings.h","tile_scheduler.h","path_integrator.h","light_sampler.h","bvh_builder.h","<string>","<vector>"],"notes":["legacy_cli_parser","exit_code_contract","logging_utilities"]}
 // Human Summary
 // Provides option parsing and logging infrastructure used by the legacy command-line entry point.
 
@@ -10,6 +10,10 @@
 #include <map>
 #include <memory>
 #include "render_settings.h"
+#include "tile_scheduler.h"
+#include "path_integrator.h"
+#include "light_sampler.h"
+#include "bvh_builder.h"
 
 enum class CLIExitCode : int {
     Success = 0,
@@ -35,6 +39,8 @@ struct CLIOptions {
     bool enableDenoise = false;
     bool forceRaytrace = false;
     bool strictSchema = false;
+    bool bvhCache = true;            // Reuse raytracer mesh BVHs from the user cache directory
+    bool gbufferCache = false;       // Keep raytracer camera hits between renders for relighting
     
     std::string opsFile;
     std::string outputFile;
@@ -45,6 +51,10 @@ struct CLIOptions {
     int outputWidth = 1024;
     int outputHeight = 1024;
     int reflectionSpp = 8; // Default reflection samples per pixel
+    TileSchedulerSettings tileScheduler; // Raytracer tiling and thread count
+    PathTracerSettings pathTracer;       // Raytracer integrator and bounce limit
+    LightSamplingSettings lightSampling; // Raytracer light selection for many-light scenes
+    BVHBuildAlgorithm bvhBuilder = BVHBuildAlgorithm::BinnedSAH; // Raytracer mesh BVH builder
     
     // Render settings
     RenderSettings renderSettings;
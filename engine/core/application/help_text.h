@@ -45,7 +45,22 @@ static inline void print_cli_help()
     std::printf("  --h <int>             Output image height (default 1024)\n");
     std::printf("  --samples <int>       MSAA sample count for rendering (1 = off)\n");
     std::printf("  --refl-spp <int>      Reflection samples per pixel for glossy reflections (default 8)\n");
+    std::printf("  --threads <int>       Raytracer render threads (default 0 = all cores)\n");
+    std::printf("  --tile-size <int>     Raytracer tile edge in pixels (default 32)\n");
+    std::printf("  --tile-order <order>  Tile order: scanline, morton, spiral (default morton)\n");
+    std::printf("  --integrator <name>   Raytracer integrator: whitted, path (default whitted)\n");
+    std::printf("  --max-bounces <int>   Path integrator bounce limit (default 8)\n");
+    std::printf("  --light-sampling <m>  Raytracer light selection: auto, all, power, tree (default auto)\n");
+    std::printf("  --light-samples <int> Lights sampled per shading point when not evaluating all (default 4)\n");
+    std::printf("  --no-bvh-cache        Always rebuild raytracer BVHs instead of reusing cached ones\n");
+    std::printf("  --bvh-builder <name>  Raytracer BVH builder: sah (final renders), lbvh (fast previews) (default sah)\n");
+    std::printf("  --gbuffer-cache       Reuse raytraced camera hits when only lights or materials change\n");
     std::printf("  --denoise             Enable denoiser if available\n");
+    std::printf("  --spp <int>           Raytracer samples per pixel to accumulate progressively (default 1)\n");
+    std::printf("  --time-budget <sec>   Stop progressive raytracing after this many seconds (default 0 = off)\n");
+    std::printf("  --noise-threshold <f> Stop once mean relative noise falls below this (default 0 = off)\n");
+    std::printf("  --adaptive <f>        Adaptive sampling: stop sampling pixels whose error is below f (e.g. 0.01)\n");
+    std::printf("  --sample-density <png> Write a heat map of raytraced samples per pixel\n");
     std::printf("  --raytrace            Force raytracing mode for rendering\n");
     std::printf("  --strict-schema       Validate operations against schema strictly\n");
     std::printf("  --schema-version <v>  Schema version to validate against (default v1.3)\n");
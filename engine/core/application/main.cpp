@@ -103,6 +103,12 @@ int main(int argc, char** argv)
         Logger::debug("Setting reflection samples per pixel to " + std::to_string(parseResult.options.reflectionSpp));
     }
     app->setReflectionSpp(parseResult.options.reflectionSpp);
+    app->setTileSchedulerSettings(parseResult.options.tileScheduler);
+    app->setPathTracerSettings(parseResult.options.pathTracer);
+    app->setLightSamplingSettings(parseResult.options.lightSampling);
+    app->setBVHCacheEnabled(parseResult.options.bvhCache);
+    app->setBVHBuildAlgorithm(parseResult.options.bvhBuilder);
+    app->setGBufferCacheEnabled(parseResult.options.gbufferCache);
     
     // Configure schema validation
     if (parseResult.options.strictSchema) {
@@ -24,6 +24,13 @@ struct RenderSettings {
 
     // Multisample anti-aliasing sample count (1 = off)
     int samples = 1;
+
+    // Progressive raytracing; passes stop at whichever limit is reached first
+    int raytraceSpp = 1;              // Samples per pixel to accumulate
+    float timeBudgetSeconds = 0.0f;   // Wall-clock budget (0 = unlimited)
+    float noiseThreshold = 0.0f;      // Mean relative standard error to stop at (0 = disabled)
+    float adaptiveThreshold = 0.0f;   // Per-pixel error at which adaptive sampling stops a pixel (0 = off)
+    std::string sampleDensityPath;    // Optional PNG heat map of raytraced samples per pixel
     
     // Helper functions
     static ToneMappingMode parseToneMapping(const std::string& str);
@@ -168,7 +168,8 @@ std::string SchemaValidator::getEmbeddedSchemaV1_3() {
         "position": { "$ref": "#/definitions/vec3" },
         "direction": { "$ref": "#/definitions/vec3" },
         "color": { "$ref": "#/definitions/vec3" },
-        "intensity": { "type": "number" }
+        "intensity": { "type": "number" },
+        "range": { "type": "number", "minimum": 0 }
       },
       "additionalProperties": false,
       "anyOf": [
@@ -370,7 +371,24 @@ std::string SchemaValidator::getEmbeddedSchemaV1_3() {
         "op": { "const": "render_image" },
         "path": { "type": "string" },
         "width": { "type": "integer", "minimum": 1 },
-        "height": { "type": "integer", "minimum": 1 }
+        "height": { "type": "integer", "minimum": 1 },
+        "spp": { "type": "integer", "minimum": 1 },
+        "time_budget": { "type": "number", "minimum": 0 },
+        "noise_threshold": { "type": "number", "minimum": 0 },
+        "adaptive_threshold": { "type": "number", "minimum": 0 },
+        "sample_density": { "type": "string" },
+        "bvh_builder": { "type": "string", "enum": ["sah", "lbvh"] },
+        "aovs": {
+          "type": "object",
+          "properties": {
+            "albedo": { "type": "string" },
+            "normal": { "type": "string" },
+            "depth": { "type": "string" },
+            "object_id": { "type": "string" },
+            "material_id": { "type": "string" }
+          },
+          "additionalProperties": false
+        }
       },
       "additionalProperties": false
     },
@@ -0,0 +1,266 @@
+#include "denoiser_service.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef OIDN_ENABLED
+#include <OpenImageDenoise/oidn.hpp>
+#endif
+
+namespace {
+    // Enough for a preview size, an output size and their guided/unguided variants
+    constexpr size_t kMaxCachedFilters = 4;
+}
+
+#ifdef OIDN_ENABLED
+struct DenoiserService::DeviceState {
+    oidn::DeviceRef device;
+};
+
+// A committed filter bound to buffers it owns; requests are copied in, so the filter never
+// needs to be re-committed for new data
+struct DenoiserService::CachedFilter {
+    FilterKey key;
+    oidn::FilterRef filter;
+    std::vector<glm::vec3> color;
+    std::vector<glm::vec3> normal;
+    std::vector<glm::vec3> albedo;
+};
+#else
+struct DenoiserService::DeviceState {};
+struct DenoiserService::CachedFilter {
+    FilterKey key;
+};
+#endif
+
+DenoiserService::DenoiserService() = default;
+
+DenoiserService::~DenoiserService()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stop = true;
+        m_pending.reset();
+    }
+    m_queueCv.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+bool DenoiserService::available()
+{
+#ifdef OIDN_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool DenoiserService::denoise(std::vector<glm::vec3>& color, int width, int height,
+                              const std::vector<glm::vec3>* normal,
+                              const std::vector<glm::vec3>* albedo)
+{
+    std::lock_guard<std::mutex> lock(m_oidnMutex);
+    return execute(color, width, height, normal, albedo);
+}
+
+void DenoiserService::submit(DenoiseRequest&& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_worker.joinable()) {
+            m_worker = std::thread(&DenoiserService::workerLoop, this);
+        }
+        m_pending = std::make_unique<DenoiseRequest>(std::move(request));
+    }
+    m_queueCv.notify_one();
+}
+
+bool DenoiserService::poll(DenoiseResult& result)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (!m_finished) {
+        return false;
+    }
+    result = std::move(*m_finished);
+    m_finished.reset();
+    return true;
+}
+
+bool DenoiserService::wait(DenoiseResult& result)
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_idleCv.wait(lock, [this] { return !m_pending && !m_running; });
+    if (!m_finished) {
+        return false;
+    }
+    result = std::move(*m_finished);
+    m_finished.reset();
+    return true;
+}
+
+void DenoiserService::releaseFilters()
+{
+    std::lock_guard<std::mutex> lock(m_oidnMutex);
+    m_filters.clear();
+}
+
+void DenoiserService::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    while (true) {
+        m_queueCv.wait(lock, [this] { return m_stop || m_pending; });
+        if (m_stop) {
+            break;
+        }
+        std::unique_ptr<DenoiseRequest> request = std::move(m_pending);
+        m_running = true;
+        lock.unlock();
+
+        auto result = std::make_unique<DenoiseResult>();
+        result->width = request->width;
+        result->height = request->height;
+        result->frame = request->frame;
+        {
+            std::lock_guard<std::mutex> oidnLock(m_oidnMutex);
+            result->denoised = execute(request->color, request->width, request->height,
+                                       &request->normal, &request->albedo);
+        }
+        result->color = std::move(request->color);
+
+        lock.lock();
+        m_finished = std::move(result);
+        m_running = false;
+        m_idleCv.notify_all();
+    }
+    m_running = false;
+    m_idleCv.notify_all();
+}
+
+bool DenoiserService::ensureDevice()
+{
+#ifdef OIDN_ENABLED
+    if (m_device) {
+        return true;
+    }
+    auto state = std::make_unique<DeviceState>();
+    state->device = oidn::newDevice();
+    state->device.commit();
+    const char* errorMessage = nullptr;
+    if (state->device.getError(errorMessage) != oidn::Error::None) {
+        std::cerr << "[Denoiser] OIDN device error: " << (errorMessage ? errorMessage : "unknown") << "\n";
+        return false;
+    }
+    m_device = std::move(state);
+    std::cout << "[Denoiser] OIDN device created\n";
+    return true;
+#else
+    return false;
+#endif
+}
+
+DenoiserService::CachedFilter* DenoiserService::acquireFilter(const FilterKey& key)
+{
+    auto it = std::find_if(m_filters.begin(), m_filters.end(),
+                           [&key](const std::unique_ptr<CachedFilter>& f) { return f->key == key; });
+    if (it != m_filters.end()) {
+        // Move to the back so the least recently used filter is evicted first
+        std::rotate(it, it + 1, m_filters.end());
+        return m_filters.back().get();
+    }
+
+#ifdef OIDN_ENABLED
+    auto entry = std::make_unique<CachedFilter>();
+    entry->key = key;
+    const size_t pixelCount = static_cast<size_t>(key.width) * key.height;
+    entry->color.resize(pixelCount);
+    entry->filter = m_device->device.newFilter("RT");
+    entry->filter.setImage("color", entry->color.data(), oidn::Format::Float3, key.width, key.height);
+    if (key.normal) {
+        entry->normal.resize(pixelCount);
+        entry->filter.setImage("normal", entry->normal.data(), oidn::Format::Float3, key.width, key.height);
+    }
+    if (key.albedo) {
+        entry->albedo.resize(pixelCount);
+        entry->filter.setImage("albedo", entry->albedo.data(), oidn::Format::Float3, key.width, key.height);
+    }
+    // Denoise in place
+    entry->filter.setImage("output", entry->color.data(), oidn::Format::Float3, key.width, key.height);
+    entry->filter.set("hdr", true);     // Raytraced output is linear HDR
+    entry->filter.set("srgb", false);
+    entry->filter.commit();
+
+    const char* errorMessage = nullptr;
+    if (m_device->device.getError(errorMessage) != oidn::Error::None) {
+        std::cerr << "[Denoiser] OIDN filter setup error: " << (errorMessage ? errorMessage : "unknown") << "\n";
+        return nullptr;
+    }
+    std::cout << "[Denoiser] Created RT filter for " << key.width << "x" << key.height
+              << (key.albedo ? " +albedo" : "") << (key.normal ? " +normal" : "") << "\n";
+
+    if (m_filters.size() >= kMaxCachedFilters) {
+        m_filters.erase(m_filters.begin());
+    }
+    m_filters.push_back(std::move(entry));
+    return m_filters.back().get();
+#else
+    return nullptr;
+#endif
+}
+
+bool DenoiserService::execute(std::vector<glm::vec3>& color, int width, int height,
+                              const std::vector<glm::vec3>* normal, const std::vector<glm::vec3>* albedo)
+{
+#ifdef OIDN_ENABLED
+    try {
+        if (color.empty() || width <= 0 || height <= 0) {
+            std::cerr << "[Denoiser] Empty color buffer or invalid dimensions " << width << "x" << height << "\n";
+            return false;
+        }
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        if (color.size() != pixelCount) {
+            std::cerr << "[Denoiser] Buffer size " << color.size()
+                      << " doesn't match dimensions " << width << "x" << height << "\n";
+            return false;
+        }
+        if (!ensureDevice()) {
+            return false;
+        }
+
+        // OIDN requires albedo whenever a normal guide is given
+        FilterKey key;
+        key.width = width;
+        key.height = height;
+        key.albedo = albedo && albedo->size() == pixelCount;
+        key.normal = key.albedo && normal && normal->size() == pixelCount;
+
+        CachedFilter* entry = acquireFilter(key);
+        if (!entry) {
+            return false;
+        }
+
+        const size_t bytes = pixelCount * sizeof(glm::vec3);
+        std::memcpy(entry->color.data(), color.data(), bytes);
+        if (key.albedo) std::memcpy(entry->albedo.data(), albedo->data(), bytes);
+        if (key.normal) std::memcpy(entry->normal.data(), normal->data(), bytes);
+
+        entry->filter.execute();
+
+        const char* errorMessage = nullptr;
+        if (m_device->device.getError(errorMessage) != oidn::Error::None) {
+            std::cerr << "[Denoiser] OIDN execution error: " << (errorMessage ? errorMessage : "unknown") << "\n";
+            return false;
+        }
+        std::memcpy(color.data(), entry->color.data(), bytes);
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[Denoiser] Exception: " << e.what() << "\n";
+        return false;
+    }
+#else
+    (void)color; (void)width; (void)height; (void)normal; (void)albedo;
+    return false;
+#endif
+}
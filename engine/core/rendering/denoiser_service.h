@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One image to denoise. Guide images are optional and used only when their size matches color.
+struct DenoiseRequest {
+    std::vector<glm::vec3> color;
+    std::vector<glm::vec3> normal;
+    std::vector<glm::vec3> albedo;
+    int width = 0;
+    int height = 0;
+    uint64_t frame = 0;     // Caller-defined tag, returned with the result
+};
+
+struct DenoiseResult {
+    std::vector<glm::vec3> color;   // Denoised image, or the input unchanged when denoising failed
+    int width = 0;
+    int height = 0;
+    uint64_t frame = 0;
+    bool denoised = false;
+};
+
+// Owns one OIDN device for the lifetime of the renderer and keeps a committed "RT" filter per
+// resolution and guide configuration, so repeated renders only pay for filter execution.
+// Requests can run synchronously or on a worker thread while the caller traces the next frame.
+class DenoiserService {
+public:
+    DenoiserService();
+    ~DenoiserService();
+
+    DenoiserService(const DenoiserService&) = delete;
+    DenoiserService& operator=(const DenoiserService&) = delete;
+
+    // False when the build has no Intel Open Image Denoise support
+    static bool available();
+
+    // Denoises color in place on the calling thread
+    bool denoise(std::vector<glm::vec3>& color, int width, int height,
+                 const std::vector<glm::vec3>* normal = nullptr,
+                 const std::vector<glm::vec3>* albedo = nullptr);
+
+    // Queues a request for the worker thread. A request still waiting from an earlier submit is
+    // dropped: only the newest frame is worth denoising.
+    void submit(DenoiseRequest&& request);
+
+    // Takes the newest finished result without blocking; false when none is ready
+    bool poll(DenoiseResult& result);
+
+    // Blocks until every submitted request has finished, then takes the newest result
+    bool wait(DenoiseResult& result);
+
+    // Drops cached filters and their buffers; the device is kept
+    void releaseFilters();
+
+private:
+    struct FilterKey {
+        int width = 0;
+        int height = 0;
+        bool normal = false;
+        bool albedo = false;
+        bool operator==(const FilterKey& o) const {
+            return width == o.width && height == o.height && normal == o.normal && albedo == o.albedo;
+        }
+    };
+    struct CachedFilter;
+
+    bool execute(std::vector<glm::vec3>& color, int width, int height,
+                 const std::vector<glm::vec3>* normal, const std::vector<glm::vec3>* albedo);
+    bool ensureDevice();
+    CachedFilter* acquireFilter(const FilterKey& key);
+    void workerLoop();
+
+    // Device and filters; held while a filter executes
+    std::mutex m_oidnMutex;
+    struct DeviceState;
+    std::unique_ptr<DeviceState> m_device;
+    std::vector<std::unique_ptr<CachedFilter>> m_filters;   // Most recently used last
+
+    // Worker queue
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCv;
+    std::condition_variable m_idleCv;
+    std::thread m_worker;
+    std::unique_ptr<DenoiseRequest> m_pending;
+    std::unique_ptr<DenoiseResult> m_finished;
+    bool m_running = false;     // Worker is executing a request
+    bool m_stop = false;
+};
@@ -0,0 +1,347 @@
+#include "light_clusters.h"
+#include "light.h"
+#include "shader.h"
+#include "uniform_buffers.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace {
+    // Below this many ranged lights the binning is cheaper than waking the workers
+    constexpr size_t kParallelLightThreshold = 64;
+
+    bool sphereIntersectsBox(const glm::vec3& center, float radius, const glm::vec3& boxMin, const glm::vec3& boxMax)
+    {
+        const glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
+        const glm::vec3 d = center - closest;
+        return glm::dot(d, d) <= radius * radius;
+    }
+}
+
+LightClusters::LightClusters() = default;
+
+LightClusters::~LightClusters()
+{
+    cleanup();
+}
+
+void LightClusters::init(const LightClusterConfig& config)
+{
+    cleanup();
+    m_config = config;
+    m_config.tilesX = std::max(1, m_config.tilesX);
+    m_config.tilesY = std::max(1, m_config.tilesY);
+    m_config.slicesZ = std::max(1, m_config.slicesZ);
+    m_boundsProjection = glm::mat4(0.0f);
+    m_clusterMin.clear();
+    m_clusterMax.clear();
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    m_maxTexels = static_cast<size_t>(std::max(maxTexels, 65536));  // GL 3.3 guarantees 64K
+    m_overflowReported = false;
+
+    m_lightBuffer.init(GL_RGBA32F);
+    m_rangeBuffer.init(GL_RG32UI);
+    m_indexBuffer.init(GL_R32UI);
+}
+
+void LightClusters::cleanup()
+{
+    m_lightBuffer.cleanup();
+    m_rangeBuffer.cleanup();
+    m_indexBuffer.cleanup();
+}
+
+void LightClusters::updateClusterBounds(const glm::mat4& projection)
+{
+    m_boundsProjection = projection;
+
+    // Recover the clip planes of a standard perspective matrix (glm::perspective)
+    const float a = projection[2][2];
+    const float b = projection[3][2];
+    m_near = b / (a - 1.0f);
+    m_far = b / (a + 1.0f);
+    if (!(m_near > 0.0f) || !(m_far > m_near)) {
+        m_near = 0.1f;
+        m_far = 100.0f;
+    }
+
+    const int tilesX = m_config.tilesX;
+    const int tilesY = m_config.tilesY;
+    const int slicesZ = m_config.slicesZ;
+    const float logRatio = std::log(m_far / m_near);
+    m_depthScale = static_cast<float>(slicesZ) / logRatio;
+    m_depthBias = -static_cast<float>(slicesZ) * std::log(m_near) / logRatio;
+
+    // View-space ray through every tile corner, scaled to unit depth
+    const glm::mat4 inverseProjection = glm::inverse(projection);
+    std::vector<glm::vec3> cornerRays(static_cast<size_t>((tilesX + 1) * (tilesY + 1)));
+    for (int y = 0; y <= tilesY; ++y) {
+        for (int x = 0; x <= tilesX; ++x) {
+            const glm::vec2 ndc(2.0f * x / tilesX - 1.0f, 2.0f * y / tilesY - 1.0f);
+            glm::vec4 p = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+            const glm::vec3 onNear = glm::vec3(p) / p.w;
+            cornerRays[static_cast<size_t>(y * (tilesX + 1) + x)] = onNear / -onNear.z;
+        }
+    }
+
+    const size_t clusterCount = static_cast<size_t>(tilesX * tilesY * slicesZ);
+    m_clusterMin.assign(clusterCount, glm::vec3(0.0f));
+    m_clusterMax.assign(clusterCount, glm::vec3(0.0f));
+    for (int z = 0; z < slicesZ; ++z) {
+        const float depth0 = m_near * std::pow(m_far / m_near, static_cast<float>(z) / slicesZ);
+        const float depth1 = m_near * std::pow(m_far / m_near, static_cast<float>(z + 1) / slicesZ);
+        for (int y = 0; y < tilesY; ++y) {
+            for (int x = 0; x < tilesX; ++x) {
+                glm::vec3 lo(std::numeric_limits<float>::max());
+                glm::vec3 hi(-std::numeric_limits<float>::max());
+                for (int corner = 0; corner < 4; ++corner) {
+                    const glm::vec3& ray = cornerRays[static_cast<size_t>((y + (corner >> 1)) * (tilesX + 1) + x + (corner & 1))];
+                    lo = glm::min(lo, glm::min(ray * depth0, ray * depth1));
+                    hi = glm::max(hi, glm::max(ray * depth0, ray * depth1));
+                }
+                const size_t cluster = static_cast<size_t>((z * tilesY + y) * tilesX + x);
+                m_clusterMin[cluster] = lo;
+                m_clusterMax[cluster] = hi;
+            }
+        }
+    }
+}
+
+int LightClusters::sliceForDepth(float depth) const
+{
+    const int slice = static_cast<int>(std::floor(std::log(depth) * m_depthScale + m_depthBias));
+    return std::clamp(slice, 0, m_config.slicesZ - 1);
+}
+
+void LightClusters::build(const Light& lights, const glm::mat4& view, const glm::mat4& projection)
+{
+    if (projection != m_boundsProjection || m_clusterMin.empty())
+        updateClusterBounds(projection);
+
+    const int tilesX = m_config.tilesX;
+    const int tilesY = m_config.tilesY;
+    const std::vector<LightSource>& sources = lights.m_lights;
+
+    m_lightCount = static_cast<uint32_t>(sources.size());
+    m_lightData.resize(sources.size() * kLightTexels);
+    m_indices.clear();
+    m_bounded.clear();
+    for (uint32_t i = 0; i < sources.size(); ++i) {
+        const LightSource& src = sources[i];
+        glm::vec4* texels = &m_lightData[static_cast<size_t>(i) * kLightTexels];
+        const bool lit = src.enabled && src.intensity > 0.0f;
+        texels[0] = glm::vec4(src.position, lit ? src.intensity : 0.0f);
+        texels[1] = glm::vec4(src.color, std::max(0.0f, src.range));
+        texels[2] = glm::vec4(src.direction, static_cast<float>(src.type));
+        texels[3] = glm::vec4(std::cos(glm::radians(src.innerConeDeg)), std::cos(glm::radians(src.outerConeDeg)), 0.0f, 0.0f);
+        if (!lit)
+            continue;
+        if (src.type == LightType::DIRECTIONAL || !(src.range > 0.0f)) {
+            m_indices.push_back(i);
+            continue;
+        }
+
+        // Depth interval of the range sphere inside the clip planes
+        BoundedLight light;
+        light.center = glm::vec3(view * glm::vec4(src.position, 1.0f));
+        light.radius = src.range;
+        light.index = i;
+        const float depthNear = std::max(-light.center.z - light.radius, m_near);
+        const float depthFar = std::min(-light.center.z + light.radius, m_far);
+        if (depthNear > depthFar)
+            continue;
+
+        // Screen bounds: the corners of the sphere's box, clipped to that interval, all lie in front of the camera
+        glm::vec2 lo(std::numeric_limits<float>::max());
+        glm::vec2 hi(-std::numeric_limits<float>::max());
+        for (int corner = 0; corner < 8; ++corner) {
+            const glm::vec4 p(light.center.x + ((corner & 1) ? light.radius : -light.radius),
+                              light.center.y + ((corner & 2) ? light.radius : -light.radius),
+                              (corner & 4) ? -depthFar : -depthNear, 1.0f);
+            const glm::vec4 clip = projection * p;
+            const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+            lo = glm::min(lo, ndc);
+            hi = glm::max(hi, ndc);
+        }
+        if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f)
+            continue;
+        auto tile = [](float ndc, int tiles) {
+            const float t = (std::clamp(ndc, -1.0f, 1.0f) * 0.5f + 0.5f) * static_cast<float>(tiles);
+            return std::clamp(static_cast<int>(std::floor(t)), 0, tiles - 1);
+        };
+        light.x0 = tile(lo.x, tilesX);
+        light.x1 = tile(hi.x, tilesX);
+        light.y0 = tile(lo.y, tilesY);
+        light.y1 = tile(hi.y, tilesY);
+        light.z0 = sliceForDepth(depthNear);
+        light.z1 = sliceForDepth(depthFar);
+        m_bounded.push_back(light);
+    }
+    m_globalCount = static_cast<uint32_t>(m_indices.size());
+    m_visibleCount = static_cast<uint32_t>(m_bounded.size());
+
+    // Slices are binned independently into their own lists, so the result does not depend on threading
+    const int slicesZ = m_config.slicesZ;
+    m_ranges.assign(static_cast<size_t>(tilesX * tilesY * slicesZ) * 2, 0u);
+    m_sliceIndices.resize(static_cast<size_t>(slicesZ));
+    if (m_bounded.size() >= kParallelLightThreshold) {
+        if (!m_pool)
+            m_pool = std::make_unique<ThreadPool>(std::min(ThreadPool::defaultThreadCount(), 8u));
+        m_pool->parallelFor(static_cast<uint32_t>(slicesZ), [this](uint32_t slice, unsigned) {
+            binSlice(static_cast<int>(slice));
+        });
+    } else {
+        for (int z = 0; z < slicesZ; ++z)
+            binSlice(z);
+    }
+
+    // Concatenate the slice lists behind the global lights and make the cluster offsets absolute
+    const size_t slicePitch = static_cast<size_t>(tilesX * tilesY);
+    for (int z = 0; z < slicesZ; ++z) {
+        const uint32_t base = static_cast<uint32_t>(m_indices.size());
+        for (size_t c = 0; c < slicePitch; ++c)
+            m_ranges[(static_cast<size_t>(z) * slicePitch + c) * 2] += base;
+        const std::vector<uint32_t>& list = m_sliceIndices[static_cast<size_t>(z)];
+        m_indices.insert(m_indices.end(), list.begin(), list.end());
+    }
+}
+
+void LightClusters::binSlice(int slice)
+{
+    const int tilesX = m_config.tilesX;
+    const int tilesY = m_config.tilesY;
+    std::vector<uint32_t>& list = m_sliceIndices[static_cast<size_t>(slice)];
+    list.clear();
+
+    std::vector<const BoundedLight*> active;
+    for (const BoundedLight& light : m_bounded) {
+        if (slice >= light.z0 && slice <= light.z1)
+            active.push_back(&light);
+    }
+
+    for (int y = 0; y < tilesY; ++y) {
+        for (int x = 0; x < tilesX; ++x) {
+            const size_t cluster = static_cast<size_t>((slice * tilesY + y) * tilesX + x);
+            const uint32_t first = static_cast<uint32_t>(list.size());
+            for (const BoundedLight* light : active) {
+                if (x < light->x0 || x > light->x1 || y < light->y0 || y > light->y1)
+                    continue;
+                if (sphereIntersectsBox(light->center, light->radius, m_clusterMin[cluster], m_clusterMax[cluster]))
+                    list.push_back(light->index);
+            }
+            m_ranges[cluster * 2] = first;
+            m_ranges[cluster * 2 + 1] = static_cast<uint32_t>(list.size()) - first;
+        }
+    }
+}
+
+void LightClusters::upload()
+{
+    // Buffer textures cannot exceed GL_MAX_TEXTURE_BUFFER_SIZE texels; trim the lists rather than read past them
+    const size_t lightTexels = m_lightData.size();
+    const size_t maxLights = m_maxTexels / kLightTexels;
+    bool overflow = false;
+    if (m_lightCount > maxLights) {
+        m_lightCount = static_cast<uint32_t>(maxLights);
+        overflow = true;
+    }
+    if (m_indices.size() > m_maxTexels) {
+        const uint32_t limit = static_cast<uint32_t>(m_maxTexels);
+        m_indices.resize(m_maxTexels);
+        m_globalCount = std::min(m_globalCount, limit);
+        for (size_t c = 0; c < m_ranges.size(); c += 2) {
+            const uint32_t first = std::min(m_ranges[c], limit);
+            m_ranges[c] = first;
+            m_ranges[c + 1] = std::min(m_ranges[c + 1], limit - first);
+        }
+        overflow = true;
+    }
+    if (overflow && !m_overflowReported) {
+        std::cerr << "[LightClusters] Light lists exceed " << m_maxTexels
+                  << " buffer texels; some lights are dropped\n";
+        m_overflowReported = true;
+    }
+
+    m_lightBuffer.update(m_lightData.data(), std::min(lightTexels, static_cast<size_t>(m_lightCount) * kLightTexels) * sizeof(glm::vec4));
+    m_rangeBuffer.update(m_ranges.data(), m_ranges.size() * sizeof(uint32_t));
+    m_indexBuffer.update(m_indices.data(), m_indices.size() * sizeof(uint32_t));
+}
+
+void LightClusters::fillLightBlock(const Light& lights, LightBlock& out) const
+{
+    out = LightBlock();
+    out.globalAmbient = lights.m_globalAmbient;
+    out.clusterDepth = glm::vec4(m_depthScale, m_depthBias, 0.0f, 0.0f);
+    out.clusterDims = glm::ivec4(m_config.tilesX, m_config.tilesY, m_config.slicesZ, 0);
+    out.lightCounts = glm::ivec4(static_cast<int32_t>(m_lightCount), static_cast<int32_t>(m_globalCount), 0, 0);
+}
+
+void LightClusters::bind(const Shader& shader) const
+{
+    struct Binding { const char* sampler; GLuint unit; GLuint texture; };
+    const Binding bindings[] = {
+        {"lightData", kLightDataTextureUnit, m_lightBuffer.texture},
+        {"clusterRanges", kClusterRangeTextureUnit, m_rangeBuffer.texture},
+        {"clusterLights", kClusterLightTextureUnit, m_indexBuffer.texture},
+    };
+    for (const Binding& binding : bindings) {
+        glActiveTexture(GL_TEXTURE0 + binding.unit);
+        glBindTexture(GL_TEXTURE_BUFFER, binding.texture);
+        shader.setInt(binding.sampler, static_cast<int>(binding.unit));
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void LightClusters::BufferTexture::init(GLenum format)
+{
+    cleanup();
+    // Start with one 16-byte texel so the texture is complete before the first upload
+    capacity = 16;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::BufferTexture::update(const void* data, size_t size)
+{
+    if (!buffer)
+        return;
+    if (size == uploaded.size() && (size == 0 || std::memcmp(uploaded.data(), data, size) == 0))
+        return;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    if (size > capacity) {
+        // Grow geometrically; the texture keeps referring to the buffer object across reallocation
+        capacity = std::max(size, capacity * 2);
+        glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+    }
+    if (size > 0)
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uploaded.assign(bytes, bytes + size);
+}
+
+void LightClusters::BufferTexture::cleanup()
+{
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    capacity = 0;
+    uploaded.clear();
+}
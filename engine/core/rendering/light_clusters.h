@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gl_platform.h"
+
+class Light;
+class Shader;
+class ThreadPool;
+struct LightBlock;
+
+// Texture units of the light buffers; units 0-7 belong to material, IBL and shadow textures
+constexpr GLuint kLightDataTextureUnit = 8;
+constexpr GLuint kClusterRangeTextureUnit = 9;
+constexpr GLuint kClusterLightTextureUnit = 10;
+
+// RGBA32F texels per light in the light buffer:
+// (position, intensity) (color, range) (direction, type) (cos inner cone, cos outer cone, 0, 0)
+constexpr int kLightTexels = 4;
+
+// Cluster grid: screen tiles across x/y and exponentially spaced depth slices between the clip planes
+struct LightClusterConfig {
+    int tilesX = 16;
+    int tilesY = 9;
+    int slicesZ = 24;
+};
+
+// Clustered forward lighting: bins lights into view-frustum clusters on the CPU every frame and
+// exposes the per-cluster light lists to the scene shaders as buffer textures.
+// Lights without a range (and directional lights) reach everything; they head the index list and
+// every fragment evaluates them. Ranged point and spot lights are culled against each cluster's
+// view-space bounds with their range sphere, so a fragment only loops over its cluster's list.
+class LightClusters {
+public:
+    LightClusters();
+    ~LightClusters();
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    void init(const LightClusterConfig& config = LightClusterConfig());
+    void cleanup();
+
+    // Bin the lights for a perspective camera; needs no GL context
+    void build(const Light& lights, const glm::mat4& view, const glm::mat4& projection);
+    // Send the lists of the last build to the GPU; unchanged buffers are skipped
+    void upload();
+    // Ambient term, grid parameters and light counts for the shared light block
+    void fillLightBlock(const Light& lights, LightBlock& out) const;
+    // Bind the buffer textures and point the program's samplers at them
+    void bind(const Shader& shader) const;
+
+    const LightClusterConfig& config() const { return m_config; }
+    size_t clusterCount() const { return m_ranges.size() / 2; }
+    // Lights evaluated by every fragment, listed first in lightIndices()
+    uint32_t globalLightCount() const { return m_globalCount; }
+    // Ranged lights whose bounds reached the view frustum in the last build
+    uint32_t visibleLightCount() const { return m_visibleCount; }
+    const std::vector<glm::vec4>& lightData() const { return m_lightData; }
+    // (first, count) into lightIndices() per cluster, x fastest then y then depth slice
+    const std::vector<uint32_t>& clusterRanges() const { return m_ranges; }
+    const std::vector<uint32_t>& lightIndices() const { return m_indices; }
+
+private:
+    // A ranged light that reaches the view frustum, with the clusters its bounds cover
+    struct BoundedLight {
+        glm::vec3 center{0.0f};  // View space
+        float radius = 0.0f;
+        uint32_t index = 0;
+        int x0 = 0, x1 = -1, y0 = 0, y1 = -1, z0 = 0, z1 = -1;
+    };
+
+    // One GL buffer exposed to shaders through a buffer texture
+    struct BufferTexture {
+        GLuint buffer = 0;
+        GLuint texture = 0;
+        size_t capacity = 0;                  // Bytes allocated
+        std::vector<unsigned char> uploaded;  // Last contents sent, for the dirty check
+
+        void init(GLenum format);
+        void update(const void* data, size_t size);
+        void cleanup();
+    };
+
+    LightClusterConfig m_config;
+    // Inputs the cluster bounds were computed for
+    glm::mat4 m_boundsProjection{0.0f};
+    float m_near = 0.1f;
+    float m_far = 100.0f;
+    float m_depthScale = 0.0f;
+    float m_depthBias = 0.0f;
+    std::vector<glm::vec3> m_clusterMin;  // View-space bounds per cluster
+    std::vector<glm::vec3> m_clusterMax;
+
+    std::vector<glm::vec4> m_lightData;
+    std::vector<uint32_t> m_ranges;
+    std::vector<uint32_t> m_indices;
+    uint32_t m_lightCount = 0;   // Lights in m_lightData
+    uint32_t m_globalCount = 0;
+    uint32_t m_visibleCount = 0;
+
+    std::vector<BoundedLight> m_bounded;
+    std::vector<std::vector<uint32_t>> m_sliceIndices;  // Per-slice lists, merged after binning
+    std::unique_ptr<ThreadPool> m_pool;                 // Created once enough lights need binning
+
+    BufferTexture m_lightBuffer;
+    BufferTexture m_rangeBuffer;
+    BufferTexture m_indexBuffer;
+    size_t m_maxTexels = 0;  // GL_MAX_TEXTURE_BUFFER_SIZE
+    bool m_overflowReported = false;
+
+    void updateClusterBounds(const glm::mat4& projection);
+    int sliceForDepth(float depth) const;
+    void binSlice(int slice);
+};
@@ -7,8 +7,10 @@
 #include "skybox.h"
 #include "ibl_system.h"
 #include "raytracer.h"
+#include "denoiser_service.h"
 #include "shader.h"
 #include "resource_paths.h"
+#include "user_paths.h"
 #include "gl_platform.h"
 #include <iostream>
 #include <vector>
@@ -26,11 +28,20 @@
 #endif
 #include "stb_image_write.h"
 
-#ifdef OIDN_ENABLED
-#include <OpenImageDenoise/oidn.hpp>
-#endif
-
 namespace {
+    // Legacy reflection strength for the raytracer derived from material parameters
+    float raytraceReflectivity(const Material& material) {
+        // For metallic materials, use metallic value as reflectivity multiplier
+        if (material.metallic > 0.1f) {
+            return 0.3f + (material.metallic * 0.7f); // Range 0.3 to 1.0 based on metallic
+        }
+        // Legacy: high specular values also indicate reflective materials
+        if (material.specular.r > 0.8f || material.specular.g > 0.8f || material.specular.b > 0.8f) {
+            return 0.5f; // Higher reflectivity for shiny materials
+        }
+        return 0.1f; // Default reflectivity
+    }
+
     std::string resolveResourcePath(const std::string& path) {
         std::filesystem::path candidate(path);
         if (candidate.is_absolute()) {
@@ -46,6 +57,7 @@ RenderSystem::RenderSystem()
     m_axisRenderer = std::make_unique<AxisRenderer>();
     m_grid = std::make_unique<Grid>();
     m_raytracer = std::make_unique<Raytracer>();
+    m_denoiser = std::make_unique<DenoiserService>();
     m_gizmo = std::make_unique<Gizmo>();
     m_skybox = std::make_unique<Skybox>();
     m_iblSystem = std::make_unique<IBLSystem>();
@@ -77,6 +89,17 @@ bool RenderSystem::init(int windowWidth, int windowHeight)
     m_pbrShader = std::make_unique<Shader>();
     if (!m_pbrShader->load(shaderPath("shaders/pbr.vert"), shaderPath("shaders/pbr.frag")))
         std::cerr << "[RenderSystem] Failed to load PBR shader.\n";
+    m_basicUniforms.resolve(*m_basicShader);
+    m_pbrUniforms.resolve(*m_pbrShader);
+    m_sceneUniforms.init();
+    m_lightClusters.init();
+    // Sampler units are program state: point the light buffers at their own units up front, so draws
+    // that skip setupCommonUniforms (selection overlay) never leave a buffer sampler on a 2D unit
+    for (Shader* shader : {m_basicShader.get(), m_pbrShader.get()}) {
+        shader->use();
+        m_lightClusters.bind(*shader);
+    }
+    glUseProgram(0);
 
     m_gridShader = std::make_unique<Shader>();
     if (!m_gridShader->load(shaderPath("shaders/grid.vert"), shaderPath("shaders/grid.frag")))
@@ -137,10 +160,16 @@ void RenderSystem::shutdown()
     if (m_axisRenderer) { m_axisRenderer->cleanup(); }
     if (m_grid) { m_grid->cleanup(); }
     if (m_gizmo) { m_gizmo->cleanup(); }
+    detachRaytracerScene();
     m_raytracer.reset();
+    m_denoiser.reset();
+    m_lastDenoised.clear();
     m_basicShader.reset();
     m_pbrShader.reset();
     m_gridShader.reset();
+    m_sceneUniforms.cleanup();
+    m_lightClusters.cleanup();
+    m_renderTargets.clear();
     if (m_dummyShadowTex) { glDeleteTextures(1, &m_dummyShadowTex); m_dummyShadowTex = 0; }
     destroyTargets();
 }
@@ -208,7 +237,7 @@ void RenderSystem::render(const SceneManager& scene, const Light& lights)
     // Choose render path based on mode
     switch (m_renderMode) {
         case RenderMode::Raytrace:
-            renderRaytraced(scene, lights);
+            renderRaytraced(scene, lights, false);
             break;
         default:
             renderRasterized(scene, lights);
@@ -227,28 +256,16 @@ void RenderSystem::render(const SceneManager& scene, const Light& lights)
             if (obj.VAO != 0) {
                 Shader* s = m_basicShader.get();
                 s->use();
-                // Post-processing uniforms for standard shader (selection overlay respects gamma/exposure)
-                s->setFloat("exposure", m_exposure);
-                s->setFloat("gamma", m_gamma);
-                s->setInt("toneMappingMode", static_cast<int>(m_tonemap));
-                // Matrices
+                // Camera matrices come from the shared frame block
                 s->setMat4("model", obj.modelMatrix);
-                s->setMat4("view", m_viewMatrix);
-                s->setMat4("projection", m_projectionMatrix);
-                // Solid highlight color via ambient-only lighting
-                s->setInt("shadingMode", 0); // flat path
+                // Solid highlight color; unlit skips the lights in the shared light block
+                s->setBool("unlit", true);
                 s->setBool("useTexture", false);
                 s->setVec3("objectColor", glm::vec3(0.2f, 0.7f, 1.0f)); // cyan-ish
-                s->setVec3("viewPos", m_camera.position);
-                // Force bright ambient and no direct lights
                 glActiveTexture(GL_TEXTURE0 + 7);
                 glBindTexture(GL_TEXTURE_2D, m_dummyShadowTex);
                 s->setInt("shadowMap", 7);
                 s->setMat4("lightSpaceMatrix", glm::mat4(1.0f));
-                // Material ambient = 1, other params not used in flat ambient-only path
-                s->setVec3("material.ambient", glm::vec3(1.0f));
-                s->setInt("numLights", 0);
-                s->setVec4("globalAmbient", glm::vec4(1.0f));
 
                 // Draw as wireframe overlay with slight depth bias to reduce z-fighting
                 GLint prevPolyMode[2];
@@ -268,6 +285,7 @@ void RenderSystem::render(const SceneManager& scene, const Light& lights)
                 m_stats.drawCalls += 1;
                 glPolygonMode(GL_FRONT_AND_BACK, prevPolyMode[0]);
                 glDisable(GL_POLYGON_OFFSET_LINE);
+                s->setBool("unlit", false);
             }
         }
     }
@@ -344,6 +362,11 @@ bool RenderSystem::loadHDREnvironment(const std::string& hdrPath)
     if (!m_iblSystem) return false;
 
     const std::string resolved = resolveResourcePath(hdrPath);
+
+    // The raytracer lights with the same image, sampled on the CPU; rows bottom first like the GL upload
+    if (m_raytracer) {
+        m_raytracer->loadEnvironmentMap(resolved);
+    }
     
     if (m_iblSystem->loadHDREnvironment(resolved)) {
         m_bgHDRPath = resolved;
@@ -361,6 +384,9 @@ bool RenderSystem::loadHDREnvironment(const std::string& hdrPath)
 
 void RenderSystem::setIBLIntensity(float intensity)
 {
+    if (m_raytracer) {
+        m_raytracer->setEnvironmentIntensity(intensity);
+    }
     if (m_iblSystem) {
         m_iblSystem->setIntensity(intensity);
     }
@@ -377,134 +403,30 @@ bool RenderSystem::renderToTexture(const SceneManager& scene, const Light& light
     GLint prevViewport[4] = {0, 0, 0, 0};
     glGetIntegerv(GL_VIEWPORT, prevViewport);
 
-    // Use offscreen aspect ratio; restore later
-    glm::mat4 prevProj = m_projectionMatrix;
-    updateProjectionMatrix(width, height);
-
-    if (m_samples > 1) {
-        // MSAA path: render into multisampled RBOs and resolve into provided texture
-        GLuint fboMSAA = 0, rboColorMSAA = 0, rboDepthMSAA = 0;
-        GLuint fboResolve = 0;
-
-        glGenFramebuffers(1, &fboMSAA);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboMSAA);
-
-        glGenRenderbuffers(1, &rboColorMSAA);
-        glBindRenderbuffer(GL_RENDERBUFFER, rboColorMSAA);
-        glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_RGBA8, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rboColorMSAA);
-
-        glGenRenderbuffers(1, &rboDepthMSAA);
-        glBindRenderbuffer(GL_RENDERBUFFER, rboDepthMSAA);
-        glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_DEPTH24_STENCIL8, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboDepthMSAA);
-
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-            if (rboColorMSAA) glDeleteRenderbuffers(1, &rboColorMSAA);
-            if (rboDepthMSAA) glDeleteRenderbuffers(1, &rboDepthMSAA);
-            if (fboMSAA) glDeleteFramebuffers(1, &fboMSAA);
-            m_projectionMatrix = prevProj;
-            glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
-            return false;
-        }
-
-        // Render to MSAA framebuffer
-        glViewport(0, 0, width, height);
-        glClearColor(0.10f, 0.11f, 0.12f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        if (m_renderMode == RenderMode::Raytrace) {
-            renderRaytraced(scene, lights);
-        } else {
-            renderRasterized(scene, lights);
-        }
-
-        // Create resolve framebuffer with provided texture
-        glGenFramebuffers(1, &fboResolve);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboResolve);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-        const GLenum drawBufsR[1] = { GL_COLOR_ATTACHMENT0 };
-        glDrawBuffers(1, drawBufsR);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-            if (fboResolve) glDeleteFramebuffers(1, &fboResolve);
-            if (rboColorMSAA) glDeleteRenderbuffers(1, &rboColorMSAA);
-            if (rboDepthMSAA) glDeleteRenderbuffers(1, &rboDepthMSAA);
-            if (fboMSAA) glDeleteFramebuffers(1, &fboMSAA);
-            m_projectionMatrix = prevProj;
-            glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
-            return false;
-        }
-
-        // Resolve
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, fboMSAA);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboResolve);
-        glBlitFramebuffer(0, 0, width, height,
-                          0, 0, width, height,
-                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
-
-        // Cleanup and restore
-        glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-        if (fboResolve) glDeleteFramebuffers(1, &fboResolve);
-        if (rboColorMSAA) glDeleteRenderbuffers(1, &rboColorMSAA);
-        if (rboDepthMSAA) glDeleteRenderbuffers(1, &rboDepthMSAA);
-        if (fboMSAA) glDeleteFramebuffers(1, &fboMSAA);
-
-        m_projectionMatrix = prevProj;
-        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
-        return true;
-    } else {
-        // Single-sample path (previous behavior)
-        // Create FBO
-        GLuint fbo = 0;
-        glGenFramebuffers(1, &fbo);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-        // Attach provided color texture
+    // Pooled framebuffer around the provided texture; it needs its own depth only when rendering directly
+    RenderTargetDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colorFormat = 0;
+    desc.samples = 1;
+    desc.depth = m_samples <= 1;
+    RenderTarget* target = m_renderTargets.acquire(desc);
+
+    bool ok = false;
+    if (target) {
+        glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-        const GLenum drawBufs[1] = { GL_COLOR_ATTACHMENT0 };
-        glDrawBuffers(1, drawBufs);
-
-        // Create and attach depth (and stencil if available) renderbuffer
-        GLuint rboDepth = 0;
-        glGenRenderbuffers(1, &rboDepth);
-        glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
-
-        // Validate
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-            if (rboDepth) glDeleteRenderbuffers(1, &rboDepth);
-            if (fbo) glDeleteFramebuffers(1, &fbo);
-            m_projectionMatrix = prevProj;
-            glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
-            return false;
-        }
-
-        // Set viewport and clear
-        glViewport(0, 0, width, height);
-        glClearColor(0.10f, 0.11f, 0.12f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Render scene using current mode
-        if (m_renderMode == RenderMode::Raytrace) {
-            renderRaytraced(scene, lights);
-        } else {
-            renderRasterized(scene, lights);
-        }
-
-        // Restore projection, framebuffer and viewport
-        m_projectionMatrix = prevProj;
-        glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+        ok = renderOffscreen(scene, lights, target->fbo, width, height);
 
-        // Cleanup
-        glDeleteRenderbuffers(1, &rboDepth);
-        glDeleteFramebuffers(1, &fbo);
-        return true;
+        // Detach so the pooled framebuffer never refers to a texture the caller may delete
+        glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+        m_renderTargets.release(target);
     }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    return ok;
 }
 
 bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
@@ -518,37 +440,27 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
     GLint prevViewport[4] = {0, 0, 0, 0};
     glGetIntegerv(GL_VIEWPORT, prevViewport);
 
-    // Create color texture (RGBA8)
-    GLuint colorTex = 0;
-    glGenTextures(1, &colorTex);
-    glBindTexture(GL_TEXTURE_2D, colorTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // Render scene into the texture
-    bool ok = renderToTexture(scene, lights, colorTex, width, height);
-    if (!ok) {
-        glDeleteTextures(1, &colorTex);
+    // Pooled RGBA8 target that is rendered (or resolved) into and read back from
+    RenderTargetDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.colorFormat = GL_RGBA8;
+    desc.samples = 1;
+    desc.depth = m_samples <= 1;
+    RenderTarget* target = m_renderTargets.acquire(desc);
+    if (!target) {
+        glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
         return false;
     }
 
-    // Read back pixels from the texture via a temporary FBO
-    GLuint fbo = 0;
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    if (!renderOffscreen(scene, lights, target->fbo, width, height)) {
+        m_renderTargets.release(target);
         glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-        glDeleteFramebuffers(1, &fbo);
-        glDeleteTextures(1, &colorTex);
+        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
         return false;
     }
 
-    glViewport(0, 0, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
     glReadBuffer(GL_COLOR_ATTACHMENT0);
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
@@ -557,6 +469,11 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
     std::vector<std::uint8_t> pixels(height * rowStride);
     glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
 
+    // Restore previous framebuffer and viewport; the target goes back to the pool for the next render
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    m_renderTargets.release(target);
+
     // Flip vertically for conventional image orientation
     std::vector<std::uint8_t> flipped(height * rowStride);
     for (int y = 0; y < height; ++y) {
@@ -567,16 +484,55 @@ bool RenderSystem::renderToPNG(const SceneManager& scene, const Light& lights,
 
     // Write PNG
     int writeOK = stbi_write_png(path.c_str(), width, height, comp, flipped.data(), rowStride);
+    return writeOK != 0;
+}
 
-    // Restore previous framebuffer and viewport
-    glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
-    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+bool RenderSystem::renderOffscreen(const SceneManager& scene, const Light& lights,
+                                   GLuint targetFBO, int width, int height)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        return false;
 
-    // Cleanup
-    glDeleteFramebuffers(1, &fbo);
-    glDeleteTextures(1, &colorTex);
+    // With MSAA the scene is drawn into a pooled multisampled target and resolved into targetFBO
+    RenderTarget* msaa = nullptr;
+    if (m_samples > 1) {
+        RenderTargetDesc desc;
+        desc.width = width;
+        desc.height = height;
+        desc.colorFormat = GL_RGBA8;
+        desc.samples = m_samples;
+        msaa = m_renderTargets.acquire(desc);
+        if (!msaa) return false;
+        glBindFramebuffer(GL_FRAMEBUFFER, msaa->fbo);
+    }
 
-    return writeOK != 0;
+    // Use offscreen aspect ratio; restore later
+    glm::mat4 prevProj = m_projectionMatrix;
+    updateProjectionMatrix(width, height);
+
+    glViewport(0, 0, width, height);
+    glClearColor(0.10f, 0.11f, 0.12f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Render scene using current mode
+    if (m_renderMode == RenderMode::Raytrace) {
+        renderRaytraced(scene, lights);
+    } else {
+        renderRasterized(scene, lights);
+    }
+    m_projectionMatrix = prevProj;
+
+    if (msaa) {
+        // Resolve
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, msaa->fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, targetFBO);
+        glBlitFramebuffer(0, 0, width, height,
+                          0, 0, width, height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_renderTargets.release(msaa);
+    }
+    return true;
 }
 
 void RenderSystem::updateViewMatrix()
@@ -605,185 +561,73 @@ int RenderSystem::getReflectionSpp() const
     return m_reflectionSpp;
 }
 
-bool RenderSystem::denoise(std::vector<glm::vec3>& color,
-                          const std::vector<glm::vec3>* normal,
-                          const std::vector<glm::vec3>* albedo)
+void RenderSystem::setProgressiveSettings(const ProgressiveRenderSettings& settings)
 {
-#ifdef OIDN_ENABLED
-    try {
-        if (color.empty()) {
-            std::cerr << "[RenderSystem::denoise] Empty color buffer\n";
-            return false;
-        }
-
-        // Create OIDN device
-        oidn::DeviceRef device = oidn::newDevice();
-        device.commit();
-        
-        // Check for errors
-        const char* errorMessage;
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN device error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Try to guess square dimensions (common for raytracer)
-        int width = static_cast<int>(std::sqrt(color.size()));
-        int height = width;
-        
-        // Verify we have a proper square image
-        if (width * height != static_cast<int>(color.size())) {
-            std::cerr << "[RenderSystem::denoise] Cannot determine image dimensions from buffer size " 
-                      << color.size() << ". Use the overload with explicit width/height.\n";
-            return false;
-        }
+    m_progressiveSettings = settings;
+    if (m_raytracer) {
+        m_raytracer->setProgressiveSettings(m_progressiveSettings);
+    }
+}
 
-        // Create the filter for ray tracing denoising
-        oidn::FilterRef filter = device.newFilter("RT"); // Ray tracing filter
-        
-        // Set input images
-        filter.setImage("color", color.data(), oidn::Format::Float3, width, height);
-        
-        // Optional: Set auxiliary buffers if available
-        if (normal && normal->size() == color.size()) {
-            filter.setImage("normal", normal->data(), oidn::Format::Float3, width, height);
-        }
-        
-        if (albedo && albedo->size() == color.size()) {
-            filter.setImage("albedo", albedo->data(), oidn::Format::Float3, width, height);
-        }
-        
-        // Set output image (in-place denoising)
-        filter.setImage("output", color.data(), oidn::Format::Float3, width, height);
-        
-        // Set filter quality (optional - can be "fast", "balanced", "high")
-        filter.set("hdr", true); // Enable HDR processing for better quality
-        filter.set("srgb", false); // We're working in linear space
-        
-        // Commit the filter
-        filter.commit();
-        
-        // Check for errors
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN filter setup error: " << errorMessage << "\n";
-            return false;
-        }
+void RenderSystem::setTileSchedulerSettings(const TileSchedulerSettings& settings)
+{
+    m_tileSchedulerSettings = settings;
+    if (m_raytracer) {
+        m_raytracer->setTileSchedulerSettings(m_tileSchedulerSettings);
+    }
+}
 
-        // Execute the filter
-        filter.execute();
-        
-        // Check for errors after execution
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN execution error: " << errorMessage << "\n";
-            return false;
-        }
+void RenderSystem::setPathTracerSettings(const PathTracerSettings& settings)
+{
+    m_pathTracerSettings = settings;
+    if (m_raytracer) {
+        m_raytracer->setPathTracerSettings(m_pathTracerSettings);
+    }
+}
 
-        std::cout << "[RenderSystem::denoise] Successfully denoised " 
-                  << width << "x" << height << " image\n";
-        return true;
+void RenderSystem::setLightSamplingSettings(const LightSamplingSettings& settings)
+{
+    m_lightSamplingSettings = settings;
+    if (m_raytracer) {
+        m_raytracer->setLightSamplingSettings(m_lightSamplingSettings);
     }
-    catch (const std::exception& e) {
-        std::cerr << "[RenderSystem::denoise] Exception: " << e.what() << "\n";
+}
+
+bool RenderSystem::denoise(std::vector<glm::vec3>& color,
+                          const std::vector<glm::vec3>* normal,
+                          const std::vector<glm::vec3>* albedo)
+{
+    // Try to guess square dimensions (common for raytracer)
+    int width = static_cast<int>(std::sqrt(color.size()));
+    if (static_cast<size_t>(width) * width != color.size()) {
+        std::cerr << "[RenderSystem::denoise] Cannot determine image dimensions from buffer size " 
+                  << color.size() << ". Use the overload with explicit width/height.\n";
         return false;
     }
-#else
-    // Fallback for builds without OIDN - just return false to indicate no denoising was done
-    std::cout << "[RenderSystem::denoise] Intel Open Image Denoise not available in this build\n";
-    return false;
-#endif
+    return denoise(color, width, width, normal, albedo);
 }
 
 bool RenderSystem::denoise(std::vector<glm::vec3>& color, int width, int height,
                           const std::vector<glm::vec3>* normal,
                           const std::vector<glm::vec3>* albedo)
 {
-#ifdef OIDN_ENABLED
-    try {
-        if (color.empty()) {
-            std::cerr << "[RenderSystem::denoise] Empty color buffer\n";
-            return false;
-        }
-        
-        if (width <= 0 || height <= 0) {
-            std::cerr << "[RenderSystem::denoise] Invalid dimensions: " << width << "x" << height << "\n";
-            return false;
-        }
-
-        // Verify buffer size matches dimensions
-        if (static_cast<int>(color.size()) != width * height) {
-            std::cerr << "[RenderSystem::denoise] Buffer size " << color.size() 
-                      << " doesn't match dimensions " << width << "x" << height << "\n";
-            return false;
-        }
-
-        // Create OIDN device
-        oidn::DeviceRef device = oidn::newDevice();
-        device.commit();
-        
-        // Check for errors
-        const char* errorMessage;
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN device error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Create the filter for ray tracing denoising
-        oidn::FilterRef filter = device.newFilter("RT"); // Ray tracing filter
-        
-        // Set input images
-        filter.setImage("color", color.data(), oidn::Format::Float3, width, height);
-        
-        // Optional: Set auxiliary buffers if available
-        if (normal && static_cast<int>(normal->size()) == width * height) {
-            filter.setImage("normal", normal->data(), oidn::Format::Float3, width, height);
-        }
-        
-        if (albedo && static_cast<int>(albedo->size()) == width * height) {
-            filter.setImage("albedo", albedo->data(), oidn::Format::Float3, width, height);
-        }
-        
-        // Set output image (in-place denoising)
-        filter.setImage("output", color.data(), oidn::Format::Float3, width, height);
-        
-        // Set filter quality
-        filter.set("hdr", true); // Enable HDR processing for better quality
-        filter.set("srgb", false); // We're working in linear space
-        
-        // Commit the filter
-        filter.commit();
-        
-        // Check for errors
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN filter setup error: " << errorMessage << "\n";
-            return false;
-        }
-
-        // Execute the filter
-        filter.execute();
-        
-        // Check for errors after execution
-        if (device.getError(errorMessage) != oidn::Error::None) {
-            std::cerr << "[RenderSystem::denoise] OIDN execution error: " << errorMessage << "\n";
-            return false;
-        }
-
-        std::cout << "[RenderSystem::denoise] Successfully denoised " 
-                  << width << "x" << height << " image with explicit dimensions\n";
-        return true;
+    if (!DenoiserService::available()) {
+        // Fallback for builds without OIDN - just return false to indicate no denoising was done
+        std::cout << "[RenderSystem::denoise] Intel Open Image Denoise not available in this build\n";
+        return false;
     }
-    catch (const std::exception& e) {
-        std::cerr << "[RenderSystem::denoise] Exception: " << e.what() << "\n";
+    if (!m_denoiser->denoise(color, width, height, normal, albedo)) {
         return false;
     }
-#else
-    // Fallback for builds without OIDN
-    std::cout << "[RenderSystem::denoise] Intel Open Image Denoise not available in this build (explicit dimensions version)\n";
-    return false;
-#endif
+    std::cout << "[RenderSystem::denoise] Successfully denoised " 
+              << width << "x" << height << " image\n";
+    return true;
 }
 
 void RenderSystem::renderRasterized(const SceneManager& scene, const Light& lights)
 {
+    uploadSceneUniforms(lights);
+
     // Render skybox first as background
     if (m_showSkybox && m_skybox) {
         m_skybox->render(m_viewMatrix, m_projectionMatrix);
@@ -791,10 +635,98 @@ void RenderSystem::renderRasterized(const SceneManager& scene, const Light& ligh
     }
     
     // Optimized object rendering with batching by material/shader
-    renderObjectsBatched(scene, lights);
+    renderObjectsBatched(scene);
+}
+
+void RenderSystem::syncRaytracerScene(const SceneManager& scene)
+{
+    if (m_raytraceScene != &scene) {
+        detachRaytracerScene();
+        m_raytraceScene = &scene;
+        m_raytraceSceneListener = scene.addChangeListener([this](const SceneChangeEvent& event) {
+            if (event.type == SceneChangeType::SceneCleared) {
+                m_raytraceSceneReload = true;
+                m_pendingSceneChanges.clear();
+            } else if (!m_raytraceSceneReload) {
+                m_pendingSceneChanges.push_back(event);
+            }
+        });
+        m_raytraceSceneReload = true;
+    }
+
+    auto addInstance = [&](const SceneObject& obj) {
+        if (obj.objLoader.getVertCount() == 0) return; // Skip objects with no geometry
+        m_raytraceInstances[obj.id] = m_raytracer->loadModel(obj.objLoader, obj.modelMatrix,
+                                                             raytraceReflectivity(obj.material), obj.material);
+    };
+
+    if (m_raytraceSceneReload) {
+        m_raytracer->clearScene();
+        m_raytraceInstances.clear();
+        m_pendingSceneChanges.clear();
+        m_raytraceSceneReload = false;
+
+        const auto& objects = scene.getObjects();
+        std::cout << "[RenderSystem] Loading " << objects.size() << " objects into raytracer\n";
+        for (const auto& obj : objects) {
+            addInstance(obj);
+        }
+        return;
+    }
+
+    if (m_pendingSceneChanges.empty()) {
+        return;
+    }
+
+    // Events only carry ids; current object state is read here, so repeated edits collapse
+    size_t applied = 0;
+    for (const SceneChangeEvent& event : m_pendingSceneChanges) {
+        const SceneObject* obj = scene.findObjectById(event.objectId);
+        auto it = m_raytraceInstances.find(event.objectId);
+        switch (event.type) {
+            case SceneChangeType::ObjectAdded:
+                if (obj && it == m_raytraceInstances.end()) { addInstance(*obj); ++applied; }
+                break;
+            case SceneChangeType::ObjectRemoved:
+                if (it != m_raytraceInstances.end()) {
+                    m_raytracer->removeInstance(it->second);
+                    m_raytraceInstances.erase(it);
+                    ++applied;
+                }
+                break;
+            case SceneChangeType::TransformChanged:
+                if (obj && it != m_raytraceInstances.end()) {
+                    m_raytracer->setInstanceTransform(it->second, obj->modelMatrix);
+                    ++applied;
+                }
+                break;
+            case SceneChangeType::MaterialChanged:
+                if (obj && it != m_raytraceInstances.end()) {
+                    m_raytracer->setInstanceMaterial(it->second, raytraceReflectivity(obj->material), obj->material);
+                    ++applied;
+                }
+                break;
+            case SceneChangeType::SceneCleared:
+                break;
+        }
+    }
+    m_pendingSceneChanges.clear();
+    std::cout << "[RenderSystem] Applied " << applied << " scene changes to raytracer\n";
 }
 
-void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& lights)
+void RenderSystem::detachRaytracerScene()
+{
+    if (m_raytraceScene && m_raytraceSceneListener) {
+        m_raytraceScene->removeChangeListener(m_raytraceSceneListener);
+    }
+    m_raytraceScene = nullptr;
+    m_raytraceSceneListener = 0;
+    m_raytraceSceneReload = true;
+    m_raytraceInstances.clear();
+    m_pendingSceneChanges.clear();
+}
+
+void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& lights, bool waitForDenoise)
 {
     if (!m_raytracer) {
         std::cerr << "[RenderSystem] Raytracer not initialized\n";
@@ -811,35 +743,26 @@ void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& light
     if (!m_raytraceTexture)
         initRaytraceTexture();
 
-    // Clear existing raytracer data and load all scene objects
-    m_raytracer = std::make_unique<Raytracer>();
-    
     // Set the seed for deterministic rendering
     m_raytracer->setSeed(m_seed);
     
     // Set reflection samples per pixel for glossy reflections
     m_raytracer->setReflectionSpp(m_reflectionSpp);
-    
-    const auto& objects = scene.getObjects();
-    std::cout << "[RenderSystem] Loading " << objects.size() << " objects into raytracer\n";
-    
-    for (const auto& obj : objects) {
-        if (obj.objLoader.getVertCount() == 0) continue; // Skip objects with no geometry
-        
-        // Load object into raytracer with its transform and material
-        float reflectivity = 0.1f; // Default reflectivity
-        
-        // For metallic materials, use metallic value as reflectivity multiplier
-        if (obj.material.metallic > 0.1f) {
-            reflectivity = 0.3f + (obj.material.metallic * 0.7f); // Range 0.3 to 1.0 based on metallic
-        }
-        // Legacy: high specular values also indicate reflective materials
-        else if (obj.material.specular.r > 0.8f || obj.material.specular.g > 0.8f || obj.material.specular.b > 0.8f) {
-            reflectivity = 0.5f; // Higher reflectivity for shiny materials
-        }
-        
-        m_raytracer->loadModel(obj.objLoader, obj.modelMatrix, reflectivity, obj.material);
-    }
+    m_raytracer->setTileSchedulerSettings(m_tileSchedulerSettings);
+    m_raytracer->setProgressiveSettings(m_progressiveSettings);
+    m_raytracer->setPathTracerSettings(m_pathTracerSettings);
+    m_raytracer->setLightSamplingSettings(m_lightSamplingSettings);
+    m_raytracer->setBVHCacheDirectory(m_bvhCacheEnabled ? glint::getCacheDir() / "bvh" : std::filesystem::path());
+    m_raytracer->setBVHBuildAlgorithm(m_bvhBuildAlgorithm);
+    m_raytracer->setGBufferCacheEnabled(m_gbufferCacheEnabled);
+    // First-hit AOVs guide the denoiser and cost no extra rays
+    m_raytracer->setAOVsEnabled(m_denoiseEnabled || m_aovOutputs.any());
+
+    // Apply scene edits since the last frame; only a first use or a cleared scene reloads everything
+    syncRaytracerScene(scene);
+
+    // Builds BVHs for new meshes and the top level if instances changed; no-op otherwise
+    m_raytracer->commit();
 
     // Create output buffer for raytraced image
     std::vector<glm::vec3> raytraceBuffer(m_raytraceWidth * m_raytraceHeight);
@@ -853,13 +776,58 @@ void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& light
     m_raytracer->renderImage(raytraceBuffer, m_raytraceWidth, m_raytraceHeight,
                             m_camera.position, m_camera.front, m_camera.up, 
                             m_camera.fov, lights);
-    
-    // Apply OIDN denoising if enabled
-    if (m_denoiseEnabled) {
-        std::cout << "[RenderSystem] Applying OIDN denoising...\n";
-        if (!denoise(raytraceBuffer, m_raytraceWidth, m_raytraceHeight)) {
+
+    // Apply OIDN denoising if enabled; it runs on the denoiser thread while the debug images below are written
+    const bool denoising = m_denoiseEnabled && DenoiserService::available();
+    if (m_denoiseEnabled && !denoising) {
+        std::cout << "[RenderSystem] Intel Open Image Denoise not available in this build\n";
+    }
+    if (denoising) {
+        const RaytraceAOVs& aovs = m_raytracer->getAOVs();
+        DenoiseRequest request;
+        request.width = m_raytraceWidth;
+        request.height = m_raytraceHeight;
+        request.frame = ++m_denoiseFrame;
+        if (aovs.albedo.size() == raytraceBuffer.size()) {
+            request.normal = aovs.normal;
+            request.albedo = aovs.albedo;
+        }
+        std::cout << "[RenderSystem] Applying OIDN denoising" << (request.albedo.empty() ? "" : " with albedo and normal guides") << "...\n";
+        request.color = raytraceBuffer;
+        m_denoiser->submit(std::move(request));
+    }
+
+    if (!m_sampleDensityPath.empty()) {
+        writeSampleDensity(m_sampleDensityPath);
+    }
+    if (m_aovOutputs.any()) {
+        writeAOVImages(m_aovOutputs);
+    }
+
+    if (denoising) {
+        const size_t pixelCount = static_cast<size_t>(m_raytraceWidth) * m_raytraceHeight;
+        DenoiseResult result;
+        // A preview shows the newest finished frame and only waits when none of this size exists yet
+        bool haveResult = false;
+        if (!waitForDenoise) {
+            haveResult = m_denoiser->poll(result);
+        }
+        if (waitForDenoise || (!haveResult && m_lastDenoised.size() != pixelCount)) {
+            haveResult = m_denoiser->wait(result);
+        }
+        if (haveResult && !result.denoised) {
             std::cerr << "[RenderSystem] Denoising failed, using raw raytraced image\n";
         }
+        if (haveResult && result.color.size() == pixelCount) {
+            if (waitForDenoise) {
+                raytraceBuffer = std::move(result.color);
+            } else {
+                m_lastDenoised = std::move(result.color);
+            }
+        }
+        if (!waitForDenoise && m_lastDenoised.size() == pixelCount) {
+            raytraceBuffer = m_lastDenoised;
+        }
     }
     
     // Upload raytraced image to texture
@@ -897,7 +865,110 @@ void RenderSystem::renderRaytraced(const SceneManager& scene, const Light& light
     std::cout << "[RenderSystem] Raytracing complete\n";
 }
 
-void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
+void RenderSystem::writeSampleDensity(const std::string& path) const
+{
+    std::vector<glm::vec3> density;
+    m_raytracer->sampleDensityImage(density);
+    writeRaytracePNG(path, density, "Sample density");
+}
+
+void RenderSystem::writeAOVImages(const RaytraceAOVOutputs& outputs) const
+{
+    const RaytraceAOVs& aovs = m_raytracer->getAOVs();
+    if (aovs.empty()) {
+        return;
+    }
+    const size_t pixelCount = aovs.albedo.size();
+
+    if (!outputs.albedo.empty()) {
+        writeRaytracePNG(outputs.albedo, aovs.albedo, "Albedo AOV");
+    }
+
+    if (!outputs.normal.empty()) {
+        std::vector<glm::vec3> image(pixelCount);
+        for (size_t i = 0; i < pixelCount; ++i) {
+            image[i] = aovs.normal[i] * 0.5f + 0.5f;
+        }
+        writeRaytracePNG(outputs.normal, image, "Normal AOV");
+    }
+
+    if (!outputs.depth.empty()) {
+        float nearest = RaytraceAOVs::kMissDepth, farthest = 0.0f;
+        for (float d : aovs.depth) {
+            if (d == RaytraceAOVs::kMissDepth) continue;
+            nearest = std::min(nearest, d);
+            farthest = std::max(farthest, d);
+        }
+        const float range = std::max(farthest - nearest, 1e-6f);
+        std::vector<glm::vec3> image(pixelCount, glm::vec3(0.0f));
+        for (size_t i = 0; i < pixelCount; ++i) {
+            if (aovs.depth[i] != RaytraceAOVs::kMissDepth) {
+                image[i] = glm::vec3(1.0f - 0.9f * (aovs.depth[i] - nearest) / range);
+            }
+        }
+        writeRaytracePNG(outputs.depth, image, "Depth AOV");
+    }
+
+    // Ids are shown as stable hashed colors; misses stay black
+    auto idColor = [](uint32_t id) {
+        const uint32_t h = sampling::hash32(id + 1u);
+        return glm::vec3(0.2f) + 0.8f * glm::vec3(h & 0xFFu, (h >> 8) & 0xFFu, (h >> 16) & 0xFFu) / 255.0f;
+    };
+
+    if (!outputs.objectId.empty()) {
+        // Report scene object ids rather than raytracer instance ids
+        std::unordered_map<uint32_t, uint32_t> instanceToObject;
+        for (const auto& entry : m_raytraceInstances) {
+            instanceToObject[entry.second] = entry.first;
+        }
+        std::vector<glm::vec3> image(pixelCount, glm::vec3(0.0f));
+        for (size_t i = 0; i < pixelCount; ++i) {
+            auto it = instanceToObject.find(aovs.instanceId[i]);
+            if (it != instanceToObject.end()) {
+                image[i] = idColor(it->second);
+            }
+        }
+        writeRaytracePNG(outputs.objectId, image, "Object id AOV");
+    }
+
+    if (!outputs.materialId.empty()) {
+        std::vector<glm::vec3> image(pixelCount, glm::vec3(0.0f));
+        for (size_t i = 0; i < pixelCount; ++i) {
+            if (aovs.materialId[i] != RaytraceAOVs::kNoHit) {
+                image[i] = idColor(aovs.materialId[i]);
+            }
+        }
+        writeRaytracePNG(outputs.materialId, image, "Material id AOV");
+    }
+}
+
+bool RenderSystem::writeRaytracePNG(const std::string& path, const std::vector<glm::vec3>& image, const char* label) const
+{
+    if (image.size() != static_cast<size_t>(m_raytraceWidth) * m_raytraceHeight) {
+        return false;
+    }
+
+    // The raytracer stores the bottom row first; PNG rows go top to bottom
+    std::vector<std::uint8_t> pixels(image.size() * 3);
+    for (int y = 0; y < m_raytraceHeight; ++y) {
+        const glm::vec3* src = &image[static_cast<size_t>(m_raytraceHeight - 1 - y) * m_raytraceWidth];
+        std::uint8_t* dst = &pixels[static_cast<size_t>(y) * m_raytraceWidth * 3];
+        for (int x = 0; x < m_raytraceWidth; ++x) {
+            dst[x * 3 + 0] = static_cast<std::uint8_t>(glm::clamp(src[x].r, 0.0f, 1.0f) * 255.0f + 0.5f);
+            dst[x * 3 + 1] = static_cast<std::uint8_t>(glm::clamp(src[x].g, 0.0f, 1.0f) * 255.0f + 0.5f);
+            dst[x * 3 + 2] = static_cast<std::uint8_t>(glm::clamp(src[x].b, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    if (stbi_write_png(path.c_str(), m_raytraceWidth, m_raytraceHeight, 3, pixels.data(), m_raytraceWidth * 3)) {
+        std::cout << "[RenderSystem] " << label << " written to " << path << "\n";
+        return true;
+    }
+    std::cerr << "[RenderSystem] Failed to write " << label << " to " << path << "\n";
+    return false;
+}
+
+void RenderSystem::renderObject(const SceneObject& obj)
 {
     // Basic object rendering - optimized for minimal state changes
     if (obj.VAO == 0) return;
@@ -917,20 +988,10 @@ void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
         setupCommonUniforms(s);
     }
 
-    // Matrices
+    // Camera, shading mode and lights come from the shared blocks uploaded by uploadSceneUniforms()
     s->setMat4("model", obj.modelMatrix);
-    s->setMat4("view", m_viewMatrix);
-    s->setMat4("projection", m_projectionMatrix);
-
-    // Camera and shading
-    s->setVec3("viewPos", m_camera.position);
-    s->setInt("shadingMode", (int)m_shadingMode);
 
     if (s == m_basicShader.get()) {
-        // Post-processing uniforms for standard shader
-        s->setFloat("exposure", m_exposure);
-        s->setFloat("gamma", m_gamma);
-        s->setInt("toneMappingMode", static_cast<int>(m_tonemap));
         // Material for standard shader
         s->setVec3("material.diffuse",  obj.material.diffuse);
         s->setVec3("material.specular", obj.material.specular);
@@ -949,20 +1010,12 @@ void RenderSystem::renderObject(const SceneObject& obj, const Light& lights)
         s->setBool("hasMRMap", obj.mrTex != nullptr);
         s->setBool("hasTangents", obj.VBO_tangents != 0);
         
-        // Set post-processing uniforms for PBR shader
-        s->setFloat("exposure", m_exposure);
-        s->setFloat("gamma", m_gamma);
-        s->setInt("toneMappingMode", static_cast<int>(m_tonemap));
-        
         int unit = 0;
         if (obj.baseColorTex) { obj.baseColorTex->bind(unit); s->setInt("baseColorTex", unit++); }
         if (obj.normalTex && obj.VBO_tangents != 0) { obj.normalTex->bind(unit); s->setInt("normalTex", unit++); }
         if (obj.mrTex) { obj.mrTex->bind(unit); s->setInt("mrTex", unit++); }
     }
 
-    // Lights (sets globalAmbient, lights[], numLights)
-    lights.applyLights(s->getID());
-
     // Bind dummy shadow map and identity lightSpaceMatrix to avoid undefined sampling
     glActiveTexture(GL_TEXTURE0 + 7);
     glBindTexture(GL_TEXTURE_2D, m_dummyShadowTex);
@@ -1103,8 +1156,11 @@ void RenderSystem::updateRenderStats(const SceneManager& scene)
         }
     }
 
+    // Offscreen targets kept resident by the pool
+    m_stats.renderTargetsMB = static_cast<float>(m_renderTargets.stats().bytes) / (1024.0f * 1024.0f);
+
     // Final VRAM estimate
-    m_stats.vramMB = m_stats.texturesMB + m_stats.geometryMB;
+    m_stats.vramMB = m_stats.texturesMB + m_stats.geometryMB + m_stats.renderTargetsMB;
 }
 
 void RenderSystem::initScreenQuad()
@@ -1161,6 +1217,10 @@ void RenderSystem::initRaytraceTexture()
 
 void RenderSystem::renderDebugElements(const SceneManager& scene, const Light& lights)
 {
+    // The selection overlay reads the shared blocks, which raytraced frames do not upload otherwise;
+    // it is drawn unlit, so the light lists of the last rasterized frame are kept
+    uploadSceneUniforms(lights, false);
+
     // Batch debug element rendering to minimize state changes
     if (m_showGrid && m_grid) {
         m_grid->render(m_viewMatrix, m_projectionMatrix);
@@ -1192,28 +1252,16 @@ void RenderSystem::renderSelectionOutline(const SceneManager& scene)
         if (obj.VAO != 0) {
             Shader* s = m_basicShader.get();
             s->use();
-            // Post-processing uniforms for standard shader (selection overlay respects gamma/exposure)
-            s->setFloat("exposure", m_exposure);
-            s->setFloat("gamma", m_gamma);
-            s->setInt("toneMappingMode", static_cast<int>(m_tonemap));
-            // Matrices
+            // Camera matrices come from the shared frame block
             s->setMat4("model", obj.modelMatrix);
-            s->setMat4("view", m_viewMatrix);
-            s->setMat4("projection", m_projectionMatrix);
-            // Solid highlight color via ambient-only lighting
-            s->setInt("shadingMode", 0); // flat path
+            // Solid highlight color; unlit skips the lights in the shared light block
+            s->setBool("unlit", true);
             s->setBool("useTexture", false);
             s->setVec3("objectColor", glm::vec3(0.2f, 0.7f, 1.0f)); // cyan-ish
-            s->setVec3("viewPos", m_camera.position);
-            // Force bright ambient and no direct lights
             glActiveTexture(GL_TEXTURE0 + 7);
             glBindTexture(GL_TEXTURE_2D, m_dummyShadowTex);
             s->setInt("shadowMap", 7);
             s->setMat4("lightSpaceMatrix", glm::mat4(1.0f));
-            // Material ambient = 1, other params not used in flat ambient-only path
-            s->setVec3("material.ambient", glm::vec3(1.0f));
-            s->setInt("numLights", 0);
-            s->setVec4("globalAmbient", glm::vec4(1.0f));
 
             // Draw as wireframe overlay with slight depth bias to reduce z-fighting
             GLint prevPolyMode[2];
@@ -1233,6 +1281,7 @@ void RenderSystem::renderSelectionOutline(const SceneManager& scene)
             m_stats.drawCalls += 1;
             glPolygonMode(GL_FRONT_AND_BACK, prevPolyMode[0]);
             glDisable(GL_POLYGON_OFFSET_LINE);
+            s->setBool("unlit", false);
         }
     }
 }
@@ -1271,7 +1320,7 @@ void RenderSystem::renderGizmo(const SceneManager& scene, const Light& lights)
     }
 }
 
-void RenderSystem::renderObjectsBatched(const SceneManager& scene, const Light& lights)
+void RenderSystem::renderObjectsBatched(const SceneManager& scene)
 {
     const auto& objects = scene.getObjects();
     if (objects.empty()) return;
@@ -1295,10 +1344,8 @@ void RenderSystem::renderObjectsBatched(const SceneManager& scene, const Light&
     if (!basicShaderObjects.empty() && m_basicShader) {
         m_basicShader->use();
         setupCommonUniforms(m_basicShader.get());
-        // Apply lighting for this shader
-        lights.applyLights(m_basicShader->getID());
         for (const auto* obj : basicShaderObjects) {
-            renderObjectFast(*obj, lights, m_basicShader.get());
+            renderObjectFast(*obj, m_basicShader.get());
         }
     }
     
@@ -1306,10 +1353,8 @@ void RenderSystem::renderObjectsBatched(const SceneManager& scene, const Light&
     if (!pbrShaderObjects.empty() && m_pbrShader) {
         m_pbrShader->use();
         setupCommonUniforms(m_pbrShader.get());
-        // Apply lighting for this shader
-        lights.applyLights(m_pbrShader->getID());
         for (const auto* obj : pbrShaderObjects) {
-            renderObjectFast(*obj, lights, m_pbrShader.get());
+            renderObjectFast(*obj, m_pbrShader.get());
         }
     }
     
@@ -1317,17 +1362,33 @@ void RenderSystem::renderObjectsBatched(const SceneManager& scene, const Light&
     glBindVertexArray(0);
 }
 
+void RenderSystem::uploadSceneUniforms(const Light& lights, bool binLights)
+{
+    // Camera, tone mapping and lights live in shared uniform blocks; unchanged blocks are not re-sent
+    FrameBlock frame;
+    frame.view = m_viewMatrix;
+    frame.projection = m_projectionMatrix;
+    frame.viewPos = m_camera.position;
+    frame.exposure = m_exposure;
+    frame.gamma = m_gamma;
+    frame.toneMappingMode = static_cast<int32_t>(m_tonemap);
+    frame.shadingMode = static_cast<int32_t>(m_shadingMode);
+
+    // Lights are binned into the view-frustum clusters of this camera; the block only carries the grid
+    if (binLights) {
+        m_lightClusters.build(lights, m_viewMatrix, m_projectionMatrix);
+        m_lightClusters.upload();
+    }
+    LightBlock lightBlock;
+    m_lightClusters.fillLightBlock(lights, lightBlock);
+    m_sceneUniforms.update(frame, lightBlock);
+}
+
 void RenderSystem::setupCommonUniforms(Shader* shader)
 {
-    // Set common uniforms that don't change per object
-    shader->setMat4("view", m_viewMatrix);
-    shader->setMat4("projection", m_projectionMatrix);
-    shader->setVec3("viewPos", m_camera.position);
-    shader->setInt("shadingMode", (int)m_shadingMode);
-    shader->setFloat("exposure", m_exposure);
-    shader->setFloat("gamma", m_gamma);
-    shader->setInt("toneMappingMode", static_cast<int>(m_tonemap));
-    
+    // Per-program state that cannot live in the shared blocks (samplers, shadow setup)
+    m_lightClusters.bind(*shader);
+
     // Bind dummy shadow map
     glActiveTexture(GL_TEXTURE0 + 7);
     glBindTexture(GL_TEXTURE_2D, m_dummyShadowTex);
@@ -1344,44 +1405,71 @@ void RenderSystem::setupCommonUniforms(Shader* shader)
     }
 }
 
-void RenderSystem::renderObjectFast(const SceneObject& obj, const Light& lights, Shader* shader)
+void RenderSystem::ObjectUniforms::resolve(const Shader& shader)
+{
+    model = shader.uniform<glm::mat4>("model");
+    diffuse = shader.uniform<glm::vec3>("material.diffuse");
+    specular = shader.uniform<glm::vec3>("material.specular");
+    ambient = shader.uniform<glm::vec3>("material.ambient");
+    objectColor = shader.uniform<glm::vec3>("objectColor");
+    shininess = shader.uniform<float>("material.shininess");
+    roughness = shader.uniform<float>("material.roughness");
+    metallic = shader.uniform<float>("material.metallic");
+    useTexture = shader.uniform<bool>("useTexture");
+    texture = shader.uniform<int>("cowTexture");
+    baseColorFactor = shader.uniform<glm::vec4>("baseColorFactor");
+    metallicFactor = shader.uniform<float>("metallicFactor");
+    roughnessFactor = shader.uniform<float>("roughnessFactor");
+    ior = shader.uniform<float>("ior");
+    hasBaseColorMap = shader.uniform<bool>("hasBaseColorMap");
+    hasNormalMap = shader.uniform<bool>("hasNormalMap");
+    hasMRMap = shader.uniform<bool>("hasMRMap");
+    hasTangents = shader.uniform<bool>("hasTangents");
+    baseColorTex = shader.uniform<int>("baseColorTex");
+    normalTex = shader.uniform<int>("normalTex");
+    mrTex = shader.uniform<int>("mrTex");
+}
+
+void RenderSystem::renderObjectFast(const SceneObject& obj, Shader* shader)
 {
-    // Fast object rendering with minimal per-object state changes
-    shader->setMat4("model", obj.modelMatrix);
+    // Fast object rendering with minimal per-object state changes; uniform handles skip name lookups
+    const bool basic = shader == m_basicShader.get();
+    const ObjectUniforms& u = basic ? m_basicUniforms : m_pbrUniforms;
+    shader->set(u.model, obj.modelMatrix);
     
-    if (shader == m_basicShader.get()) {
+    if (basic) {
         // Standard shader material uniforms
-        shader->setVec3("material.diffuse",  obj.material.diffuse);
-        shader->setVec3("material.specular", obj.material.specular);
-        shader->setVec3("material.ambient",  obj.material.ambient);
-        shader->setFloat("material.shininess", obj.material.shininess);
-        shader->setFloat("material.roughness", obj.material.roughness);
-        shader->setFloat("material.metallic",  obj.material.metallic);
+        shader->set(u.diffuse,  obj.material.diffuse);
+        shader->set(u.specular, obj.material.specular);
+        shader->set(u.ambient,  obj.material.ambient);
+        shader->set(u.shininess, obj.material.shininess);
+        shader->set(u.roughness, obj.material.roughness);
+        shader->set(u.metallic,  obj.material.metallic);
         
         // Texturing
         if (obj.texture) {
             obj.texture->bind(0);
-            shader->setBool("useTexture", true);
-            shader->setInt("cowTexture", 0);
+            shader->set(u.useTexture, true);
+            shader->set(u.texture, 0);
         } else {
-            shader->setBool("useTexture", false);
-            shader->setVec3("objectColor", obj.color);
+            shader->set(u.useTexture, false);
+            shader->set(u.objectColor, obj.color);
         }
     } else {
         // PBR shader uniforms
-        shader->setVec4("baseColorFactor", obj.baseColorFactor);
-        shader->setFloat("metallicFactor", obj.metallicFactor);
-        shader->setFloat("roughnessFactor", obj.roughnessFactor);
-        shader->setFloat("ior", obj.ior);
-        shader->setBool("hasBaseColorMap", obj.baseColorTex != nullptr);
-        shader->setBool("hasNormalMap", obj.normalTex != nullptr && obj.VBO_tangents != 0);
-        shader->setBool("hasMRMap", obj.mrTex != nullptr);
-        shader->setBool("hasTangents", obj.VBO_tangents != 0);
+        shader->set(u.baseColorFactor, obj.baseColorFactor);
+        shader->set(u.metallicFactor, obj.metallicFactor);
+        shader->set(u.roughnessFactor, obj.roughnessFactor);
+        shader->set(u.ior, obj.ior);
+        shader->set(u.hasBaseColorMap, obj.baseColorTex != nullptr);
+        shader->set(u.hasNormalMap, obj.normalTex != nullptr && obj.VBO_tangents != 0);
+        shader->set(u.hasMRMap, obj.mrTex != nullptr);
+        shader->set(u.hasTangents, obj.VBO_tangents != 0);
         
         int unit = 0;
-        if (obj.baseColorTex) { obj.baseColorTex->bind(unit); shader->setInt("baseColorTex", unit++); }
-        if (obj.normalTex && obj.VBO_tangents != 0) { obj.normalTex->bind(unit); shader->setInt("normalTex", unit++); }
-        if (obj.mrTex) { obj.mrTex->bind(unit); shader->setInt("mrTex", unit++); }
+        if (obj.baseColorTex) { obj.baseColorTex->bind(unit); shader->set(u.baseColorTex, unit++); }
+        if (obj.normalTex && obj.VBO_tangents != 0) { obj.normalTex->bind(unit); shader->set(u.normalTex, unit++); }
+        if (obj.mrTex) { obj.mrTex->bind(unit); shader->set(u.mrTex, unit++); }
     }
     
     glBindVertexArray(obj.VAO);
@@ -2,10 +2,19 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <cstdint>
 #include "gl_platform.h"
 #include "gizmo.h"
+#include "tile_scheduler.h"
+#include "path_integrator.h"
+#include "light_sampler.h"
+#include "bvh_builder.h"
+#include "shader.h"
+#include "uniform_buffers.h"
+#include "light_clusters.h"
+#include "render_target_pool.h"
 
 // Forward declarations
 class SceneManager;
@@ -16,9 +25,9 @@ class Grid;
 class Gizmo;
 class Skybox;
 class IBLSystem;
+class DenoiserService;
 struct SceneObject;
-
-class Shader;
+struct SceneChangeEvent;
 
 enum class RenderToneMapMode {
     Linear = 0,
@@ -57,11 +66,25 @@ struct RenderStats {
     size_t uniqueTextures = 0;
     float texturesMB = 0.0f;
     float geometryMB = 0.0f;
+    float renderTargetsMB = 0.0f;  // Pooled offscreen framebuffers
     float vramMB = 0.0f;
     int topSharedCount = 0;
     std::string topSharedKey;
 };
 
+// PNG paths for raytraced first-hit AOVs; empty entries are not written
+struct RaytraceAOVOutputs {
+    std::string albedo;
+    std::string normal;      // World-space normals mapped to [0, 1]
+    std::string depth;       // Nearest hit white, farthest black, misses black
+    std::string objectId;    // One hashed color per scene object
+    std::string materialId;  // One hashed color per material
+
+    bool any() const {
+        return !albedo.empty() || !normal.empty() || !depth.empty() || !objectId.empty() || !materialId.empty();
+    }
+};
+
 class RenderSystem 
 {
 public:
@@ -147,6 +170,42 @@ public:
     // Reflection samples per pixel for glossy reflections
     void setReflectionSpp(int spp);
     int getReflectionSpp() const;
+
+    // Raytracer tiling and thread count
+    void setTileSchedulerSettings(const TileSchedulerSettings& settings);
+    const TileSchedulerSettings& getTileSchedulerSettings() const { return m_tileSchedulerSettings; }
+
+    // Raytracer integrator (Whitted or path) and bounce limits
+    void setPathTracerSettings(const PathTracerSettings& settings);
+    const PathTracerSettings& getPathTracerSettings() const { return m_pathTracerSettings; }
+
+    // Reuse raytracer mesh BVHs across runs via files in the user cache directory (on by default)
+    void setBVHCacheEnabled(bool enabled) { m_bvhCacheEnabled = enabled; }
+    bool isBVHCacheEnabled() const { return m_bvhCacheEnabled; }
+
+    // Raytracer mesh BVH builder: binned SAH for final renders, LBVH for fast previews
+    void setBVHBuildAlgorithm(BVHBuildAlgorithm algorithm) { m_bvhBuildAlgorithm = algorithm; }
+    BVHBuildAlgorithm getBVHBuildAlgorithm() const { return m_bvhBuildAlgorithm; }
+
+    // Keep raytraced camera hits so light and material edits skip the primary rays (off by default)
+    void setGBufferCacheEnabled(bool enabled) { m_gbufferCacheEnabled = enabled; }
+    bool isGBufferCacheEnabled() const { return m_gbufferCacheEnabled; }
+
+    // Raytracer light selection: evaluate every light, or sample a few per shading point
+    void setLightSamplingSettings(const LightSamplingSettings& settings);
+    const LightSamplingSettings& getLightSamplingSettings() const { return m_lightSamplingSettings; }
+
+    // Progressive raytracing stop conditions (target spp, time budget, noise threshold)
+    void setProgressiveSettings(const ProgressiveRenderSettings& settings);
+    const ProgressiveRenderSettings& getProgressiveSettings() const { return m_progressiveSettings; }
+
+    // Writes a samples-per-pixel heat map PNG after each raytraced render (empty path disables)
+    void setSampleDensityOutput(const std::string& path) { m_sampleDensityPath = path; }
+    const std::string& getSampleDensityOutput() const { return m_sampleDensityPath; }
+
+    // Writes first-hit AOV PNGs after each raytraced render (empty paths are skipped)
+    void setAOVOutputs(const RaytraceAOVOutputs& outputs) { m_aovOutputs = outputs; }
+    const RaytraceAOVOutputs& getAOVOutputs() const { return m_aovOutputs; }
     bool denoise(std::vector<glm::vec3>& color,
                 const std::vector<glm::vec3>* normal = nullptr,
                 const std::vector<glm::vec3>* albedo = nullptr);
@@ -213,8 +272,27 @@ private:
     
     // Raytracer
     std::unique_ptr<Raytracer> m_raytracer;
+    std::unique_ptr<DenoiserService> m_denoiser;   // Persistent OIDN device and filters
+    std::vector<glm::vec3> m_lastDenoised;         // Newest denoised preview frame
+    uint64_t m_denoiseFrame = 0;
+
+    // Persistent raytracer scene, kept in sync through SceneManager change events
+    const SceneManager* m_raytraceScene = nullptr;
+    int m_raytraceSceneListener = 0;
+    bool m_raytraceSceneReload = true;
+    std::unordered_map<uint32_t, uint32_t> m_raytraceInstances; // SceneObject::id -> raytracer instance
+    std::vector<SceneChangeEvent> m_pendingSceneChanges;
     bool m_denoiseEnabled = false;
     int m_reflectionSpp = 8; // Default reflection samples per pixel
+    TileSchedulerSettings m_tileSchedulerSettings;
+    ProgressiveRenderSettings m_progressiveSettings;
+    PathTracerSettings m_pathTracerSettings;
+    LightSamplingSettings m_lightSamplingSettings;
+    bool m_bvhCacheEnabled = true;
+    BVHBuildAlgorithm m_bvhBuildAlgorithm = BVHBuildAlgorithm::BinnedSAH;
+    bool m_gbufferCacheEnabled = false;
+    std::string m_sampleDensityPath;
+    RaytraceAOVOutputs m_aovOutputs;
     
     // Raytracing screen quad resources
     GLuint m_screenQuadVAO = 0;
@@ -229,6 +307,33 @@ private:
     std::unique_ptr<Shader> m_pbrShader;
     std::unique_ptr<Shader> m_gridShader;
     std::unique_ptr<Shader> m_gradientShader;
+
+    // Per-object uniforms of the batched path, resolved once after the shaders load
+    struct ObjectUniforms {
+        Uniform<glm::mat4> model;
+        // Standard shader
+        Uniform<glm::vec3> diffuse, specular, ambient, objectColor;
+        Uniform<float> shininess, roughness, metallic;
+        Uniform<bool> useTexture;
+        Uniform<int> texture;
+        // PBR shader
+        Uniform<glm::vec4> baseColorFactor;
+        Uniform<float> metallicFactor, roughnessFactor, ior;
+        Uniform<bool> hasBaseColorMap, hasNormalMap, hasMRMap, hasTangents;
+        Uniform<int> baseColorTex, normalTex, mrTex;
+
+        void resolve(const Shader& shader);
+    };
+    ObjectUniforms m_basicUniforms;
+    ObjectUniforms m_pbrUniforms;
+
+    // Camera and light blocks shared by the scene programs
+    SceneUniformBuffers m_sceneUniforms;
+    // Per-cluster light lists read by the scene programs, rebuilt each rasterized frame
+    LightClusters m_lightClusters;
+
+    // Offscreen framebuffers reused across renderToTexture/renderToPNG calls
+    RenderTargetPool m_renderTargets;
     
     // Fallback shadow map to satisfy shaders that sample shadowMap
     GLuint m_dummyShadowTex = 0;
@@ -238,17 +343,27 @@ private:
     
     // Private methods
     void renderRasterized(const SceneManager& scene, const Light& lights);
-    void renderRaytraced(const SceneManager& scene, const Light& lights);
-    void renderObject(const SceneObject& obj, const Light& lights);
+    // Previews may show the previous denoised frame while the current one is denoised;
+    // offscreen renders always wait for their own frame
+    void renderRaytraced(const SceneManager& scene, const Light& lights, bool waitForDenoise = true);
+    // Draws the scene into a complete framebuffer of the given size (through a pooled MSAA target when enabled)
+    bool renderOffscreen(const SceneManager& scene, const Light& lights, GLuint targetFBO, int width, int height);
+    void writeSampleDensity(const std::string& path) const;
+    void writeAOVImages(const RaytraceAOVOutputs& outputs) const;
+    bool writeRaytracePNG(const std::string& path, const std::vector<glm::vec3>& image, const char* label) const;
+    void syncRaytracerScene(const SceneManager& scene);
+    void detachRaytracerScene();
+    void renderObject(const SceneObject& obj);
     void updateRenderStats(const SceneManager& scene);
     
     // Optimized rendering methods
     void renderDebugElements(const SceneManager& scene, const Light& lights);
     void renderSelectionOutline(const SceneManager& scene);
     void renderGizmo(const SceneManager& scene, const Light& lights);
-    void renderObjectsBatched(const SceneManager& scene, const Light& lights);
+    void renderObjectsBatched(const SceneManager& scene);
     void setupCommonUniforms(Shader* shader);
-    void renderObjectFast(const SceneObject& obj, const Light& lights, Shader* shader);
+    void uploadSceneUniforms(const Light& lights, bool binLights = true);
+    void renderObjectFast(const SceneObject& obj, Shader* shader);
     
     // Raytracing support methods
     void initScreenQuad();
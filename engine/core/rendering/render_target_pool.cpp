@@ -0,0 +1,180 @@
+#include "render_target_pool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    size_t bytesPerPixel(GLenum format)
+    {
+        switch (format) {
+            case 0: return 0;
+            case GL_RGBA16F: return 8;
+            case GL_RGBA32F: return 16;
+            case GL_RGB32F: return 12;
+            case GL_RGB16F: return 6;
+            default: return 4;  // RGBA8, SRGB8_ALPHA8 and other 32-bit formats
+        }
+    }
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+    clear();
+}
+
+RenderTarget* RenderTargetPool::acquire(const RenderTargetDesc& desc)
+{
+    if (desc.width <= 0 || desc.height <= 0)
+        return nullptr;
+
+    // Most recently used match first, so a steady batch keeps cycling through the same target
+    Entry* best = nullptr;
+    for (Entry& entry : m_entries) {
+        if (!entry.inUse && entry.target->desc == desc && (!best || entry.lastUsed > best->lastUsed))
+            best = &entry;
+    }
+    if (best) {
+        best->inUse = true;
+        best->lastUsed = ++m_clock;
+        ++m_stats.reused;
+        updateStats();
+        return best->target.get();
+    }
+
+    auto target = std::make_unique<RenderTarget>();
+    if (!create(desc, *target)) {
+        destroy(*target);
+        return nullptr;
+    }
+    ++m_stats.created;
+    Entry entry;
+    entry.target = std::move(target);
+    entry.inUse = true;
+    entry.lastUsed = ++m_clock;
+    m_entries.push_back(std::move(entry));
+    updateStats();
+    return m_entries.back().target.get();
+}
+
+void RenderTargetPool::release(RenderTarget* target)
+{
+    if (!target)
+        return;
+    for (Entry& entry : m_entries) {
+        if (entry.target.get() == target) {
+            entry.inUse = false;
+            entry.lastUsed = ++m_clock;
+            break;
+        }
+    }
+    trim(m_idleBudget);
+}
+
+void RenderTargetPool::trim(size_t budgetBytes)
+{
+    size_t idleBytes = 0;
+    for (const Entry& entry : m_entries) {
+        if (!entry.inUse)
+            idleBytes += entry.target->bytes;
+    }
+    while (idleBytes > budgetBytes) {
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (!it->inUse && (oldest == m_entries.end() || it->lastUsed < oldest->lastUsed))
+                oldest = it;
+        }
+        if (oldest == m_entries.end())
+            break;
+        idleBytes -= oldest->target->bytes;
+        destroy(*oldest->target);
+        m_entries.erase(oldest);
+        ++m_stats.evicted;
+    }
+    updateStats();
+}
+
+void RenderTargetPool::setIdleBudget(size_t budgetBytes)
+{
+    m_idleBudget = budgetBytes;
+    trim(m_idleBudget);
+}
+
+void RenderTargetPool::clear()
+{
+    for (Entry& entry : m_entries) {
+        if (entry.inUse)
+            std::cerr << "[RenderTargetPool] Deleting a render target that is still in use\n";
+        destroy(*entry.target);
+    }
+    m_entries.clear();
+    updateStats();
+}
+
+bool RenderTargetPool::create(const RenderTargetDesc& desc, RenderTarget& target)
+{
+    target.desc = desc;
+    const int samples = std::max(1, desc.samples);
+    glGenFramebuffers(1, &target.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+
+    if (desc.colorFormat != 0) {
+        if (samples > 1) {
+            glGenRenderbuffers(1, &target.colorRBO);
+            glBindRenderbuffer(GL_RENDERBUFFER, target.colorRBO);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, desc.colorFormat, desc.width, desc.height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorRBO);
+        } else {
+            glGenTextures(1, &target.colorTexture);
+            glBindTexture(GL_TEXTURE_2D, target.colorTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(desc.colorFormat), desc.width, desc.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.colorTexture, 0);
+        }
+        const GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+        glDrawBuffers(1, drawBuffers);
+    }
+
+    if (desc.depth) {
+        glGenRenderbuffers(1, &target.depthRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depthRBO);
+        if (samples > 1)
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, desc.width, desc.height);
+        else
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, desc.width, desc.height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depthRBO);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // A target without a color attachment is completed by the caller, so it is not checked here
+    const bool complete = desc.colorFormat == 0 || glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    const size_t pixels = static_cast<size_t>(desc.width) * static_cast<size_t>(desc.height) * static_cast<size_t>(samples);
+    target.bytes = pixels * (bytesPerPixel(desc.colorFormat) + (desc.depth ? 4 : 0));
+    return complete;
+}
+
+void RenderTargetPool::destroy(RenderTarget& target)
+{
+    if (target.fbo) { glDeleteFramebuffers(1, &target.fbo); target.fbo = 0; }
+    if (target.colorTexture) { glDeleteTextures(1, &target.colorTexture); target.colorTexture = 0; }
+    if (target.colorRBO) { glDeleteRenderbuffers(1, &target.colorRBO); target.colorRBO = 0; }
+    if (target.depthRBO) { glDeleteRenderbuffers(1, &target.depthRBO); target.depthRBO = 0; }
+    target.bytes = 0;
+}
+
+void RenderTargetPool::updateStats()
+{
+    m_stats.targets = m_entries.size();
+    m_stats.bytes = 0;
+    m_stats.idleBytes = 0;
+    for (const Entry& entry : m_entries) {
+        m_stats.bytes += entry.target->bytes;
+        if (!entry.inUse)
+            m_stats.idleBytes += entry.target->bytes;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "gl_platform.h"
+
+// Shape of an offscreen framebuffer; targets are only reused for an identical description
+struct RenderTargetDesc {
+    int width = 0;
+    int height = 0;
+    GLenum colorFormat = GL_RGBA8;  // 0 = no color attachment (the caller attaches its own texture)
+    int samples = 1;                // > 1 allocates multisampled renderbuffers instead of a texture
+    bool depth = true;              // GL_DEPTH24_STENCIL8 attachment
+
+    bool operator==(const RenderTargetDesc& other) const
+    {
+        return width == other.width && height == other.height && colorFormat == other.colorFormat &&
+               samples == other.samples && depth == other.depth;
+    }
+};
+
+// A complete framebuffer and its attachments, owned by the pool
+struct RenderTarget {
+    RenderTargetDesc desc;
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;  // Single-sample color
+    GLuint colorRBO = 0;      // Multisampled color
+    GLuint depthRBO = 0;
+    size_t bytes = 0;         // Estimated GPU memory of the attachments
+};
+
+// Reuses offscreen framebuffers across renderToTexture/renderToPNG calls, so batches of same-size
+// renders allocate their attachments once. Released targets stay resident until the idle ones exceed
+// the memory budget, then the least recently used are deleted first.
+class RenderTargetPool {
+public:
+    // Default budget for idle targets (e.g. ~20 MSAA 4x targets at 1024x1024)
+    static constexpr size_t kDefaultIdleBudgetBytes = size_t(256) << 20;
+
+    struct Stats {
+        size_t targets = 0;        // Resident targets, idle or in use
+        size_t bytes = 0;          // Their estimated GPU memory
+        size_t idleBytes = 0;
+        uint64_t reused = 0;       // acquire() calls served from the pool
+        uint64_t created = 0;
+        uint64_t evicted = 0;
+    };
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // Returns an idle target matching desc, or creates one; nullptr if the framebuffer is incomplete.
+    // The target stays valid and exclusive to the caller until release()
+    RenderTarget* acquire(const RenderTargetDesc& desc);
+    // Hands a target back; it becomes the most recently used and idle targets are trimmed to the budget
+    void release(RenderTarget* target);
+
+    // Deletes least recently used idle targets until the idle ones fit in budgetBytes
+    void trim(size_t budgetBytes);
+    void setIdleBudget(size_t budgetBytes);
+    size_t idleBudget() const { return m_idleBudget; }
+
+    // Deletes every target; none may be in use
+    void clear();
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct Entry {
+        std::unique_ptr<RenderTarget> target;
+        uint64_t lastUsed = 0;
+        bool inUse = false;
+    };
+
+    std::vector<Entry> m_entries;
+    uint64_t m_clock = 0;
+    size_t m_idleBudget = kDefaultIdleBudgetBytes;
+    Stats m_stats;
+
+    static bool create(const RenderTargetDesc& desc, RenderTarget& target);
+    static void destroy(RenderTarget& target);
+    void updateStats();
+};
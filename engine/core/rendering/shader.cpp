@@ -1,4 +1,5 @@
 ﻿#include "shader.h"
+#include "uniform_buffers.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -23,23 +24,7 @@ bool Shader::load(const std::string& vertexPath, const std::string& fragmentPath
     GLuint frag = compileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER);
     if (!vert || !frag) return false;
 
-    m_programID = glCreateProgram();
-    glAttachShader(m_programID, vert);
-    glAttachShader(m_programID, frag);
-    glLinkProgram(m_programID);
-
-    GLint success;
-    glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(m_programID, 512, nullptr, infoLog);
-        std::cerr << "Shader Link Error:\n" << infoLog << std::endl;
-        return false;
-    }
-
-    glDeleteShader(vert);
-    glDeleteShader(frag);
-    return true;
+    return link(vert, frag);
 }
 
 bool Shader::loadFromStrings(const std::string& vertexSource, const std::string& fragmentSource)
@@ -48,6 +33,11 @@ bool Shader::loadFromStrings(const std::string& vertexSource, const std::string&
     GLuint frag = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
     if (!vert || !frag) return false;
 
+    return link(vert, frag);
+}
+
+bool Shader::link(GLuint vert, GLuint frag)
+{
     m_programID = glCreateProgram();
     glAttachShader(m_programID, vert);
     glAttachShader(m_programID, frag);
@@ -64,9 +54,53 @@ bool Shader::loadFromStrings(const std::string& vertexSource, const std::string&
 
     glDeleteShader(vert);
     glDeleteShader(frag);
+    bindSceneUniformBlocks(m_programID);
+    reflectUniforms();
     return true;
 }
 
+void Shader::reflectUniforms()
+{
+    // Query every active uniform once so setters never ask the driver for a location again
+    m_uniformLocations.clear();
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string name(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_programID, static_cast<GLuint>(i), maxLength, &length, &size, &type, &name[0]);
+        const std::string uniformName = name.substr(0, static_cast<size_t>(length));
+        const GLint location = glGetUniformLocation(m_programID, uniformName.c_str());
+        // Members of uniform blocks have no location
+        if (location < 0)
+            continue;
+        m_uniformLocations[uniformName] = location;
+
+        // Arrays are reported once as "name[0]"; register the bare name and every element
+        const size_t bracket = uniformName.size() > 3 ? uniformName.rfind("[0]") : std::string::npos;
+        if (bracket == std::string::npos || bracket + 3 != uniformName.size())
+            continue;
+        const std::string base = uniformName.substr(0, bracket);
+        m_uniformLocations[base] = location;
+        for (GLint element = 1; element < size; ++element) {
+            const std::string elementName = base + "[" + std::to_string(element) + "]";
+            const GLint elementLocation = glGetUniformLocation(m_programID, elementName.c_str());
+            if (elementLocation >= 0)
+                m_uniformLocations[elementName] = elementLocation;
+        }
+    }
+}
+
+GLint Shader::getUniformLocation(const std::string& name) const
+{
+    auto it = m_uniformLocations.find(name);
+    return it != m_uniformLocations.end() ? it->second : -1;
+}
+
 void Shader::use() const
 {
     glUseProgram(m_programID);
@@ -171,30 +205,61 @@ GLuint Shader::compileShader(const std::string& source, GLenum type)
 // Uniform helpers
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_programID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    set(uniform<glm::mat4>(name), mat);
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& vec) const
 {
-    glUniform3fv(glGetUniformLocation(m_programID, name.c_str()), 1, glm::value_ptr(vec));
+    set(uniform<glm::vec3>(name), vec);
 }
 
 void Shader::setVec4(const std::string& name, const glm::vec4& vec) const
 {
-    glUniform4fv(glGetUniformLocation(m_programID, name.c_str()), 1, glm::value_ptr(vec));
+    set(uniform<glm::vec4>(name), vec);
 }
 
 void Shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(m_programID, name.c_str()), value);
+    set(uniform<float>(name), value);
 }
 
 void Shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(m_programID, name.c_str()), value);
+    set(uniform<int>(name), value);
 }
 
 void Shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(m_programID, name.c_str()), (int)value);
+    set(uniform<bool>(name), value);
+}
+
+// Inactive uniforms keep location -1, which glUniform* ignores, matching the old lookups
+void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::set(Uniform<glm::vec3> uniform, const glm::vec3& vec) const
+{
+    glUniform3fv(uniform.location, 1, glm::value_ptr(vec));
+}
+
+void Shader::set(Uniform<glm::vec4> uniform, const glm::vec4& vec) const
+{
+    glUniform4fv(uniform.location, 1, glm::value_ptr(vec));
+}
+
+void Shader::set(Uniform<float> uniform, float value) const
+{
+    glUniform1f(uniform.location, value);
+}
+
+void Shader::set(Uniform<int> uniform, int value) const
+{
+    glUniform1i(uniform.location, value);
+}
+
+void Shader::set(Uniform<bool> uniform, bool value) const
+{
+    glUniform1i(uniform.location, (int)value);
 }
@@ -1,11 +1,21 @@
 #pragma once
 #include <string>
+#include <unordered_map>
 #include "gl_platform.h"
 #include <glm/glm.hpp>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// Pre-resolved uniform location; the value type selects the glUniform call.
+// Default-constructed handles (and handles of inactive uniforms) are ignored by Shader::set.
+template <typename T>
+struct Uniform
+{
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
 class Shader
 {
 public:
@@ -23,10 +33,29 @@ public:
     void setInt(const std::string& name, int value) const;
     void setBool(const std::string& name, bool value) const;
 
+    // Location of an active uniform from the table reflected at link time; -1 when inactive.
+    // Array elements resolve both as "name" and "name[i]".
+    GLint getUniformLocation(const std::string& name) const;
+
+    // Resolve once (e.g. after load), then set per draw without any string lookup
+    template <typename T>
+    Uniform<T> uniform(const std::string& name) const { return Uniform<T>{getUniformLocation(name)}; }
+
+    void set(Uniform<glm::mat4> uniform, const glm::mat4& value) const;
+    void set(Uniform<glm::vec3> uniform, const glm::vec3& value) const;
+    void set(Uniform<glm::vec4> uniform, const glm::vec4& value) const;
+    void set(Uniform<float> uniform, float value) const;
+    void set(Uniform<int> uniform, int value) const;
+    void set(Uniform<bool> uniform, bool value) const;
+
     GLuint getID() const;
 
 private:
     GLuint m_programID;
+    std::unordered_map<std::string, GLint> m_uniformLocations;
+
+    bool link(GLuint vert, GLuint frag);
+    void reflectUniforms();
 
     std::string loadShaderFromFile(const std::string& path);
     GLuint compileShader(const std::string& source, GLenum type);
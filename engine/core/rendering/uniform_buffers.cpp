@@ -0,0 +1,78 @@
+#include "uniform_buffers.h"
+#include <cstring>
+
+UniformBlockBuffer::~UniformBlockBuffer()
+{
+    cleanup();
+}
+
+void UniformBlockBuffer::init(GLuint binding, size_t size)
+{
+    cleanup();
+    m_binding = binding;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    // The binding point is context state shared by every program, so this happens once
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer);
+    m_uploaded.assign(size, 0);
+    m_valid = false;
+}
+
+bool UniformBlockBuffer::update(const void* data, size_t size)
+{
+    if (!m_buffer || size != m_uploaded.size())
+        return false;
+    if (m_valid && std::memcmp(m_uploaded.data(), data, size) == 0)
+        return false;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    std::memcpy(m_uploaded.data(), data, size);
+    m_valid = true;
+    return true;
+}
+
+void UniformBlockBuffer::cleanup()
+{
+    if (m_buffer) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_uploaded.clear();
+    m_valid = false;
+}
+
+void SceneUniformBuffers::init()
+{
+    m_frame.init(kFrameBlockBinding, sizeof(FrameBlock));
+    m_lights.init(kLightBlockBinding, sizeof(LightBlock));
+}
+
+void SceneUniformBuffers::cleanup()
+{
+    m_frame.cleanup();
+    m_lights.cleanup();
+}
+
+void SceneUniformBuffers::update(const FrameBlock& frame, const LightBlock& lights)
+{
+    m_frame.update(&frame, sizeof(frame));
+    m_lights.update(&lights, sizeof(lights));
+}
+
+void bindSceneUniformBlocks(GLuint program)
+{
+    struct BlockBinding { const char* name; GLuint binding; };
+    static const BlockBinding kBlocks[] = {
+        {"FrameBlock", kFrameBlockBinding},
+        {"LightBlock", kLightBlockBinding},
+    };
+    for (const BlockBinding& block : kBlocks) {
+        const GLuint index = glGetUniformBlockIndex(program, block.name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, block.binding);
+    }
+}
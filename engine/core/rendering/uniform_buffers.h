@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gl_platform.h"
+
+// Fixed binding points of the std140 blocks shared by the scene shaders
+constexpr GLuint kFrameBlockBinding = 0;
+constexpr GLuint kLightBlockBinding = 1;
+
+// CPU mirror of `FrameBlock` (std140): per-frame camera and tone-mapping state
+struct FrameBlock {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec3 viewPos{0.0f};
+    float exposure = 0.0f;
+    float gamma = 2.2f;
+    int32_t toneMappingMode = 0;
+    int32_t shadingMode = 0;
+    int32_t pad0 = 0;
+};
+static_assert(sizeof(FrameBlock) == 160, "FrameBlock must match the std140 layout in the shaders");
+
+// CPU mirror of `LightBlock` (std140): ambient term and the cluster grid the light lists were binned on.
+// The lights themselves live in buffer textures (see light_clusters.h)
+struct LightBlock {
+    glm::vec4 globalAmbient{0.0f};
+    glm::vec4 clusterDepth{0.0f};   // x = scale, y = bias: slice = floor(log(view depth) * x + y)
+    glm::ivec4 clusterDims{1};      // Tiles across x, tiles across y, depth slices
+    glm::ivec4 lightCounts{0};      // x = lights in the light buffer, y = unbounded lights heading the index list
+};
+static_assert(sizeof(LightBlock) == 64, "LightBlock must match the std140 layout in the shaders");
+
+// One GL uniform buffer bound to a fixed binding point; uploads only when its contents change
+class UniformBlockBuffer {
+public:
+    UniformBlockBuffer() = default;
+    ~UniformBlockBuffer();
+    UniformBlockBuffer(const UniformBlockBuffer&) = delete;
+    UniformBlockBuffer& operator=(const UniformBlockBuffer&) = delete;
+
+    void init(GLuint binding, size_t size);
+    // Returns true when the data differed from the last upload and was sent to the GPU
+    bool update(const void* data, size_t size);
+    void cleanup();
+
+private:
+    GLuint m_buffer = 0;
+    GLuint m_binding = 0;
+    std::vector<unsigned char> m_uploaded;  // Last contents sent, for the dirty check
+    bool m_valid = false;
+};
+
+// The frame and light blocks every scene program reads; filled once per frame
+class SceneUniformBuffers {
+public:
+    void init();
+    void cleanup();
+
+    // Upload the camera state and light grid parameters; unchanged blocks are skipped
+    void update(const FrameBlock& frame, const LightBlock& lights);
+
+private:
+    UniformBlockBuffer m_frame;
+    UniformBlockBuffer m_lights;
+};
+
+// Attaches the shared blocks a program declares to their fixed binding points
+void bindSceneUniformBlocks(GLuint program);
@@ -317,6 +317,11 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
                 if (!obj["intensity"].IsNumber()) { error = "add_light: bad 'intensity'"; return false; } 
                 intensity = obj["intensity"].GetDouble(); 
             }
+            double range = 0.0;
+            if (obj.HasMember("range")) {
+                if (!obj["range"].IsNumber() || obj["range"].GetDouble() < 0.0) { error = "add_light: bad 'range'"; return false; }
+                range = obj["range"].GetDouble();
+            }
             
             if (lightType == "point") {
                 if (obj.HasMember("position") && obj["position"].IsArray()) { 
@@ -347,6 +352,7 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
                 if (outerDeg < innerDeg) std::swap(outerDeg, innerDeg);
                 m_lights.addSpotLight(pos, dir, color, (float)intensity, (float)innerDeg, (float)outerDeg);
             }
+            if (lightType != "directional") m_lights.m_lights.back().range = (float)range;
             return true;
         }
         else if (op == "set_material") {
@@ -359,6 +365,9 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
             if (!obj.HasMember("material") || !obj["material"].IsObject()) { error = "set_material: missing 'material'"; return false; }
             const auto& matObj = obj["material"];
 
+            // Listeners read the material lazily, so flag it before fields are edited in place
+            m_scene.notifyObjectChanged(target, SceneChangeType::MaterialChanged);
+
             // Update material properties
             if (matObj.HasMember("color") && matObj["color"].IsArray()) {
                 glm::vec3 color;
@@ -471,8 +480,74 @@ bool JsonOpsExecutor::apply(const std::string& json, std::string& error)
             int width = 800, height = 600;
             if (obj.HasMember("width") && obj["width"].IsInt()) width = obj["width"].GetInt();
             if (obj.HasMember("height") && obj["height"].IsInt()) height = obj["height"].GetInt();
-            
+
+            // Optional per-job progressive budgets; the renderer's defaults apply otherwise
+            const ProgressiveRenderSettings previous = m_renderer.getProgressiveSettings();
+            ProgressiveRenderSettings progressive = previous;
+            if (obj.HasMember("spp")) {
+                if (!obj["spp"].IsInt() || obj["spp"].GetInt() < 1) { error = "render_image: 'spp' must be an integer >= 1"; return false; }
+                progressive.targetSpp = obj["spp"].GetInt();
+            }
+            if (obj.HasMember("time_budget")) {
+                if (!obj["time_budget"].IsNumber() || obj["time_budget"].GetDouble() < 0.0) { error = "render_image: 'time_budget' must be seconds >= 0"; return false; }
+                progressive.timeBudgetMs = obj["time_budget"].GetDouble() * 1000.0;
+            }
+            if (obj.HasMember("noise_threshold")) {
+                if (!obj["noise_threshold"].IsNumber() || obj["noise_threshold"].GetDouble() < 0.0) { error = "render_image: 'noise_threshold' must be >= 0"; return false; }
+                progressive.noiseThreshold = static_cast<float>(obj["noise_threshold"].GetDouble());
+            }
+            if (obj.HasMember("adaptive_threshold")) {
+                if (!obj["adaptive_threshold"].IsNumber() || obj["adaptive_threshold"].GetDouble() < 0.0) { error = "render_image: 'adaptive_threshold' must be >= 0"; return false; }
+                progressive.adaptiveThreshold = static_cast<float>(obj["adaptive_threshold"].GetDouble());
+            }
+            const std::string previousDensity = m_renderer.getSampleDensityOutput();
+            std::string densityPath = previousDensity;
+            if (obj.HasMember("sample_density")) {
+                if (!obj["sample_density"].IsString()) { error = "render_image: 'sample_density' must be a path"; return false; }
+                if (!validateAndResolvePath(obj["sample_density"].GetString(), densityPath, error)) {
+                    error = "render_image: " + error;
+                    return false;
+                }
+            }
+            const RaytraceAOVOutputs previousAOVs = m_renderer.getAOVOutputs();
+            RaytraceAOVOutputs aovOutputs = previousAOVs;
+            if (obj.HasMember("aovs")) {
+                const auto& aovs = obj["aovs"];
+                if (!aovs.IsObject()) { error = "render_image: 'aovs' must be an object"; return false; }
+                const std::pair<const char*, std::string*> aovFields[] = {
+                    {"albedo", &aovOutputs.albedo},
+                    {"normal", &aovOutputs.normal},
+                    {"depth", &aovOutputs.depth},
+                    {"object_id", &aovOutputs.objectId},
+                    {"material_id", &aovOutputs.materialId}
+                };
+                for (const auto& field : aovFields) {
+                    if (!aovs.HasMember(field.first)) continue;
+                    if (!aovs[field.first].IsString()) { error = std::string("render_image: 'aovs.") + field.first + "' must be a path"; return false; }
+                    if (!validateAndResolvePath(aovs[field.first].GetString(), *field.second, error)) {
+                        error = "render_image: " + error;
+                        return false;
+                    }
+                }
+            }
+            const BVHBuildAlgorithm previousBuilder = m_renderer.getBVHBuildAlgorithm();
+            BVHBuildAlgorithm builder = previousBuilder;
+            if (obj.HasMember("bvh_builder")) {
+                if (!obj["bvh_builder"].IsString() || !parseBVHBuildAlgorithm(obj["bvh_builder"].GetString(), builder)) {
+                    error = "render_image: 'bvh_builder' must be 'sah' or 'lbvh'";
+                    return false;
+                }
+            }
+            m_renderer.setProgressiveSettings(progressive);
+            m_renderer.setSampleDensityOutput(densityPath);
+            m_renderer.setAOVOutputs(aovOutputs);
+            m_renderer.setBVHBuildAlgorithm(builder);
+
             bool ok = m_renderer.renderToPNG(m_scene, m_lights, path, width, height);
+            m_renderer.setProgressiveSettings(previous);
+            m_renderer.setSampleDensityOutput(previousDensity);
+            m_renderer.setAOVOutputs(previousAOVs);
+            m_renderer.setBVHBuildAlgorithm(previousBuilder);
             if (!ok) { error = std::string("render_image: failed to render to '") + path + "'"; return false; }
             return true;
         }
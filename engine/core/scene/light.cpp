@@ -68,54 +68,6 @@ void Light::addSpotLight(const glm::vec3& position, const glm::vec3& direction,
     m_lights.push_back(s);
 }
 
-void Light::applyLights(GLuint shaderProgram) const
-{
-    glUseProgram(shaderProgram);
-
-    // Send the global ambient
-    GLint ambientLoc = glGetUniformLocation(shaderProgram, "globalAmbient");
-    if (ambientLoc != -1)
-    {
-        glUniform4fv(ambientLoc, 1, &m_globalAmbient[0]);
-    }
-
-    GLint lightCountLoc = glGetUniformLocation(shaderProgram, "numLights");
-    if (lightCountLoc != -1)
-    {
-        glUniform1i(lightCountLoc, static_cast<int>(m_lights.size()));
-    }
-
-    for (size_t i = 0; i < m_lights.size(); i++)
-    {
-        std::string baseName = "lights[" + std::to_string(i) + "]";
-        GLint lightTypeLoc = glGetUniformLocation(shaderProgram, (baseName + ".type").c_str());
-        GLint lightPosLoc = glGetUniformLocation(shaderProgram, (baseName + ".position").c_str());
-        GLint lightDirLoc = glGetUniformLocation(shaderProgram, (baseName + ".direction").c_str());
-        GLint lightColorLoc = glGetUniformLocation(shaderProgram, (baseName + ".color").c_str());
-        GLint lightIntensityLoc = glGetUniformLocation(shaderProgram, (baseName + ".intensity").c_str());
-        GLint innerLoc = glGetUniformLocation(shaderProgram, (baseName + ".innerCutoff").c_str());
-        GLint outerLoc = glGetUniformLocation(shaderProgram, (baseName + ".outerCutoff").c_str());
-
-        float intensity = (m_lights[i].enabled) ? m_lights[i].intensity : 0.0f;
-
-        if (lightTypeLoc != -1)      glUniform1i(lightTypeLoc, static_cast<int>(m_lights[i].type));
-        if (lightPosLoc != -1)       glUniform3fv(lightPosLoc, 1, glm::value_ptr(m_lights[i].position));
-        if (lightDirLoc != -1)       glUniform3fv(lightDirLoc, 1, glm::value_ptr(m_lights[i].direction));
-        if (lightColorLoc != -1)     glUniform3fv(lightColorLoc, 1, glm::value_ptr(m_lights[i].color));
-        if (lightIntensityLoc != -1) glUniform1f(lightIntensityLoc, intensity);
-        // Spot cone angles (pass cosines of radians)
-        if (innerLoc != -1) {
-            float innerRad = glm::radians(m_lights[i].innerConeDeg);
-            glUniform1f(innerLoc, cosf(innerRad));
-        }
-        if (outerLoc != -1) {
-            float outerRad = glm::radians(m_lights[i].outerConeDeg);
-            glUniform1f(outerLoc, cosf(outerRad));
-        }
-    }
-}
-
-
 size_t Light::getLightCount() const
 {
     return m_lights.size();
@@ -20,11 +20,23 @@ struct LightSource {
     // Spot light cone angles (degrees)
     float innerConeDeg = 15.0f;
     float outerConeDeg = 25.0f;
+    // Distance at which a point/spot light fades out (glTF KHR_lights_punctual "range"); 0 = unbounded.
+    // Ranged lights are only shaded where they reach, which is what lets the raster path cull them per cluster
+    float range = 0.0f;
     
     LightSource() : type(LightType::POINT), position(0.0f), direction(0.0f, -1.0f, 0.0f), 
                     color(1.0f), intensity(1.0f), enabled(true) {}
 };
 
+// Windowing applied on top of the distance falloff of ranged lights: smooth, and exactly 0 at the range
+inline float lightRangeWindow(float distance, float range)
+{
+    if (range <= 0.0f) return 1.0f;
+    const float x = distance / range;
+    const float w = glm::clamp(1.0f - x * x * x * x, 0.0f, 1.0f);
+    return w * w;
+}
+
 class Light {
 public:
     Light();
@@ -36,7 +48,6 @@ public:
     void addSpotLight(const glm::vec3& position, const glm::vec3& direction,
                       const glm::vec3& color, float intensity,
                       float innerConeDeg, float outerConeDeg);
-    void applyLights(GLuint shaderProgram) const;
     size_t getLightCount() const;
 
     // New functions for indicator visualization
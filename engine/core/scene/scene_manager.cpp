@@ -32,6 +32,7 @@ bool SceneManager::loadObject(const std::string& name, const std::string& path,
 
     SceneObject obj;
     obj.name = name;
+    obj.id = m_nextObjectId++;
     
     // Load mesh data
     obj.objLoader.load(path.c_str());
@@ -73,7 +74,9 @@ bool SceneManager::loadObject(const std::string& name, const std::string& path,
         }
     }
     
+    const uint32_t id = obj.id;
     m_objects.push_back(std::move(obj));
+    emitChange(SceneChangeType::ObjectAdded, id);
     return true;
 }
 
@@ -134,7 +137,9 @@ bool SceneManager::removeObject(const std::string& name)
         }
     }
     
+    const uint32_t removedId = it->id;
     m_objects.erase(it);
+    emitChange(SceneChangeType::ObjectRemoved, removedId);
     return true;
 }
 
@@ -154,6 +159,7 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     
     SceneObject newObj = *source; // Copy construct
     newObj.name = newName;
+    newObj.id = m_nextObjectId++;
     
     // Apply deltas to transform
     if (deltaPos || deltaScale || deltaRotDeg) {
@@ -180,7 +186,9 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     // Setup new OpenGL resources (don't share VAO/VBO)
     setupObjectOpenGL(newObj);
     
+    const uint32_t id = newObj.id;
     m_objects.push_back(std::move(newObj));
+    emitChange(SceneChangeType::ObjectAdded, id);
     return true;
 }
 
@@ -235,6 +243,7 @@ bool SceneManager::assignMaterialToObject(const std::string& objectName, const s
     }
     
     obj->material = it->second;
+    emitChange(SceneChangeType::MaterialChanged, obj->id);
     return true;
 }
 
@@ -252,6 +261,57 @@ const SceneObject* SceneManager::findObjectByName(const std::string& name) const
     return (it != m_objects.end()) ? &(*it) : nullptr;
 }
 
+SceneObject* SceneManager::findObjectById(uint32_t id)
+{
+    auto it = std::find_if(m_objects.begin(), m_objects.end(),
+        [id](const SceneObject& obj) { return obj.id == id; });
+    return (it != m_objects.end()) ? &(*it) : nullptr;
+}
+
+const SceneObject* SceneManager::findObjectById(uint32_t id) const
+{
+    auto it = std::find_if(m_objects.begin(), m_objects.end(),
+        [id](const SceneObject& obj) { return obj.id == id; });
+    return (it != m_objects.end()) ? &(*it) : nullptr;
+}
+
+int SceneManager::addChangeListener(SceneChangeListener listener) const
+{
+    int handle = m_nextListenerHandle++;
+    m_changeListeners.emplace_back(handle, std::move(listener));
+    return handle;
+}
+
+void SceneManager::removeChangeListener(int handle) const
+{
+    m_changeListeners.erase(std::remove_if(m_changeListeners.begin(), m_changeListeners.end(),
+        [handle](const std::pair<int, SceneChangeListener>& entry) { return entry.first == handle; }),
+        m_changeListeners.end());
+}
+
+void SceneManager::notifyObjectChanged(int objectIndex, SceneChangeType type) const
+{
+    if (objectIndex < 0 || objectIndex >= static_cast<int>(m_objects.size())) {
+        return;
+    }
+    emitChange(type, m_objects[objectIndex].id);
+}
+
+void SceneManager::notifyObjectChanged(const std::string& name, SceneChangeType type) const
+{
+    notifyObjectChanged(findObjectIndex(name), type);
+}
+
+void SceneManager::emitChange(SceneChangeType type, uint32_t objectId) const
+{
+    SceneChangeEvent event;
+    event.type = type;
+    event.objectId = objectId;
+    for (const auto& entry : m_changeListeners) {
+        entry.second(event);
+    }
+}
+
 int SceneManager::findObjectIndex(const std::string& name) const
 {
     for (size_t i = 0; i < m_objects.size(); ++i) {
@@ -280,7 +340,9 @@ bool SceneManager::deleteObject(const std::string& name)
         }
         
         // Remove from vector
+        const uint32_t removedId = it->id;
         m_objects.erase(it);
+        emitChange(SceneChangeType::ObjectRemoved, removedId);
         return true;
     }
     return false;
@@ -301,6 +363,7 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     // Copy the source object
     SceneObject newObj = *source;
     newObj.name = newName;
+    newObj.id = m_nextObjectId++;
     
     // Set new position (for root objects, local = world)
     newObj.localMatrix[3] = glm::vec4(newPosition, 1.0f);
@@ -320,6 +383,7 @@ bool SceneManager::duplicateObject(const std::string& sourceName, const std::str
     // Setup OpenGL for the new object
     setupObjectOpenGL(m_objects.back());
     
+    emitChange(SceneChangeType::ObjectAdded, m_objects.back().id);
     return true;
 }
 
@@ -331,6 +395,7 @@ void SceneManager::clear()
     m_objects.clear();
     m_materials.clear();
     m_selectedObjectIndex = -1;
+    emitChange(SceneChangeType::SceneCleared, 0);
 }
 
 void SceneManager::setupObjectOpenGL(SceneObject& obj)
@@ -652,6 +717,7 @@ void SceneManager::updateWorldTransform(int objectIndex)
         const glm::mat4& parentWorld = getWorldMatrix(obj.parentIndex);
         obj.modelMatrix = parentWorld * obj.localMatrix;
     }
+    emitChange(SceneChangeType::TransformChanged, obj.id);
     
     // Recursively update all children
     for (int childIndex : obj.childIndices) {
@@ -2,6 +2,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <cstdint>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include "material.h"
@@ -13,6 +15,7 @@
 struct SceneObject
 {
     std::string name;
+    uint32_t id = 0;                      // Stable identifier; survives renames and index shifts
     GLuint   VAO = 0, VBO_positions = 0, VBO_normals = 0, VBO_uvs = 0, VBO_tangents = 0, EBO = 0;
     glm::mat4 modelMatrix{ 1.0f };        // World transform (computed from hierarchy)
     
@@ -38,6 +41,24 @@ struct SceneObject
     float ior = 1.5f;                 // Index of refraction for F0 computation
 };
 
+// Kinds of edits reported to scene change listeners
+enum class SceneChangeType
+{
+    ObjectAdded,
+    ObjectRemoved,
+    TransformChanged,
+    MaterialChanged,
+    SceneCleared
+};
+
+struct SceneChangeEvent
+{
+    SceneChangeType type = SceneChangeType::ObjectAdded;
+    uint32_t objectId = 0;                // SceneObject::id; 0 for SceneCleared
+};
+
+using SceneChangeListener = std::function<void(const SceneChangeEvent&)>;
+
 class SceneManager 
 {
 public:
@@ -84,8 +105,18 @@ public:
     SceneObject* findObjectByName(const std::string& name);
     const SceneObject* findObjectByName(const std::string& name) const;
     int findObjectIndex(const std::string& name) const;
+    SceneObject* findObjectById(uint32_t id);
+    const SceneObject* findObjectById(uint32_t id) const;
     bool deleteObject(const std::string& name);
 
+    // Change notifications. Listeners are observers rather than scene state, so they can be
+    // registered through a const reference. Code that edits SceneObject fields directly must
+    // call notifyObjectChanged so caches (e.g. the raytracer scene) stay in sync.
+    int addChangeListener(SceneChangeListener listener) const;
+    void removeChangeListener(int handle) const;
+    void notifyObjectChanged(int objectIndex, SceneChangeType type) const;
+    void notifyObjectChanged(const std::string& name, SceneChangeType type) const;
+
     // Serialization
     std::string toJson() const;
     bool fromJson(const std::string& json);
@@ -97,7 +128,12 @@ private:
     std::vector<SceneObject> m_objects;
     std::unordered_map<std::string, Material> m_materials;
     int m_selectedObjectIndex = -1;
+    uint32_t m_nextObjectId = 1;
+
+    mutable std::vector<std::pair<int, SceneChangeListener>> m_changeListeners;
+    mutable int m_nextListenerHandle = 1;
 
+    void emitChange(SceneChangeType type, uint32_t objectId) const;
     void setupObjectOpenGL(SceneObject& obj);
     void cleanupObjectOpenGL(SceneObject& obj);
 };
\ No newline at end of file
@@ -0,0 +1,834 @@
+#include "bvh_builder.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <glm/glm.hpp>
+
+namespace
+{
+    // Past this depth splits fall back to object medians so the tree always fits the
+    // fixed traversal stack in LinearBVH.
+    constexpr int kMaxSAHDepth = 64;
+
+    // Ranges larger than this are split by all threads together; smaller ones become subtrees
+    // built by a single thread. Sizes are fixed rather than derived from the thread count so the
+    // output is the same on every machine.
+    constexpr size_t kSubtreeSize = 32 * 1024;
+
+    // Unit of work of the cooperative passes (binning, partitioning, sorting)
+    constexpr size_t kChunkSize = 16 * 1024;
+
+    // Per-primitive data computed once up front so the recursion never touches geometry
+    struct BuildPrim
+    {
+        AABB bounds;
+        glm::vec3 centroid{0.0f};
+    };
+
+    struct Bin
+    {
+        AABB bounds;
+        int count = 0;
+    };
+
+    // Runs fn(index) for every index in [0, count), spread over the pool when there is one
+    template <typename Fn>
+    void forEach(ThreadPool* pool, size_t count, const Fn& fn)
+    {
+        if (!pool)
+        {
+            for (size_t i = 0; i < count; ++i)
+                fn(i);
+            return;
+        }
+        pool->parallelFor(static_cast<uint32_t>(count), [&](uint32_t index, unsigned) { fn(index); });
+    }
+
+    size_t chunkCount(size_t count)
+    {
+        return (count + kChunkSize - 1) / kChunkSize;
+    }
+
+    void fillBuildPrims(ThreadPool* pool, const std::vector<AABB>& primBounds,
+                        std::vector<BuildPrim>& prims, std::vector<uint32_t>& indices)
+    {
+        prims.resize(primBounds.size());
+        indices.resize(primBounds.size());
+        forEach(pool, chunkCount(primBounds.size()), [&](size_t chunk) {
+            const size_t end = std::min(primBounds.size(), (chunk + 1) * kChunkSize);
+            for (size_t i = chunk * kChunkSize; i < end; ++i)
+            {
+                prims[i].bounds = primBounds[i];
+                prims[i].centroid = primBounds[i].center();
+                indices[i] = static_cast<uint32_t>(i);
+            }
+        });
+    }
+
+    // Builder parameters after clamping, plus the SAH cost model
+    struct BuildParams
+    {
+        int maxLeafSize = 4;
+        int binCount = 16;
+        float traversalCost = 1.0f;
+        float intersectionCost = 1.0f;
+        int packetWidth = 1;
+
+        explicit BuildParams(const BVHBuildSettings& settings)
+        {
+            maxLeafSize = std::min(std::max(1, settings.maxLeafSize), 0xFFFF);
+            binCount = std::max(2, settings.binCount);
+            traversalCost = settings.traversalCost;
+            intersectionCost = settings.intersectionCost;
+            packetWidth = std::max(1, settings.packetWidth);
+        }
+
+        // Leaf kernels test packetWidth primitives at once, so partially filled packets cost the same
+        float packets(int count) const
+        {
+            return static_cast<float>((count + packetWidth - 1) / packetWidth);
+        }
+
+        int binIndex(float c, float cmin, float scale) const
+        {
+            int b = static_cast<int>((c - cmin) * scale);
+            return std::min(std::max(b, 0), binCount - 1);
+        }
+    };
+
+    struct SplitChoice
+    {
+        int axis = -1;
+        int split = 0;
+        float cost = FLT_MAX;
+    };
+
+    // Scores the planes between the filled bins of one axis and keeps the cheapest in best.
+    // rightArea and rightCount are scratch arrays of binCount entries.
+    void scoreAxis(const BuildParams& params, const Bin* bins, int axis,
+                   float* rightArea, int* rightCount, SplitChoice& best)
+    {
+        // Sweep right-to-left to accumulate the right-hand side of each candidate plane
+        AABB accum;
+        int accumCount = 0;
+        for (int b = params.binCount - 1; b > 0; --b)
+        {
+            accum.grow(bins[b].bounds);
+            accumCount += bins[b].count;
+            rightArea[b] = accum.surfaceArea();
+            rightCount[b] = accumCount;
+        }
+
+        // Sweep left-to-right and score split planes between bin b-1 and b
+        accum = AABB();
+        accumCount = 0;
+        for (int b = 1; b < params.binCount; ++b)
+        {
+            accum.grow(bins[b - 1].bounds);
+            accumCount += bins[b - 1].count;
+            if (accumCount == 0 || rightCount[b] == 0)
+                continue;
+            float cost = accum.surfaceArea() * params.packets(accumCount) + rightArea[b] * params.packets(rightCount[b]);
+            if (cost < best.cost)
+            {
+                best.cost = cost;
+                best.axis = axis;
+                best.split = b;
+            }
+        }
+    }
+
+    int widestAxis(const glm::vec3& extent)
+    {
+        int axis = 0;
+        if (extent.y > extent.x) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+        return axis;
+    }
+
+    // Builds the subtree over one index range on the calling thread, appending nodes depth-first
+    class BinnedSAHBuilder
+    {
+    public:
+        BinnedSAHBuilder(const BuildParams& params,
+                         const std::vector<BuildPrim>& prims,
+                         std::vector<uint32_t>& indices,
+                         std::vector<LinearBVHNode>& nodes,
+                         BVHBuildStats& stats)
+            : m_params(params), m_prims(prims), m_indices(indices), m_nodes(nodes), m_stats(stats)
+        {
+            m_bins.resize(m_params.binCount);
+            m_rightArea.resize(m_params.binCount);
+            m_rightCount.resize(m_params.binCount);
+        }
+
+        // Nodes are appended depth-first: the first child always follows its parent
+        uint32_t buildRange(size_t begin, size_t end, int depth)
+        {
+            const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_stats.nodeCount++;
+
+            AABB bounds, centroidBounds;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const BuildPrim& prim = m_prims[m_indices[i]];
+                bounds.grow(prim.bounds);
+                centroidBounds.grow(prim.centroid);
+            }
+            m_nodes[nodeIndex].boundsMin = bounds.min;
+            m_nodes[nodeIndex].boundsMax = bounds.max;
+
+            const size_t count = end - begin;
+            if (count == 1)
+            {
+                makeLeaf(nodeIndex, begin, end, depth);
+                return nodeIndex;
+            }
+
+            // Evaluate binned SAH splits on every axis with a non-degenerate centroid extent
+            SplitChoice best;
+            const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+
+            for (int axis = 0; axis < 3 && depth < kMaxSAHDepth; ++axis)
+            {
+                if (extent[axis] <= 1e-12f)
+                    continue;
+
+                std::fill(m_bins.begin(), m_bins.end(), Bin());
+                const float scale = m_params.binCount / extent[axis];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const BuildPrim& prim = m_prims[m_indices[i]];
+                    int b = m_params.binIndex(prim.centroid[axis], centroidBounds.min[axis], scale);
+                    m_bins[b].count++;
+                    m_bins[b].bounds.grow(prim.bounds);
+                }
+                scoreAxis(m_params, m_bins.data(), axis, m_rightArea.data(), m_rightCount.data(), best);
+            }
+
+            // Small nodes become leaves unless the SAH says splitting is cheaper; larger nodes
+            // are always split so leaf size stays bounded by maxLeafSize.
+            if (count <= static_cast<size_t>(m_params.maxLeafSize))
+            {
+                const float parentArea = std::max(bounds.surfaceArea(), 1e-12f);
+                const float splitCost = m_params.traversalCost + m_params.intersectionCost * best.cost / parentArea;
+                const float leafCost = m_params.intersectionCost * m_params.packets(static_cast<int>(count));
+                if (best.axis < 0 || leafCost <= splitCost)
+                {
+                    makeLeaf(nodeIndex, begin, end, depth);
+                    return nodeIndex;
+                }
+            }
+
+            size_t mid = begin;
+            int splitAxis = best.axis;
+            if (best.axis >= 0)
+            {
+                const int axis = best.axis;
+                const float scale = m_params.binCount / extent[axis];
+                const float cmin = centroidBounds.min[axis];
+                auto it = std::partition(m_indices.begin() + begin, m_indices.begin() + end,
+                    [&](uint32_t idx) {
+                        return m_params.binIndex(m_prims[idx].centroid[axis], cmin, scale) < best.split;
+                    });
+                mid = static_cast<size_t>(it - m_indices.begin());
+            }
+
+            // Degenerate centroids, very deep trees, or a split that failed to separate anything:
+            // fall back to an object median on the widest axis so recursion always makes progress.
+            if (mid == begin || mid == end)
+            {
+                splitAxis = widestAxis(extent);
+                mid = begin + count / 2;
+                std::nth_element(m_indices.begin() + begin, m_indices.begin() + mid, m_indices.begin() + end,
+                    [&](uint32_t a, uint32_t b) { return m_prims[a].centroid[splitAxis] < m_prims[b].centroid[splitAxis]; });
+            }
+
+            buildRange(begin, mid, depth + 1);
+            const uint32_t second = buildRange(mid, end, depth + 1);
+
+            LinearBVHNode& node = m_nodes[nodeIndex];
+            node.offset = second;
+            node.axis = static_cast<uint8_t>(splitAxis);
+            return nodeIndex;
+        }
+
+    private:
+        const BuildParams& m_params;
+        const std::vector<BuildPrim>& m_prims;
+        std::vector<uint32_t>& m_indices;
+        std::vector<LinearBVHNode>& m_nodes;
+        BVHBuildStats& m_stats;
+
+        // Scratch storage reused by every node's split search
+        std::vector<Bin> m_bins;
+        std::vector<float> m_rightArea;
+        std::vector<int> m_rightCount;
+
+        void makeLeaf(uint32_t nodeIndex, size_t begin, size_t end, int depth)
+        {
+            LinearBVHNode& node = m_nodes[nodeIndex];
+            node.offset = static_cast<uint32_t>(begin);
+            node.primCount = static_cast<uint16_t>(end - begin);
+            m_stats.leafCount++;
+            m_stats.maxDepth = std::max(m_stats.maxDepth, depth);
+        }
+    };
+
+    // Upper levels of a parallel build: interior nodes created while splitting cooperatively,
+    // and the subtrees below them that are built one per thread and spliced in afterwards.
+    class SubtreeSplicer
+    {
+    public:
+        struct Task
+        {
+            size_t begin = 0;
+            size_t end = 0;
+            int depth = 0;
+            std::vector<LinearBVHNode> nodes;  ///< Interior offsets are local to this array.
+            BVHBuildStats stats;
+        };
+
+        uint32_t addInterior()
+        {
+            m_upper.emplace_back();
+            return static_cast<uint32_t>(m_upper.size() - 1);
+        }
+
+        uint32_t addTask(size_t begin, size_t end, int depth)
+        {
+            UpperNode node;
+            node.task = static_cast<int32_t>(m_tasks.size());
+            m_upper.push_back(node);
+            Task task;
+            task.begin = begin;
+            task.end = end;
+            task.depth = depth;
+            m_tasks.push_back(std::move(task));
+            return static_cast<uint32_t>(m_upper.size() - 1);
+        }
+
+        void setChildren(uint32_t node, uint32_t left, uint32_t right, int axis)
+        {
+            m_upper[node].left = left;
+            m_upper[node].right = right;
+            m_upper[node].axis = static_cast<uint8_t>(axis);
+        }
+
+        // Runs build(task) for every subtree, largest first so no thread is left with a big one at the end
+        template <typename Fn>
+        void buildTasks(ThreadPool* pool, const Fn& build)
+        {
+            std::vector<uint32_t> order(m_tasks.size());
+            for (uint32_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return m_tasks[a].end - m_tasks[a].begin > m_tasks[b].end - m_tasks[b].begin;
+            });
+            forEach(pool, order.size(), [&](size_t i) { build(m_tasks[order[i]]); });
+        }
+
+        // Emits the upper nodes and the subtrees in depth-first order; upper bounds are the union of their children
+        void flatten(std::vector<LinearBVHNode>& out, BVHBuildStats& stats) const
+        {
+            size_t total = m_upper.size();
+            for (const Task& task : m_tasks)
+                total += task.nodes.size();
+            out.clear();
+            out.reserve(total);
+            emit(0, out);
+
+            stats.nodeCount = out.size();
+            for (const Task& task : m_tasks)
+            {
+                stats.leafCount += task.stats.leafCount;
+                stats.maxDepth = std::max(stats.maxDepth, task.stats.maxDepth);
+            }
+        }
+
+    private:
+        struct UpperNode
+        {
+            uint32_t left = 0;
+            uint32_t right = 0;
+            int32_t task = -1;   ///< Subtree standing in for this node, or -1 for an interior node.
+            uint8_t axis = 0;
+        };
+
+        std::vector<UpperNode> m_upper;
+        std::vector<Task> m_tasks;
+
+        uint32_t emit(uint32_t upperIndex, std::vector<LinearBVHNode>& out) const
+        {
+            const UpperNode& upper = m_upper[upperIndex];
+            const uint32_t index = static_cast<uint32_t>(out.size());
+            if (upper.task >= 0)
+            {
+                for (LinearBVHNode node : m_tasks[upper.task].nodes)
+                {
+                    if (!node.isLeaf())
+                        node.offset += index;
+                    out.push_back(node);
+                }
+                return index;
+            }
+
+            out.emplace_back();
+            const uint32_t first = emit(upper.left, out);
+            const uint32_t second = emit(upper.right, out);
+            LinearBVHNode& node = out[index];
+            node.boundsMin = glm::min(out[first].boundsMin, out[second].boundsMin);
+            node.boundsMax = glm::max(out[first].boundsMax, out[second].boundsMax);
+            node.offset = second;
+            node.axis = upper.axis;
+            return index;
+        }
+    };
+
+    // Splits ranges above kSubtreeSize with every thread working on the same level: bounds,
+    // bins and partitions are computed per fixed-size chunk and reduced in chunk order, so the
+    // chosen planes are exactly those of the serial builder.
+    void splitUpperLevelsSAH(ThreadPool* pool, const BuildParams& params, const std::vector<BuildPrim>& prims,
+                             std::vector<uint32_t>& indices, SubtreeSplicer& splicer)
+    {
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+            int depth;
+            uint32_t node;
+        };
+        struct Chunk
+        {
+            size_t range;
+            size_t begin;
+            size_t end;
+        };
+
+        const size_t limit = std::max(kSubtreeSize, static_cast<size_t>(params.maxLeafSize));
+        const auto place = [&](size_t begin, size_t end, int depth, std::vector<Range>& frontier) {
+            if (end - begin <= limit)
+                return splicer.addTask(begin, end, depth);
+            const uint32_t node = splicer.addInterior();
+            frontier.push_back({begin, end, depth, node});
+            return node;
+        };
+
+        std::vector<Range> frontier;
+        place(0, indices.size(), 0, frontier);
+
+        const int binCount = params.binCount;
+        const size_t binsPerChunk = 3 * static_cast<size_t>(binCount);
+        std::vector<uint32_t> scratch;
+        std::vector<Bin> merged(binsPerChunk);
+        std::vector<float> rightArea(binCount);
+        std::vector<int> rightCount(binCount);
+
+        while (!frontier.empty())
+        {
+            std::vector<Chunk> chunks;
+            for (size_t r = 0; r < frontier.size(); ++r)
+            {
+                for (size_t begin = frontier[r].begin; begin < frontier[r].end; begin += kChunkSize)
+                    chunks.push_back({r, begin, std::min(frontier[r].end, begin + kChunkSize)});
+            }
+
+            // Centroid bounds of each range
+            std::vector<AABB> chunkCentroids(chunks.size());
+            forEach(pool, chunks.size(), [&](size_t c) {
+                for (size_t i = chunks[c].begin; i < chunks[c].end; ++i)
+                    chunkCentroids[c].grow(prims[indices[i]].centroid);
+            });
+            std::vector<AABB> centroidBounds(frontier.size());
+            for (size_t c = 0; c < chunks.size(); ++c)
+                centroidBounds[chunks[c].range].grow(chunkCentroids[c]);
+
+            // Bins of every axis per chunk, then merged per range
+            std::vector<Bin> chunkBins(chunks.size() * binsPerChunk);
+            forEach(pool, chunks.size(), [&](size_t c) {
+                const AABB& cb = centroidBounds[chunks[c].range];
+                const glm::vec3 extent = cb.max - cb.min;
+                Bin* bins = &chunkBins[c * binsPerChunk];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (extent[axis] <= 1e-12f)
+                        continue;
+                    const float scale = binCount / extent[axis];
+                    Bin* axisBins = bins + axis * binCount;
+                    for (size_t i = chunks[c].begin; i < chunks[c].end; ++i)
+                    {
+                        const BuildPrim& prim = prims[indices[i]];
+                        int b = params.binIndex(prim.centroid[axis], cb.min[axis], scale);
+                        axisBins[b].count++;
+                        axisBins[b].bounds.grow(prim.bounds);
+                    }
+                }
+            });
+
+            std::vector<SplitChoice> choices(frontier.size());
+            size_t firstChunk = 0;
+            for (size_t r = 0; r < frontier.size(); ++r)
+            {
+                std::fill(merged.begin(), merged.end(), Bin());
+                size_t c = firstChunk;
+                for (; c < chunks.size() && chunks[c].range == r; ++c)
+                {
+                    for (size_t b = 0; b < binsPerChunk; ++b)
+                    {
+                        merged[b].count += chunkBins[c * binsPerChunk + b].count;
+                        merged[b].bounds.grow(chunkBins[c * binsPerChunk + b].bounds);
+                    }
+                }
+                firstChunk = c;
+
+                const glm::vec3 extent = centroidBounds[r].max - centroidBounds[r].min;
+                for (int axis = 0; axis < 3 && frontier[r].depth < kMaxSAHDepth; ++axis)
+                {
+                    if (extent[axis] > 1e-12f)
+                        scoreAxis(params, &merged[axis * binCount], axis, rightArea.data(), rightCount.data(), choices[r]);
+                }
+            }
+
+            // Stable partition: count each chunk's left side, then scatter both sides through scratch
+            const auto goesLeft = [&](size_t range, uint32_t idx) {
+                const SplitChoice& choice = choices[range];
+                const AABB& cb = centroidBounds[range];
+                const float scale = binCount / (cb.max[choice.axis] - cb.min[choice.axis]);
+                return params.binIndex(prims[idx].centroid[choice.axis], cb.min[choice.axis], scale) < choice.split;
+            };
+            std::vector<size_t> chunkLeft(chunks.size(), 0);
+            forEach(pool, chunks.size(), [&](size_t c) {
+                if (choices[chunks[c].range].axis < 0)
+                    return;
+                for (size_t i = chunks[c].begin; i < chunks[c].end; ++i)
+                    chunkLeft[c] += goesLeft(chunks[c].range, indices[i]) ? 1 : 0;
+            });
+
+            std::vector<size_t> leftCursor(chunks.size()), rightCursor(chunks.size());
+            std::vector<size_t> mids(frontier.size());
+            for (size_t r = 0, c = 0; r < frontier.size(); ++r)
+            {
+                const size_t first = c;
+                size_t leftTotal = 0;
+                for (; c < chunks.size() && chunks[c].range == r; ++c)
+                    leftTotal += chunkLeft[c];
+                mids[r] = frontier[r].begin + leftTotal;
+                size_t left = frontier[r].begin, right = mids[r];
+                for (size_t k = first; k < c; ++k)
+                {
+                    leftCursor[k] = left;
+                    rightCursor[k] = right;
+                    left += chunkLeft[k];
+                    right += (chunks[k].end - chunks[k].begin) - chunkLeft[k];
+                }
+            }
+
+            scratch.resize(indices.size());
+            forEach(pool, chunks.size(), [&](size_t c) {
+                if (choices[chunks[c].range].axis < 0)
+                    return;
+                size_t left = leftCursor[c], right = rightCursor[c];
+                for (size_t i = chunks[c].begin; i < chunks[c].end; ++i)
+                {
+                    const uint32_t idx = indices[i];
+                    scratch[goesLeft(chunks[c].range, idx) ? left++ : right++] = idx;
+                }
+            });
+            forEach(pool, chunks.size(), [&](size_t c) {
+                if (choices[chunks[c].range].axis >= 0)
+                    std::copy(scratch.begin() + chunks[c].begin, scratch.begin() + chunks[c].end, indices.begin() + chunks[c].begin);
+            });
+
+            std::vector<Range> next;
+            for (size_t r = 0; r < frontier.size(); ++r)
+            {
+                const Range range = frontier[r];
+                size_t mid = choices[r].axis >= 0 ? mids[r] : range.begin;
+                int splitAxis = choices[r].axis;
+                if (mid == range.begin || mid == range.end)
+                {
+                    // Same object-median fallback as the serial builder
+                    const glm::vec3 extent = centroidBounds[r].max - centroidBounds[r].min;
+                    splitAxis = widestAxis(extent);
+                    mid = range.begin + (range.end - range.begin) / 2;
+                    std::nth_element(indices.begin() + range.begin, indices.begin() + mid, indices.begin() + range.end,
+                        [&](uint32_t a, uint32_t b) { return prims[a].centroid[splitAxis] < prims[b].centroid[splitAxis]; });
+                }
+                const uint32_t left = place(range.begin, mid, range.depth + 1, next);
+                const uint32_t right = place(mid, range.end, range.depth + 1, next);
+                splicer.setChildren(range.node, left, right, splitAxis);
+            }
+            frontier.swap(next);
+        }
+    }
+
+    // Spreads the ten bits of v so that bit i lands on bit 3i
+    uint32_t expandBits(uint32_t v)
+    {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    // 30-bit code with x in the highest bit of every triplet; p is normalized to [0, 1]
+    uint32_t mortonCode(const glm::vec3& p)
+    {
+        const glm::vec3 q = glm::clamp(p * 1024.0f, glm::vec3(0.0f), glm::vec3(1023.0f));
+        return (expandBits(static_cast<uint32_t>(q.x)) << 2) |
+               (expandBits(static_cast<uint32_t>(q.y)) << 1) |
+               expandBits(static_cast<uint32_t>(q.z));
+    }
+
+    // Stable LSD radix sort of codes (30 bits used) carrying values along, 8 bits per pass
+    void radixSort(ThreadPool* pool, std::vector<uint32_t>& codes, std::vector<uint32_t>& values)
+    {
+        const size_t count = codes.size();
+        const size_t chunks = chunkCount(count);
+        std::vector<uint32_t> codesOut(count), valuesOut(count);
+        std::vector<size_t> offsets(chunks * 256);
+
+        for (int shift = 0; shift < 30; shift += 8)
+        {
+            forEach(pool, chunks, [&](size_t c) {
+                size_t* histogram = &offsets[c * 256];
+                std::fill(histogram, histogram + 256, 0);
+                const size_t end = std::min(count, (c + 1) * kChunkSize);
+                for (size_t i = c * kChunkSize; i < end; ++i)
+                    histogram[(codes[i] >> shift) & 0xFF]++;
+            });
+
+            // Digit-major prefix sum: each chunk writes its share of a digit after earlier chunks
+            size_t running = 0;
+            for (size_t digit = 0; digit < 256; ++digit)
+            {
+                for (size_t c = 0; c < chunks; ++c)
+                {
+                    const size_t n = offsets[c * 256 + digit];
+                    offsets[c * 256 + digit] = running;
+                    running += n;
+                }
+            }
+
+            forEach(pool, chunks, [&](size_t c) {
+                size_t* cursor = &offsets[c * 256];
+                const size_t end = std::min(count, (c + 1) * kChunkSize);
+                for (size_t i = c * kChunkSize; i < end; ++i)
+                {
+                    const size_t dst = cursor[(codes[i] >> shift) & 0xFF]++;
+                    codesOut[dst] = codes[i];
+                    valuesOut[dst] = values[i];
+                }
+            });
+            codes.swap(codesOut);
+            values.swap(valuesOut);
+        }
+    }
+
+    // Splits a sorted range where the highest differing code bit flips; axis receives the
+    // dimension of that bit, or -1 when all codes are equal and the range is simply halved.
+    size_t mortonSplit(const std::vector<uint32_t>& codes, size_t begin, size_t end, int& axis)
+    {
+        const uint32_t diff = codes[begin] ^ codes[end - 1];
+        if (diff == 0)
+        {
+            axis = -1;
+            return begin + (end - begin) / 2;
+        }
+        int bit = 29;
+        while (((diff >> bit) & 1u) == 0)
+            --bit;
+        axis = 2 - bit % 3;
+        // Codes in the range share every bit above this one, so those with it set form a suffix
+        const auto it = std::partition_point(codes.begin() + begin, codes.begin() + end,
+                                             [&](uint32_t code) { return ((code >> bit) & 1u) == 0; });
+        return static_cast<size_t>(it - codes.begin());
+    }
+
+    // Builds the subtree over one Morton-sorted range on the calling thread; bounds are computed bottom-up
+    class MortonSubtreeBuilder
+    {
+    public:
+        MortonSubtreeBuilder(const BuildParams& params,
+                             const std::vector<BuildPrim>& prims,
+                             const std::vector<uint32_t>& indices,
+                             const std::vector<uint32_t>& codes,
+                             std::vector<LinearBVHNode>& nodes,
+                             BVHBuildStats& stats)
+            : m_params(params), m_prims(prims), m_indices(indices), m_codes(codes), m_nodes(nodes), m_stats(stats)
+        {
+        }
+
+        uint32_t buildRange(size_t begin, size_t end, int depth)
+        {
+            const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+            m_stats.nodeCount++;
+
+            if (end - begin <= static_cast<size_t>(m_params.maxLeafSize))
+            {
+                AABB bounds;
+                for (size_t i = begin; i < end; ++i)
+                    bounds.grow(m_prims[m_indices[i]].bounds);
+                LinearBVHNode& node = m_nodes[nodeIndex];
+                node.boundsMin = bounds.min;
+                node.boundsMax = bounds.max;
+                node.offset = static_cast<uint32_t>(begin);
+                node.primCount = static_cast<uint16_t>(end - begin);
+                m_stats.leafCount++;
+                m_stats.maxDepth = std::max(m_stats.maxDepth, depth);
+                return nodeIndex;
+            }
+
+            int axis = 0;
+            const size_t mid = mortonSplit(m_codes, begin, end, axis);
+            buildRange(begin, mid, depth + 1);
+            const uint32_t second = buildRange(mid, end, depth + 1);
+
+            LinearBVHNode& node = m_nodes[nodeIndex];
+            const LinearBVHNode& first = m_nodes[nodeIndex + 1];
+            node.boundsMin = glm::min(first.boundsMin, m_nodes[second].boundsMin);
+            node.boundsMax = glm::max(first.boundsMax, m_nodes[second].boundsMax);
+            node.offset = second;
+            node.axis = static_cast<uint8_t>(axis >= 0 ? axis : widestAxis(node.boundsMax - node.boundsMin));
+            return nodeIndex;
+        }
+
+    private:
+        const BuildParams& m_params;
+        const std::vector<BuildPrim>& m_prims;
+        const std::vector<uint32_t>& m_indices;
+        const std::vector<uint32_t>& m_codes;
+        std::vector<LinearBVHNode>& m_nodes;
+        BVHBuildStats& m_stats;
+    };
+
+    // Splitting a sorted range is a binary search, so the upper levels need no cooperation
+    uint32_t splitUpperLevelsMorton(const BuildParams& params, const std::vector<uint32_t>& codes,
+                                    size_t begin, size_t end, int depth, SubtreeSplicer& splicer)
+    {
+        const size_t limit = std::max(kSubtreeSize, static_cast<size_t>(params.maxLeafSize));
+        if (end - begin <= limit)
+            return splicer.addTask(begin, end, depth);
+
+        const uint32_t node = splicer.addInterior();
+        int axis = 0;
+        const size_t mid = mortonSplit(codes, begin, end, axis);
+        const uint32_t left = splitUpperLevelsMorton(params, codes, begin, mid, depth + 1, splicer);
+        const uint32_t right = splitUpperLevelsMorton(params, codes, mid, end, depth + 1, splicer);
+        splicer.setChildren(node, left, right, axis >= 0 ? axis : 0);
+        return node;
+    }
+}
+
+void buildBVH(const std::vector<AABB>& primBounds,
+              const BVHBuildSettings& settings,
+              LinearBVH& out,
+              BVHBuildStats& stats,
+              ThreadPool* pool)
+{
+    if (settings.algorithm == BVHBuildAlgorithm::LBVH)
+        buildBVHLinear(primBounds, settings, out, stats, pool);
+    else
+        buildBVHBinnedSAH(primBounds, settings, out, stats, pool);
+}
+
+void buildBVHBinnedSAH(const std::vector<AABB>& primBounds,
+                       const BVHBuildSettings& settings,
+                       LinearBVH& out,
+                       BVHBuildStats& stats,
+                       ThreadPool* pool)
+{
+    auto start = std::chrono::steady_clock::now();
+    stats = BVHBuildStats();
+    stats.primitiveCount = primBounds.size();
+    out.clear();
+
+    if (!primBounds.empty())
+    {
+        const BuildParams params(settings);
+        std::vector<BuildPrim> prims;
+        std::vector<uint32_t> indices;
+        fillBuildPrims(pool, primBounds, prims, indices);
+
+        if (!pool)
+        {
+            out.nodes.reserve(indices.size() * 2);
+            BinnedSAHBuilder builder(params, prims, indices, out.nodes, stats);
+            builder.buildRange(0, indices.size(), 0);
+        }
+        else
+        {
+            SubtreeSplicer splicer;
+            splitUpperLevelsSAH(pool, params, prims, indices, splicer);
+            splicer.buildTasks(pool, [&](SubtreeSplicer::Task& task) {
+                task.nodes.reserve((task.end - task.begin) * 2);
+                BinnedSAHBuilder builder(params, prims, indices, task.nodes, task.stats);
+                builder.buildRange(task.begin, task.end, task.depth);
+            });
+            splicer.flatten(out.nodes, stats);
+        }
+        out.primIndices = std::move(indices);
+    }
+
+    stats.buildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void buildBVHLinear(const std::vector<AABB>& primBounds,
+                    const BVHBuildSettings& settings,
+                    LinearBVH& out,
+                    BVHBuildStats& stats,
+                    ThreadPool* pool)
+{
+    auto start = std::chrono::steady_clock::now();
+    stats = BVHBuildStats();
+    stats.primitiveCount = primBounds.size();
+    out.clear();
+
+    if (!primBounds.empty())
+    {
+        const BuildParams params(settings);
+        std::vector<BuildPrim> prims;
+        std::vector<uint32_t> indices;
+        fillBuildPrims(pool, primBounds, prims, indices);
+
+        // Codes quantize centroids within the centroid bounds of the whole input
+        const size_t chunks = chunkCount(prims.size());
+        std::vector<AABB> chunkCentroids(chunks);
+        forEach(pool, chunks, [&](size_t c) {
+            const size_t end = std::min(prims.size(), (c + 1) * kChunkSize);
+            for (size_t i = c * kChunkSize; i < end; ++i)
+                chunkCentroids[c].grow(prims[i].centroid);
+        });
+        AABB centroidBounds;
+        for (const AABB& bounds : chunkCentroids)
+            centroidBounds.grow(bounds);
+        const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+        const glm::vec3 scale(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                              extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                              extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+        std::vector<uint32_t> codes(prims.size());
+        forEach(pool, chunks, [&](size_t c) {
+            const size_t end = std::min(prims.size(), (c + 1) * kChunkSize);
+            for (size_t i = c * kChunkSize; i < end; ++i)
+                codes[i] = mortonCode((prims[i].centroid - centroidBounds.min) * scale);
+        });
+        radixSort(pool, codes, indices);
+
+        SubtreeSplicer splicer;
+        splitUpperLevelsMorton(params, codes, 0, indices.size(), 0, splicer);
+        splicer.buildTasks(pool, [&](SubtreeSplicer::Task& task) {
+            task.nodes.reserve((task.end - task.begin) * 2 / static_cast<size_t>(params.maxLeafSize) + 1);
+            MortonSubtreeBuilder builder(params, prims, indices, codes, task.nodes, task.stats);
+            builder.buildRange(task.begin, task.end, task.depth);
+        });
+        splicer.flatten(out.nodes, stats);
+        out.primIndices = std::move(indices);
+    }
+
+    stats.buildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
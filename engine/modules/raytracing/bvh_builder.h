@@ -0,0 +1,116 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/bvh_builder.h","purpose":"Declares the BVH builders (binned SAH and Morton-code LBVH) that flatten a BVH over arbitrary primitive bounds.","exports":["BVHBuildAlgorithm","BVHBuildSettings","BVHBuildStats","buildBVH","buildBVHBinnedSAH","buildBVHLinear","bvhBuildAlgorithmName","parseBVHBuildAlgorithm"],"depends_on":["linear_bvh.h","<string>","<vector>"],"notes":["binned_surface_area_heuristic","morton_code_linear_bvh","parallel_radix_sort","optional_thread_pool","output_independent_of_thread_count","tunable_leaf_size_and_bins","reports_build_time","geometry_agnostic_input"]}
+// Human Summary
+// Surface-area-heuristic BVH construction with centroid binning for final renders, and a faster Morton-ordered builder for previews; both can spread the work over the raytracer's thread pool. Invoked from Raytracer::commit after all models are loaded.
+
+#pragma once
+/// @file bvh_builder.h
+/// @brief BVH construction for the CPU ray tracer.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "linear_bvh.h"
+
+class ThreadPool;
+
+/// @brief Algorithm used to build a hierarchy.
+enum class BVHBuildAlgorithm
+{
+    BinnedSAH, ///< Top-down binned SAH; slower to build, fastest to trace. For final renders.
+    LBVH       ///< Primitives sorted along a Morton curve and split on code bits; builds several times faster, traces slower. For previews.
+};
+
+/// @brief Tunable parameters for the BVH builders.
+struct BVHBuildSettings
+{
+    BVHBuildAlgorithm algorithm = BVHBuildAlgorithm::BinnedSAH; ///< Builder to run; the cost model below only steers BinnedSAH.
+    int maxLeafSize = 4;           ///< Upper bound on triangles per leaf; smaller nodes split only when the SAH favours it.
+    int binCount = 16;             ///< Centroid bins evaluated per axis when searching for a split.
+    float traversalCost = 1.0f;    ///< Relative cost of visiting an interior node.
+    float intersectionCost = 1.0f; ///< Relative cost of one primitive test, or of one packet when packetWidth > 1.
+    int packetWidth = 1;           ///< Primitives tested together by the leaf kernel; leaf cost is charged per packet.
+
+    bool operator==(const BVHBuildSettings& other) const
+    {
+        return algorithm == other.algorithm && maxLeafSize == other.maxLeafSize && binCount == other.binCount &&
+               traversalCost == other.traversalCost && intersectionCost == other.intersectionCost &&
+               packetWidth == other.packetWidth;
+    }
+    bool operator!=(const BVHBuildSettings& other) const { return !(*this == other); }
+};
+
+/// @brief Statistics captured by the most recent BVH build.
+struct BVHBuildStats
+{
+    double buildTimeMs = 0.0;     ///< Wall-clock time spent building the tree.
+    size_t primitiveCount = 0;    ///< Triangles referenced by the tree.
+    size_t nodeCount = 0;         ///< Total interior and leaf nodes.
+    size_t leafCount = 0;         ///< Leaf nodes only.
+    int maxDepth = 0;             ///< Deepest leaf level (root is depth 0).
+};
+
+/// @brief Builds a flattened BVH with the algorithm selected in @p settings.
+/// @param primBounds One bounding box per primitive; leaves reference primitives by index.
+/// @param settings Algorithm, leaf size, bin count, and cost model parameters.
+/// @param out Receives the depth-first node array and leaf-ordered primitive indices.
+/// @param stats Receives build timing and tree shape statistics.
+/// @param pool Threads to build with, or nullptr to build on the calling thread. Must not be
+///        called from inside a job running on the same pool.
+void buildBVH(const std::vector<AABB>& primBounds,
+              const BVHBuildSettings& settings,
+              LinearBVH& out,
+              BVHBuildStats& stats,
+              ThreadPool* pool = nullptr);
+
+/// @brief Builds a flattened BVH over the supplied primitive bounds using binned SAH splits.
+/// @details With a pool, the upper levels are split by all threads together (binning and
+/// partitioning in fixed-size chunks) until ranges are small enough to hand one subtree to each
+/// thread. Split choices match the serial build; only the order of primitives inside a leaf may
+/// differ. The result does not depend on the number of threads.
+/// @param primBounds One bounding box per primitive; leaves reference primitives by index.
+/// @param settings Leaf size, bin count, and cost model parameters.
+/// @param out Receives the depth-first node array and leaf-ordered primitive indices.
+/// @param stats Receives build timing and tree shape statistics.
+/// @param pool Threads to build with, or nullptr for the serial build.
+void buildBVHBinnedSAH(const std::vector<AABB>& primBounds,
+                       const BVHBuildSettings& settings,
+                       LinearBVH& out,
+                       BVHBuildStats& stats,
+                       ThreadPool* pool = nullptr);
+
+/// @brief Builds a flattened linear BVH (LBVH): primitives are ordered by the 30-bit Morton code
+/// of their centroid with a radix sort, and every node splits where the highest code bit changes.
+/// @details No split is ever scored, so the build is a few linear passes; the trees are looser
+/// than SAH trees. Leaves hold up to maxLeafSize primitives. The result is identical with and
+/// without a pool.
+/// @param primBounds One bounding box per primitive; leaves reference primitives by index.
+/// @param settings Leaf size; the cost model is ignored.
+/// @param out Receives the depth-first node array and leaf-ordered primitive indices.
+/// @param stats Receives build timing and tree shape statistics.
+/// @param pool Threads to build with, or nullptr to build on the calling thread.
+void buildBVHLinear(const std::vector<AABB>& primBounds,
+                    const BVHBuildSettings& settings,
+                    LinearBVH& out,
+                    BVHBuildStats& stats,
+                    ThreadPool* pool = nullptr);
+
+/// @brief Returns the lowercase name used by the CLI ("sah", "lbvh").
+inline const char* bvhBuildAlgorithmName(BVHBuildAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+        case BVHBuildAlgorithm::BinnedSAH: return "sah";
+        case BVHBuildAlgorithm::LBVH: return "lbvh";
+    }
+    return "sah";
+}
+
+/// @brief Parses a BVH builder name.
+/// @return False when the name is not recognised; @p algorithm is left unchanged.
+inline bool parseBVHBuildAlgorithm(const std::string& name, BVHBuildAlgorithm& algorithm)
+{
+    if (name == "sah") { algorithm = BVHBuildAlgorithm::BinnedSAH; return true; }
+    if (name == "lbvh") { algorithm = BVHBuildAlgorithm::LBVH; return true; }
+    return false;
+}
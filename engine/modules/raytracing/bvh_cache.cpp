@@ -0,0 +1,295 @@
+#include "bvh_cache.h"
+#include "two_level_bvh.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char kMagic[8] = {'G', 'L', 'B', 'V', 'H', 'C', '\0', '\0'};
+    constexpr uint32_t kByteOrderMark = 0x01020304u;
+
+    // Fixed-size preamble; the node array and then the packet array follow it directly
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t nodeSize;
+        uint32_t packetSize;
+        uint64_t key;
+        uint64_t triangleCount;
+        uint64_t nodeCount;
+        uint64_t packetCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+    static_assert(sizeof(FileHeader) == 80, "BVH cache header layout changed");
+
+    // Read-only view of a whole file; empty when the file is missing or cannot be mapped
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& path)
+        {
+#ifdef _WIN32
+            m_file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                 nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                return;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart <= 0)
+                return;
+            m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_mapping)
+                return;
+            m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (m_data)
+                m_size = static_cast<size_t>(size.QuadPart);
+#else
+            m_fd = open(path.c_str(), O_RDONLY);
+            if (m_fd < 0)
+                return;
+            struct stat info;
+            if (fstat(m_fd, &info) != 0 || info.st_size <= 0)
+                return;
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+            if (data == MAP_FAILED)
+                return;
+            m_data = static_cast<const unsigned char*>(data);
+            m_size = static_cast<size_t>(info.st_size);
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifdef _WIN32
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+            if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+            if (m_fd >= 0) close(m_fd);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const unsigned char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+
+    uint64_t mix(uint64_t h, uint64_t value)
+    {
+        // splitmix64 finalizer over the running value
+        h ^= value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    uint64_t floatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // Rejects files whose references would send traversal out of bounds or past its stack
+    bool validHierarchy(const LinearBVHNode* nodes, uint64_t nodeCount, const TrianglePacket* packets,
+                        uint64_t packetCount, uint64_t triangleCount)
+    {
+        std::vector<uint16_t> depth(static_cast<size_t>(nodeCount), 0);
+        for (uint64_t i = 0; i < nodeCount; ++i)
+        {
+            const LinearBVHNode& node = nodes[i];
+            if (node.isLeaf())
+            {
+                const uint64_t leafPackets = (node.primCount + TrianglePacket::kWidth - 1) / TrianglePacket::kWidth;
+                if (static_cast<uint64_t>(node.offset) + leafPackets > packetCount)
+                    return false;
+                continue;
+            }
+            // Children always follow their parent in the depth-first layout
+            if (i + 1 >= nodeCount || node.offset <= i || node.offset >= nodeCount || node.axis > 2)
+                return false;
+            const uint16_t childDepth = static_cast<uint16_t>(depth[i] + 1);
+            if (childDepth >= LinearBVH::kStackSize)
+                return false;
+            depth[i + 1] = childDepth;
+            depth[node.offset] = childDepth;
+        }
+        for (uint64_t p = 0; p < packetCount; ++p)
+        {
+            for (int lane = 0; lane < TrianglePacket::kWidth; ++lane)
+            {
+                const uint32_t id = packets[p].primId[lane];
+                if (id != TrianglePacket::kInvalidId && id >= triangleCount)
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+BVHCache::BVHCache(std::filesystem::path directory)
+    : m_directory(std::move(directory))
+{
+}
+
+uint64_t BVHCache::key(uint64_t contentHash, size_t triangleCount, const BVHBuildSettings& settings)
+{
+    uint64_t h = mix(0, kFormatVersion);
+    h = mix(h, contentHash);
+    h = mix(h, triangleCount);
+    h = mix(h, static_cast<uint64_t>(settings.algorithm));
+    h = mix(h, static_cast<uint64_t>(settings.maxLeafSize));
+    h = mix(h, static_cast<uint64_t>(settings.binCount));
+    h = mix(h, floatBits(settings.traversalCost));
+    h = mix(h, floatBits(settings.intersectionCost));
+    h = mix(h, static_cast<uint64_t>(settings.packetWidth));
+    h = mix(h, sizeof(LinearBVHNode));
+    h = mix(h, sizeof(TrianglePacket));
+    return h;
+}
+
+std::filesystem::path BVHCache::pathFor(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bvh", static_cast<unsigned long long>(key));
+    return m_directory / name;
+}
+
+bool BVHCache::load(uint64_t key, MeshBVH& mesh) const
+{
+    const MappedFile file(pathFor(key));
+    if (!file.data() || file.size() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion ||
+        header.byteOrder != kByteOrderMark || header.nodeSize != sizeof(LinearBVHNode) ||
+        header.packetSize != sizeof(TrianglePacket) || header.key != key ||
+        header.triangleCount != mesh.triangleCount || header.nodeCount == 0)
+        return false;
+    // Cheap guard against a hash collision between meshes of equal triangle count
+    if (glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]) != mesh.bounds.min ||
+        glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]) != mesh.bounds.max)
+        return false;
+
+    // Counts come from the file, so bound them by its size before multiplying
+    const uint64_t payload = file.size() - sizeof(FileHeader);
+    if (header.nodeCount > payload / sizeof(LinearBVHNode) || header.packetCount > payload / sizeof(TrianglePacket))
+        return false;
+    const uint64_t nodeBytes = header.nodeCount * sizeof(LinearBVHNode);
+    const uint64_t packetBytes = header.packetCount * sizeof(TrianglePacket);
+    if (nodeBytes + packetBytes != payload)
+        return false;
+
+    // The mapping carries no alignment guarantees, so the arrays are copied out before use
+    std::vector<LinearBVHNode> nodes(static_cast<size_t>(header.nodeCount));
+    std::vector<TrianglePacket> packets(static_cast<size_t>(header.packetCount));
+    const unsigned char* cursor = file.data() + sizeof(FileHeader);
+    std::memcpy(nodes.data(), cursor, static_cast<size_t>(nodeBytes));
+    if (packetBytes > 0)
+        std::memcpy(packets.data(), cursor + nodeBytes, static_cast<size_t>(packetBytes));
+    if (!validHierarchy(nodes.data(), header.nodeCount, packets.data(), header.packetCount, header.triangleCount))
+        return false;
+
+    mesh.bvh.nodes = std::move(nodes);
+    mesh.bvh.primIndices = std::vector<uint32_t>();
+    mesh.packets = std::move(packets);
+    return true;
+}
+
+bool BVHCache::store(uint64_t key, const MeshBVH& mesh) const
+{
+    if (mesh.bvh.nodes.empty())
+        return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec)
+        return false;
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.byteOrder = kByteOrderMark;
+    header.nodeSize = sizeof(LinearBVHNode);
+    header.packetSize = sizeof(TrianglePacket);
+    header.key = key;
+    header.triangleCount = mesh.triangleCount;
+    header.nodeCount = mesh.bvh.nodes.size();
+    header.packetCount = mesh.packets.size();
+    for (int i = 0; i < 3; ++i)
+    {
+        header.boundsMin[i] = mesh.bounds.min[i];
+        header.boundsMax[i] = mesh.bounds.max[i];
+    }
+
+    // Unique temporary name per writer; the rename publishes the finished file atomically
+    const std::filesystem::path target = pathFor(key);
+    const uint64_t writer = mix(std::hash<std::thread::id>()(std::this_thread::get_id()),
+                                static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp", static_cast<unsigned long long>(writer));
+    std::filesystem::path temporary = target;
+    temporary += suffix;
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mesh.bvh.nodes.data()),
+                  static_cast<std::streamsize>(mesh.bvh.nodes.size() * sizeof(LinearBVHNode)));
+        out.write(reinterpret_cast<const char*>(mesh.packets.data()),
+                  static_cast<std::streamsize>(mesh.packets.size() * sizeof(TrianglePacket)));
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
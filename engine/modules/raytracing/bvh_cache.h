@@ -0,0 +1,52 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/bvh_cache.h","purpose":"Declares the on-disk cache of bottom-level mesh BVHs, keyed by mesh content and build parameters.","exports":["BVHCache"],"depends_on":["bvh_builder.h","<cstdint>","<filesystem>"],"notes":["versioned_binary_format","memory_mapped_loads","atomic_rename_on_store","validated_before_use","stateless_thread_safe"]}
+// Human Summary
+// Saves built mesh BVHs and their triangle packets next to the user cache so later runs that load the same asset skip the build entirely.
+
+#pragma once
+/// @file bvh_cache.h
+/// @brief Persistent cache of built mesh BVHs.
+
+#include <cstdint>
+#include <filesystem>
+#include "bvh_builder.h"
+
+struct MeshBVH;
+
+/// @brief Stores and retrieves bottom-level BVHs as versioned binary files, one per mesh.
+/// @details A file holds the node array and the leaf-ordered triangle packets (which carry the
+/// primitive ordering). Loads memory-map the file, validate the header and every node and packet
+/// reference, and copy the arrays out; a file that fails any check is ignored and later
+/// overwritten. Stores write a temporary file and rename it into place, so concurrent processes
+/// sharing the directory never observe a partial file. The cache keeps no state besides its
+/// directory and may be used from several threads.
+class BVHCache
+{
+public:
+    /// @brief Bump whenever the file layout, the node/packet layout, or the builder output changes.
+    static constexpr uint32_t kFormatVersion = 2;
+
+    /// @param directory Folder holding the cache files; created on the first store.
+    explicit BVHCache(std::filesystem::path directory);
+
+    /// @brief Returns the folder holding the cache files.
+    const std::filesystem::path& directory() const { return m_directory; }
+
+    /// @brief Derives the cache key of a mesh built with @p settings.
+    /// @param contentHash MeshBVH::contentHash of the source geometry.
+    /// @param triangleCount Source triangles in the mesh.
+    static uint64_t key(uint64_t contentHash, size_t triangleCount, const BVHBuildSettings& settings);
+
+    /// @brief Fills the hierarchy and packets of @p mesh from the file for @p key.
+    /// @return False on a miss or an invalid file; @p mesh is left untouched then.
+    bool load(uint64_t key, MeshBVH& mesh) const;
+
+    /// @brief Writes the hierarchy and packets of a built mesh under @p key.
+    /// @return False when the file could not be written; the render is unaffected.
+    bool store(uint64_t key, const MeshBVH& mesh) const;
+
+private:
+    std::filesystem::path m_directory;
+
+    std::filesystem::path pathFor(uint64_t key) const;
+};
@@ -0,0 +1,105 @@
+#include "environment_map.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979323846f;
+    const glm::vec3 kLumaWeights(0.2126f, 0.7152f, 0.0722f);
+
+    // sin(latitude) of the lower edge of a row; rows run from latitude -pi/2 (row 0) to pi/2
+    float rowEdgeSinLatitude(uint32_t row, int height)
+    {
+        return std::sin((static_cast<float>(row) / static_cast<float>(height) - 0.5f) * kPi);
+    }
+}
+
+bool EnvironmentMap::build(const float* pixels, int width, int height, int channels)
+{
+    m_radiance.clear();
+    m_columns.clear();
+    if (!pixels || width <= 0 || height <= 0 || channels < 3)
+        return false;
+
+    m_width = width;
+    m_height = height;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    m_radiance.resize(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        const float* p = pixels + i * channels;
+        // Negative or NaN texels would poison the sampling weights
+        m_radiance[i] = glm::vec3(std::isfinite(p[0]) ? std::max(0.0f, p[0]) : 0.0f,
+                                  std::isfinite(p[1]) ? std::max(0.0f, p[1]) : 0.0f,
+                                  std::isfinite(p[2]) ? std::max(0.0f, p[2]) : 0.0f);
+    }
+
+    // Weight every pixel by the power it delivers: luminance times the solid angle it covers
+    std::vector<float> weights(width);
+    std::vector<float> rowWeights(height);
+    m_columns.resize(height);
+    for (int row = 0; row < height; ++row)
+    {
+        const float solidAngle = (rowEdgeSinLatitude(row + 1, height) - rowEdgeSinLatitude(row, height)) * 2.0f * kPi / width;
+        const glm::vec3* rowPixels = &m_radiance[static_cast<size_t>(row) * width];
+        for (int column = 0; column < width; ++column)
+            weights[column] = glm::dot(rowPixels[column], kLumaWeights) * solidAngle;
+        m_columns[row].build(weights.data(), static_cast<uint32_t>(width));
+        rowWeights[row] = static_cast<float>(m_columns[row].totalWeight());
+    }
+    m_rows.build(rowWeights.data(), static_cast<uint32_t>(height));
+    return true;
+}
+
+uint32_t EnvironmentMap::pixelIndex(const glm::vec3& direction) const
+{
+    const float u = std::atan2(direction.z, direction.x) / (2.0f * kPi) + 0.5f;
+    const float v = std::asin(glm::clamp(direction.y, -1.0f, 1.0f)) / kPi + 0.5f;
+    const int column = std::min(m_width - 1, std::max(0, static_cast<int>(u * m_width)));
+    const int row = std::min(m_height - 1, std::max(0, static_cast<int>(v * m_height)));
+    return static_cast<uint32_t>(row) * static_cast<uint32_t>(m_width) + static_cast<uint32_t>(column);
+}
+
+float EnvironmentMap::pixelPdf(uint32_t row, uint32_t column) const
+{
+    const float solidAngle = (rowEdgeSinLatitude(row + 1, m_height) - rowEdgeSinLatitude(row, m_height)) * 2.0f * kPi / m_width;
+    if (solidAngle <= 0.0f)
+        return 0.0f;
+    return m_rows.probability(row) * m_columns[row].probability(column) / solidAngle;
+}
+
+glm::vec3 EnvironmentMap::eval(const glm::vec3& direction) const
+{
+    if (m_radiance.empty())
+        return glm::vec3(0.0f);
+    return m_radiance[pixelIndex(direction)];
+}
+
+float EnvironmentMap::pdf(const glm::vec3& direction) const
+{
+    if (m_radiance.empty() || m_rows.totalWeight() <= 0.0)
+        return 0.0f;
+    const uint32_t index = pixelIndex(direction);
+    return pixelPdf(index / m_width, index % m_width);
+}
+
+EnvironmentSample EnvironmentMap::sample(const glm::vec2& u) const
+{
+    EnvironmentSample result;
+    if (m_radiance.empty() || m_rows.totalWeight() <= 0.0)
+        return result;
+
+    float rowOffset = 0.0f, columnOffset = 0.0f;
+    const uint32_t row = m_rows.sample(u.y, rowOffset);
+    const uint32_t column = m_columns[row].sample(u.x, columnOffset);
+
+    // Uniform in azimuth and in sin(latitude) inside the pixel, i.e. uniform in solid angle
+    const float phi = ((static_cast<float>(column) + columnOffset) / m_width - 0.5f) * 2.0f * kPi;
+    const float y0 = rowEdgeSinLatitude(row, m_height);
+    const float y = y0 + rowOffset * (rowEdgeSinLatitude(row + 1, m_height) - y0);
+    const float r = std::sqrt(std::max(0.0f, 1.0f - y * y));
+    result.direction = glm::vec3(std::cos(phi) * r, y, std::sin(phi) * r);
+    result.radiance = m_radiance[static_cast<size_t>(row) * m_width + column];
+    result.pdf = pixelPdf(row, column);
+    return result;
+}
@@ -0,0 +1,68 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/environment_map.h","purpose":"Declares the equirectangular HDR environment used as a light source by the CPU raytracer, with luminance-proportional importance sampling.","exports":["EnvironmentMap","EnvironmentSample"],"depends_on":["sampler.h","glm/glm.hpp","<vector>"],"notes":["same_mapping_as_ibl_equirect_shader","2d_alias_table_constant_time_sampling","piecewise_constant_pdf","immutable_after_build"]}
+// Human Summary
+// Holds an HDR environment image and samples directions in proportion to the light each pixel contributes, so reflective objects under studio HDRIs resolve with a few samples.
+
+#pragma once
+/// @file environment_map.h
+/// @brief HDR environment light with alias-table importance sampling.
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "sampler.h"
+
+/// @brief Direction drawn from an environment map.
+struct EnvironmentSample
+{
+    glm::vec3 direction{0.0f}; ///< Normalized world-space direction towards the environment.
+    glm::vec3 radiance{0.0f};  ///< Radiance arriving from that direction.
+    float pdf = 0.0f;          ///< Solid-angle density of the direction.
+};
+
+/// @brief Equirectangular HDR environment that can be evaluated and importance sampled.
+/// @details Uses the IBL shader's mapping: u follows atan2(z, x) and v follows asin(y), with
+/// rows stored bottom first. Pixels are picked with a marginal alias table over rows and one
+/// conditional table per row, weighted by luminance times the solid angle of the row, so each
+/// sample costs two table lookups regardless of resolution. The map is read-only once built and
+/// can be shared between render threads.
+class EnvironmentMap
+{
+public:
+    /// @brief Copies an HDR image and builds the sampling tables.
+    /// @param pixels Linear RGB(A) floats, bottom row first.
+    /// @param width Image width in pixels.
+    /// @param height Image height in pixels.
+    /// @param channels Floats per pixel (3 or 4; alpha is ignored).
+    /// @return False when the image is empty or has fewer than three channels.
+    bool build(const float* pixels, int width, int height, int channels);
+
+    /// @brief Returns true once build() succeeded.
+    bool valid() const { return !m_radiance.empty(); }
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    /// @brief Returns the radiance arriving from a normalized direction.
+    glm::vec3 eval(const glm::vec3& direction) const;
+
+    /// @brief Returns the solid-angle density with which sample() picks @p direction.
+    float pdf(const glm::vec3& direction) const;
+
+    /// @brief Draws a direction with density proportional to the luminance it carries.
+    /// @param u Uniform sample in [0,1)^2.
+    EnvironmentSample sample(const glm::vec2& u) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<glm::vec3> m_radiance;         ///< Row-major, bottom row first.
+    sampling::AliasTable m_rows;               ///< Marginal distribution over rows.
+    std::vector<sampling::AliasTable> m_columns; ///< Conditional distribution within each row.
+
+    /// @brief Returns the pixel index a normalized direction falls into.
+    uint32_t pixelIndex(const glm::vec3& direction) const;
+
+    /// @brief Converts the probability of picking a pixel into a solid-angle density.
+    float pixelPdf(uint32_t row, uint32_t column) const;
+};
@@ -0,0 +1,70 @@
+#include "gbuffer_cache.h"
+
+void GBufferCache::clear()
+{
+    m_layers.clear();
+    m_key = Key();
+}
+
+void GBufferCache::begin(const Key& key, size_t budgetBytes)
+{
+    if (key != m_key)
+    {
+        m_layers.clear();
+        m_key = key;
+    }
+    const size_t layerBytes = static_cast<size_t>(key.width) * static_cast<size_t>(key.height) * sizeof(GBufferSample);
+    m_maxLayers = layerBytes > 0 ? budgetBytes / layerBytes : 0;
+    if (m_layers.size() > m_maxLayers)
+        m_layers.resize(m_maxLayers);
+}
+
+GBufferSample* GBufferCache::layer(uint32_t pass)
+{
+    if (pass >= m_maxLayers)
+        return nullptr;
+    // Layers fill in pass order, so a missing layer is always the next one
+    if (pass >= m_layers.size())
+        m_layers.emplace_back(static_cast<size_t>(m_key.width) * static_cast<size_t>(m_key.height));
+    return m_layers[pass].data();
+}
+
+size_t GBufferCache::bytes() const
+{
+    size_t total = 0;
+    for (const std::vector<GBufferSample>& layer : m_layers)
+        total += layer.size() * sizeof(GBufferSample);
+    return total;
+}
+
+void GBufferCache::store(GBufferSample& sample, const InstanceHit* hit, const TwoLevelBVH& scene)
+{
+    if (!hit)
+    {
+        sample = GBufferSample();
+        sample.instance = GBufferSample::kMiss;
+        return;
+    }
+    const MeshBVH& mesh = scene.meshes()[scene.instances()[hit->instanceIndex].meshIndex];
+    sample.t = hit->t;
+    sample.u = hit->u;
+    sample.v = hit->v;
+    sample.instance = hit->instanceIndex;
+    sample.triangle = hit->triangleIndex;
+    sample.packetSlot = static_cast<uint32_t>(hit->packet - mesh.packets.data()) * TrianglePacket::kWidth + hit->lane;
+}
+
+bool GBufferCache::restore(const GBufferSample& sample, const TwoLevelBVH& scene, InstanceHit& hit)
+{
+    if (sample.instance == GBufferSample::kMiss)
+        return false;
+    const MeshBVH& mesh = scene.meshes()[scene.instances()[sample.instance].meshIndex];
+    hit.t = sample.t;
+    hit.u = sample.u;
+    hit.v = sample.v;
+    hit.instanceIndex = sample.instance;
+    hit.triangleIndex = sample.triangle;
+    hit.packet = &mesh.packets[sample.packetSlot / TrianglePacket::kWidth];
+    hit.lane = sample.packetSlot % TrianglePacket::kWidth;
+    return true;
+}
@@ -0,0 +1,94 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/gbuffer_cache.h","purpose":"Declares the first-hit G-buffer cache that lets the CPU raytracer reshade camera rays without re-tracing them.","exports":["GBufferSample","GBufferCache"],"depends_on":["two_level_bvh.h","sampler.h","glm/glm.hpp","<vector>"],"notes":["one_slot_per_pixel_and_pass","keyed_by_camera_resolution_and_sampler","cleared_when_geometry_is_rebuilt","materials_and_lights_read_at_shade_time","bounded_memory_budget"]}
+// Human Summary
+// Remembers where every camera ray landed so renders that only change lights, materials or exposure trace just the secondary and shadow rays.
+
+#pragma once
+/// @file gbuffer_cache.h
+/// @brief Cached camera-ray hits for relighting without re-tracing.
+
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "two_level_bvh.h"
+#include "sampler.h"
+
+/// @brief First hit of one camera ray.
+/// @details Stores the hit record rather than shaded attributes: position, normals and UVs are
+/// rebuilt from the barycentrics and material ids are read from the instance when shading, so
+/// material edits apply to cached pixels.
+struct GBufferSample
+{
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu; ///< Slot not traced yet.
+    static constexpr uint32_t kMiss = 0xFFFFFFFEu;  ///< Camera ray left the scene.
+
+    float t = FLT_MAX;             ///< Hit distance along the normalized camera ray.
+    float u = 0.0f;                ///< Barycentric weight of the second vertex.
+    float v = 0.0f;                ///< Barycentric weight of the third vertex.
+    uint32_t instance = kEmpty;    ///< Instance hit, or kEmpty / kMiss.
+    uint32_t triangle = 0;         ///< Source triangle index within the instance's mesh.
+    uint32_t packetSlot = 0;       ///< Packet index * TrianglePacket::kWidth + lane within the mesh.
+};
+
+/// @brief Per-pixel camera-ray hits of earlier renders, one layer per progressive pass.
+/// @details Layer @c n holds the hits of sample @c n of every pixel, so a render with the same
+/// camera, resolution, seed and sampler finds the rays it is about to trace. Layers are
+/// allocated while the memory budget allows; later passes trace as usual. The owner clears the
+/// cache whenever the acceleration structure is rebuilt, since cached hits point into it.
+/// Threads may fill disjoint slots of a layer concurrently.
+class GBufferCache
+{
+public:
+    /// @brief Default memory budget (256 MiB, e.g. 11 layers at 1024x1024).
+    static constexpr size_t kDefaultBudgetBytes = size_t(256) << 20;
+
+    /// @brief Everything besides geometry that decides where camera rays go.
+    struct Key
+    {
+        glm::vec3 position{0.0f};
+        glm::vec3 imageCenter{0.0f};
+        glm::vec3 imageRight{0.0f};
+        glm::vec3 imageUp{0.0f};
+        int width = 0;
+        int height = 0;
+        uint32_t seed = 0;
+        sampling::SamplerType sampler = sampling::SamplerType::Random;
+
+        bool operator==(const Key& other) const
+        {
+            return position == other.position && imageCenter == other.imageCenter &&
+                   imageRight == other.imageRight && imageUp == other.imageUp && width == other.width &&
+                   height == other.height && seed == other.seed && sampler == other.sampler;
+        }
+        bool operator!=(const Key& other) const { return !(*this == other); }
+    };
+
+    /// @brief Drops every layer.
+    void clear();
+
+    /// @brief Starts a render; layers recorded under another key are dropped.
+    void begin(const Key& key, size_t budgetBytes = kDefaultBudgetBytes);
+
+    /// @brief Returns the slots of pass @p pass, allocating the layer if the budget allows.
+    /// @return Width * height slots in image order (top row first), or nullptr when the pass is not cached.
+    GBufferSample* layer(uint32_t pass);
+
+    /// @brief Number of layers held.
+    size_t layerCount() const { return m_layers.size(); }
+
+    /// @brief Memory held by the layers.
+    size_t bytes() const;
+
+    /// @brief Records a camera hit, or a miss when @p hit is nullptr.
+    static void store(GBufferSample& sample, const InstanceHit* hit, const TwoLevelBVH& scene);
+
+    /// @brief Rebuilds the hit record of a cached camera hit.
+    /// @return False for a miss.
+    static bool restore(const GBufferSample& sample, const TwoLevelBVH& scene, InstanceHit& hit);
+
+private:
+    Key m_key;
+    size_t m_maxLayers = 0;
+    std::vector<std::vector<GBufferSample>> m_layers;
+};
@@ -0,0 +1,208 @@
+#include "light_sampler.h"
+#include "light.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const glm::vec3 kLumaWeights(0.2126f, 0.7152f, 0.0722f);
+
+    // Same falloff as LightingSystem::sampleLight, so node importance tracks what a light delivers
+    float attenuation(float distance)
+    {
+        return 1.0f / (1.0f + 0.1f * distance + 0.01f * distance * distance);
+    }
+
+    bool isLocal(const LightSource& light)
+    {
+        return light.type == LightType::POINT || light.type == LightType::SPOT;
+    }
+}
+
+void LightSampler::build(const std::vector<LightSource>& lights, const LightSamplingSettings& settings)
+{
+    m_lightCount = lights.size();
+    m_alwaysEvaluated.clear();
+    m_localLights.clear();
+    m_nodes.clear();
+    m_powerTable = sampling::AliasTable();
+    m_samplesPerPoint = static_cast<uint32_t>(std::max(1, settings.samplesPerPoint));
+
+    std::vector<float> powers;
+    for (uint32_t i = 0; i < lights.size(); ++i)
+    {
+        const LightSource& light = lights[i];
+        if (!light.enabled)
+            continue;
+        if (!isLocal(light))
+        {
+            m_alwaysEvaluated.push_back(i);
+            continue;
+        }
+        const float power = light.intensity * glm::dot(light.color, kLumaWeights);
+        if (!(power > 0.0f))
+            continue;
+        m_localLights.push_back(i);
+        powers.push_back(power);
+    }
+
+    m_mode = settings.mode;
+    if (m_mode == LightSamplingMode::Auto)
+    {
+        const bool few = m_localLights.size() <= static_cast<size_t>(std::max(0, settings.exhaustiveLimit));
+        m_mode = few ? LightSamplingMode::All : LightSamplingMode::Tree;
+    }
+    if (m_localLights.empty())
+        m_mode = LightSamplingMode::All;
+    if (m_mode == LightSamplingMode::All)
+        return;
+
+    if (m_mode == LightSamplingMode::Power)
+    {
+        // Without a position to weigh against, a spot counts for the fraction of the sphere it lights
+        std::vector<float> weights(powers);
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            const LightSource& light = lights[m_localLights[i]];
+            if (light.type == LightType::SPOT)
+                weights[i] *= std::max(0.0f, 1.0f - std::cos(glm::radians(light.outerConeDeg))) * 0.5f;
+        }
+        m_powerTable.build(weights.data(), static_cast<uint32_t>(weights.size()));
+        return;
+    }
+
+    // Tree: index the lights by position; powers and positions are looked up by light index
+    std::vector<glm::vec3> positions(lights.size(), glm::vec3(0.0f));
+    std::vector<float> lightPowers(lights.size(), 0.0f);
+    for (size_t i = 0; i < m_localLights.size(); ++i)
+    {
+        positions[m_localLights[i]] = lights[m_localLights[i]].position;
+        lightPowers[m_localLights[i]] = powers[i];
+    }
+    std::vector<uint32_t> order(m_localLights);
+    m_nodes.reserve(order.size() * 2);
+    buildNode(order, 0, order.size(), positions, lightPowers);
+
+    // Leaves of spot lights also know their cone, so points outside it never pick them
+    for (Node& node : m_nodes)
+    {
+        if (!node.leaf)
+            continue;
+        const LightSource& light = lights[node.child];
+        if (light.type == LightType::SPOT)
+        {
+            node.axis = glm::normalize(light.direction);
+            node.cosCone = std::cos(glm::radians(light.outerConeDeg));
+        }
+    }
+}
+
+uint32_t LightSampler::buildNode(std::vector<uint32_t>& lights, size_t begin, size_t end,
+                                 const std::vector<glm::vec3>& positions, const std::vector<float>& powers)
+{
+    const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Node node;
+    node.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    node.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+    for (size_t i = begin; i < end; ++i)
+    {
+        node.boundsMin = glm::min(node.boundsMin, positions[lights[i]]);
+        node.boundsMax = glm::max(node.boundsMax, positions[lights[i]]);
+        node.power += powers[lights[i]];
+    }
+
+    if (end - begin == 1)
+    {
+        node.leaf = true;
+        node.child = lights[begin];
+        m_nodes[index] = node;
+        return index;
+    }
+
+    // Median split along the widest axis keeps the tree balanced at log2(n) levels
+    const glm::vec3 extent = node.boundsMax - node.boundsMin;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(lights.begin() + begin, lights.begin() + mid, lights.begin() + end,
+                     [&](uint32_t a, uint32_t b) { return positions[a][axis] < positions[b][axis]; });
+
+    buildNode(lights, begin, mid, positions, powers);
+    node.child = buildNode(lights, mid, end, positions, powers);
+    m_nodes[index] = node;
+    return index;
+}
+
+float LightSampler::importance(const Node& node, const glm::vec3& point, const glm::vec3& normal) const
+{
+    // Nothing in the box can light the point when the whole box is below its surface
+    const glm::vec3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+    const glm::vec3 halfExtent = (node.boundsMax - node.boundsMin) * 0.5f;
+    if (glm::dot(normal, center - point) + glm::dot(glm::abs(normal), halfExtent) <= 0.0f)
+        return 0.0f;
+
+    if (node.leaf && node.cosCone > -1.0f)
+    {
+        // Mirrors the cone test of LightingSystem::sampleLight
+        const glm::vec3 lightVec = node.boundsMin - point;
+        const float distance = glm::length(lightVec);
+        if (distance > 1e-6f && glm::dot(-(lightVec / distance), node.axis) <= node.cosCone)
+            return 0.0f;
+    }
+
+    // The closest point of the box bounds the falloff of every light inside it
+    const glm::vec3 closest = glm::clamp(point, node.boundsMin, node.boundsMax);
+    return node.power * attenuation(glm::length(closest - point));
+}
+
+LightPick LightSampler::pick(const glm::vec3& point, const glm::vec3& normal, float u) const
+{
+    LightPick result;
+    if (m_mode == LightSamplingMode::Power)
+    {
+        float remapped = 0.0f;
+        const uint32_t entry = m_powerTable.sample(u, remapped);
+        result.index = m_localLights[entry];
+        result.probability = m_powerTable.probability(entry);
+        return result;
+    }
+    if (m_nodes.empty())
+        return result;
+
+    uint32_t index = 0;
+    float probability = 1.0f;
+    if (importance(m_nodes[0], point, normal) <= 0.0f)
+        return result;
+    while (!m_nodes[index].leaf)
+    {
+        const uint32_t left = index + 1;
+        const uint32_t right = m_nodes[index].child;
+        const float leftImportance = importance(m_nodes[left], point, normal);
+        const float rightImportance = importance(m_nodes[right], point, normal);
+        const float total = leftImportance + rightImportance;
+        if (total <= 0.0f)
+            return result;
+
+        // Reuse u for the next level by rescaling it into the chosen branch's interval
+        const float leftProbability = leftImportance / total;
+        if (u < leftProbability)
+        {
+            index = left;
+            probability *= leftProbability;
+            u = u / leftProbability;
+        }
+        else
+        {
+            index = right;
+            probability *= 1.0f - leftProbability;
+            u = (u - leftProbability) / (1.0f - leftProbability);
+        }
+        u = std::min(u, 0.99999994f);
+    }
+
+    result.index = m_nodes[index].child;
+    result.probability = probability;
+    return result;
+}
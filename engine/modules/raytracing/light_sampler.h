@@ -0,0 +1,122 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/light_sampler.h","purpose":"Declares many-light selection for the CPU raytracer: a power-weighted alias table and a spatial light BVH over point and spot lights.","exports":["LightSamplingMode","LightSamplingSettings","LightPick","LightSampler","lightSamplingModeName","parseLightSamplingMode"],"depends_on":["sampler.h","glm/glm.hpp","<string>","<vector>"],"notes":["bounded_lights_per_shading_point","directional_lights_always_evaluated","exact_selection_pdf","small_scenes_stay_exhaustive"]}
+// Human Summary
+// Picks a few local lights per shading point in proportion to their estimated contribution, so shading cost no longer grows with the number of fixtures in a scene.
+
+#pragma once
+/// @file light_sampler.h
+/// @brief Light selection structures for scenes with many local lights.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "sampler.h"
+
+struct LightSource;
+
+/// @brief How the raytracer chooses lights at each shading point.
+enum class LightSamplingMode
+{
+    Auto,  ///< Every light up to LightSamplingSettings::exhaustiveLimit local lights, the light tree beyond.
+    All,   ///< Evaluate every light at every point (no noise, linear cost).
+    Power, ///< Pick local lights in proportion to their emitted power, independent of position.
+    Tree   ///< Descend a light BVH, favouring bright lights that are near and in front of the point.
+};
+
+/// @brief Parameters of light selection.
+struct LightSamplingSettings
+{
+    LightSamplingMode mode = LightSamplingMode::Auto;
+    int samplesPerPoint = 4;  ///< Local lights picked per shading point when sampling.
+    int exhaustiveLimit = 8;  ///< Auto evaluates every light while there are at most this many local lights.
+};
+
+/// @brief A chosen light and the probability of having chosen it.
+struct LightPick
+{
+    uint32_t index = 0;   ///< Index into Light::m_lights.
+    float probability = 0.0f; ///< 0 when no light can contribute to the point.
+};
+
+/// @brief Selects point and spot lights for shading; directional lights are always evaluated.
+/// @details Rebuilt at the start of each render from the scene's light list. Read-only afterwards,
+/// so render threads share it.
+class LightSampler
+{
+public:
+    /// @brief Builds the selection structure for @p lights.
+    void build(const std::vector<LightSource>& lights, const LightSamplingSettings& settings);
+
+    /// @brief Returns true when local lights are sampled rather than all evaluated.
+    bool active() const { return m_mode != LightSamplingMode::All; }
+
+    /// @brief Returns the mode in use after resolving Auto.
+    LightSamplingMode mode() const { return m_mode; }
+
+    /// @brief Number of lights the structure was built for; callers fall back to evaluating all
+    /// lights when this does not match their light list.
+    size_t lightCount() const { return m_lightCount; }
+
+    /// @brief Lights evaluated at every point while sampling (directional lights).
+    const std::vector<uint32_t>& alwaysEvaluated() const { return m_alwaysEvaluated; }
+
+    /// @brief Local lights picked per shading point.
+    uint32_t samplesPerPoint() const { return m_samplesPerPoint; }
+
+    /// @brief Picks one local light for a shading point.
+    /// @param u Uniform value in [0, 1).
+    LightPick pick(const glm::vec3& point, const glm::vec3& normal, float u) const;
+
+private:
+    /// @brief Light BVH node; leaves hold one light.
+    struct Node
+    {
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        float power = 0.0f;
+        uint32_t child = 0;     ///< Right child for inner nodes (left child follows the node); light index for leaves.
+        bool leaf = false;
+        glm::vec3 axis{0.0f};   ///< Spot direction of a spot-light leaf.
+        float cosCone = -1.0f;  ///< Cosine of a spot leaf's outer cone; -1 lights every direction.
+    };
+
+    LightSamplingMode m_mode = LightSamplingMode::All;
+    size_t m_lightCount = 0;
+    uint32_t m_samplesPerPoint = 0;
+    std::vector<uint32_t> m_alwaysEvaluated;
+    std::vector<uint32_t> m_localLights;   ///< Alias table entry -> light index.
+    sampling::AliasTable m_powerTable;
+    std::vector<Node> m_nodes;
+
+    /// @brief Builds the subtree over lights [begin, end) and returns its node index.
+    uint32_t buildNode(std::vector<uint32_t>& lights, size_t begin, size_t end,
+                       const std::vector<glm::vec3>& positions, const std::vector<float>& powers);
+
+    /// @brief Upper bound on what a node's lights can deliver to the point, up to a common factor.
+    float importance(const Node& node, const glm::vec3& point, const glm::vec3& normal) const;
+};
+
+/// @brief Returns the lowercase name used by the CLI ("auto", "all", "power", "tree").
+inline const char* lightSamplingModeName(LightSamplingMode mode)
+{
+    switch (mode)
+    {
+        case LightSamplingMode::Auto: return "auto";
+        case LightSamplingMode::All: return "all";
+        case LightSamplingMode::Power: return "power";
+        case LightSamplingMode::Tree: return "tree";
+    }
+    return "auto";
+}
+
+/// @brief Parses a light sampling mode name.
+/// @return False when the name is not recognised; @p mode is left unchanged.
+inline bool parseLightSamplingMode(const std::string& name, LightSamplingMode& mode)
+{
+    if (name == "auto") { mode = LightSamplingMode::Auto; return true; }
+    if (name == "all") { mode = LightSamplingMode::All; return true; }
+    if (name == "power") { mode = LightSamplingMode::Power; return true; }
+    if (name == "tree") { mode = LightSamplingMode::Tree; return true; }
+    return false;
+}
@@ -0,0 +1,202 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/linear_bvh.h","purpose":"Defines the flattened BVH node array and its iterative traversal used by the raytracer.","exports":["AABB","LinearBVHNode","LinearBVH","BVHTraversalStats","RayTraversalData"],"depends_on":["ray.h","glm/glm.hpp","<vector>","<cstdint>"],"notes":["32_byte_nodes","depth_first_layout","near_child_first_stack_traversal"]}
+// Human Summary
+// Compact depth-first BVH layout with child-offset/primitive-range encoding and a fixed-stack traversal that culls against the closest hit.
+
+#pragma once
+/// @file linear_bvh.h
+/// @brief Flattened bounding volume hierarchy and iterative traversal for the ray tracer.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ray.h"
+
+/// @brief Axis-aligned bounding box used while building and refitting hierarchies.
+struct AABB
+{
+    glm::vec3 min{FLT_MAX};  ///< Minimum corner.
+    glm::vec3 max{-FLT_MAX}; ///< Maximum corner.
+
+    /// @brief Expands the box to contain a point.
+    void grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+
+    /// @brief Expands the box to contain another box.
+    void grow(const AABB& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+
+    /// @brief Returns true once at least one point has been added.
+    bool valid() const { return min.x <= max.x; }
+
+    /// @brief Returns the box centre.
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+
+    /// @brief Returns the surface area, or zero for an empty box.
+    float surfaceArea() const
+    {
+        if (!valid()) return 0.0f;
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+};
+
+/// @brief 32-byte BVH node stored in depth-first order.
+/// @details Interior nodes keep their first child at the next array slot and store the second
+/// child's index in @c offset. Leaves store the first entry of their primitive range in @c offset.
+struct LinearBVHNode
+{
+    glm::vec3 boundsMin{0.0f}; ///< Minimum corner of the node bounds.
+    uint32_t offset = 0;       ///< Second child index (interior) or first primitive slot (leaf).
+    glm::vec3 boundsMax{0.0f}; ///< Maximum corner of the node bounds.
+    uint16_t primCount = 0;    ///< Number of primitives; zero marks an interior node.
+    uint8_t axis = 0;          ///< Split axis used to order child visits.
+    uint8_t pad = 0;           ///< Reserved.
+
+    /// @brief Returns true when the node references primitives directly.
+    bool isLeaf() const { return primCount > 0; }
+};
+
+static_assert(sizeof(LinearBVHNode) == 32, "LinearBVHNode must stay 32 bytes");
+
+/// @brief Counters gathered while traversing the hierarchy.
+struct BVHTraversalStats
+{
+    uint64_t nodesVisited = 0;     ///< Nodes whose bounds were tested.
+    uint64_t trianglesTested = 0;  ///< Primitive intersection tests performed.
+
+    /// @brief Accumulates another set of counters.
+    void add(const BVHTraversalStats& other)
+    {
+        nodesVisited += other.nodesVisited;
+        trianglesTested += other.trianglesTested;
+    }
+};
+
+/// @brief Per-ray values precomputed once before traversal.
+struct RayTraversalData
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 invDir{0.0f};
+    int dirIsNeg[3] = {0, 0, 0};
+
+    /// @brief Precomputes the reciprocal direction, clamping zero components to avoid NaNs.
+    explicit RayTraversalData(const Ray& ray)
+        : origin(ray.origin)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            float d = ray.direction[i];
+            if (std::abs(d) < 1e-12f) d = std::copysign(1e-12f, d);
+            invDir[i] = 1.0f / d;
+            dirIsNeg[i] = invDir[i] < 0.0f ? 1 : 0;
+        }
+    }
+};
+
+/// @brief Slab test of a ray against node bounds limited to [0, tMax].
+inline bool intersectNodeBounds(const LinearBVHNode& node, const RayTraversalData& ray, float tMax)
+{
+    glm::vec3 t0 = (node.boundsMin - ray.origin) * ray.invDir;
+    glm::vec3 t1 = (node.boundsMax - ray.origin) * ray.invDir;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return enter <= exit;
+}
+
+/// @brief Flattened BVH: node array plus the primitive index list its leaves reference.
+class LinearBVH
+{
+public:
+    /// @brief Maximum traversal stack depth; the builder keeps trees shallower than this.
+    static constexpr int kStackSize = 128;
+
+    std::vector<LinearBVHNode> nodes; ///< Depth-first node array; index 0 is the root.
+    std::vector<uint32_t> primIndices; ///< Primitive ids in leaf order.
+
+    /// @brief Returns true when no primitives are referenced.
+    bool empty() const { return nodes.empty(); }
+
+    /// @brief Releases all nodes and indices.
+    void clear() { nodes.clear(); primIndices.clear(); }
+
+    /// @brief Returns the bounds of the whole hierarchy.
+    AABB bounds() const
+    {
+        AABB b;
+        if (!nodes.empty()) { b.min = nodes[0].boundsMin; b.max = nodes[0].boundsMax; }
+        return b;
+    }
+
+    /// @brief Iteratively walks the tree, visiting the nearer child first and culling by tMax.
+    /// @param ray Ray data with precomputed reciprocal direction.
+    /// @param tMax Current closest hit distance; the leaf callback may shrink it.
+    /// @param stats Counters updated with visited nodes.
+    /// @param leaf Callback invoked as leaf(primIndex, tMax) for each candidate primitive;
+    ///        returning true terminates traversal (used by any-hit queries).
+    /// @return True if the leaf callback requested termination.
+    template <typename LeafFn>
+    bool traverse(const RayTraversalData& ray, float& tMax, BVHTraversalStats& stats, LeafFn&& leaf) const
+    {
+        return traverseLeaves(ray, tMax, stats, [&](const LinearBVHNode& node, float& t) {
+            for (uint32_t i = 0; i < node.primCount; ++i)
+            {
+                if (leaf(primIndices[node.offset + i], t))
+                    return true;
+            }
+            return false;
+        });
+    }
+
+    /// @brief Same walk as traverse() but hands whole leaves to the callback.
+    /// @details Used when leaves reference packed primitive storage instead of primIndices.
+    /// @param leaf Callback invoked as leaf(node, tMax); returning true terminates traversal.
+    template <typename LeafFn>
+    bool traverseLeaves(const RayTraversalData& ray, float& tMax, BVHTraversalStats& stats, LeafFn&& leaf) const
+    {
+        if (nodes.empty())
+            return false;
+
+        uint32_t stack[kStackSize];
+        int stackSize = 0;
+        uint32_t current = 0;
+
+        while (true)
+        {
+            const LinearBVHNode& node = nodes[current];
+            stats.nodesVisited++;
+
+            if (intersectNodeBounds(node, ray, tMax))
+            {
+                if (node.isLeaf())
+                {
+                    if (leaf(node, tMax))
+                        return true;
+                }
+                else
+                {
+                    // Descend into the child on the ray's near side of the split plane first
+                    if (ray.dirIsNeg[node.axis])
+                    {
+                        stack[stackSize++] = current + 1;
+                        current = node.offset;
+                    }
+                    else
+                    {
+                        stack[stackSize++] = node.offset;
+                        current = current + 1;
+                    }
+                    continue;
+                }
+            }
+
+            if (stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+        return false;
+    }
+};
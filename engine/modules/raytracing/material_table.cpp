@@ -0,0 +1,138 @@
+#include "material_table.h"
+#include <cstring>
+
+namespace
+{
+    // Hash and compare only the fields the ray tracer shades with; struct padding is ignored
+    uint64_t hashFloats(uint64_t h, const float* values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            h ^= bits;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    uint64_t hashMaterial(const Material& m, float reflectivity)
+    {
+        const float values[] = {
+            m.diffuse.x, m.diffuse.y, m.diffuse.z,
+            m.specular.x, m.specular.y, m.specular.z,
+            m.ambient.x, m.ambient.y, m.ambient.z,
+            m.shininess, m.roughness, m.metallic, m.ior, m.transmission,
+            reflectivity
+        };
+        return hashFloats(14695981039346656037ull, values, sizeof(values) / sizeof(values[0]));
+    }
+
+    bool sameMaterial(const Material& a, const Material& b)
+    {
+        return a.diffuse == b.diffuse && a.specular == b.specular && a.ambient == b.ambient &&
+               a.shininess == b.shininess && a.roughness == b.roughness && a.metallic == b.metallic &&
+               a.ior == b.ior && a.transmission == b.transmission;
+    }
+}
+
+MaterialTable::MaterialId MaterialTable::acquire(const Material& material, float reflectivity)
+{
+    const uint64_t hash = hashMaterial(material, reflectivity);
+    auto range = m_lookup.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        Entry& entry = m_entries[it->second];
+        if (entry.reflectivity == reflectivity && sameMaterial(entry.material, material))
+        {
+            entry.refCount++;
+            return it->second;
+        }
+    }
+
+    MaterialId id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        id = static_cast<MaterialId>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[id];
+    entry.material = material;
+    entry.reflectivity = reflectivity;
+    entry.refCount = 1;
+    entry.hash = hash;
+    m_lookup.emplace(hash, id);
+    return id;
+}
+
+void MaterialTable::release(MaterialId id)
+{
+    if (id >= m_entries.size() || m_entries[id].refCount == 0)
+        return;
+    if (--m_entries[id].refCount == 0)
+    {
+        unlink(id);
+        m_freeIds.push_back(id);
+    }
+}
+
+MaterialTable::MaterialId MaterialTable::update(MaterialId id, const Material& material, float reflectivity)
+{
+    if (id >= m_entries.size() || m_entries[id].refCount == 0)
+        return acquire(material, reflectivity);
+
+    Entry& entry = m_entries[id];
+    const uint64_t hash = hashMaterial(material, reflectivity);
+
+    // Sole owner and no equal entry elsewhere: edit in place so the id stays stable
+    if (entry.refCount == 1)
+    {
+        bool duplicate = false;
+        auto range = m_lookup.equal_range(hash);
+        for (auto it = range.first; it != range.second && !duplicate; ++it)
+        {
+            const Entry& other = m_entries[it->second];
+            duplicate = it->second != id && other.reflectivity == reflectivity && sameMaterial(other.material, material);
+        }
+        if (!duplicate)
+        {
+            unlink(id);
+            entry.material = material;
+            entry.reflectivity = reflectivity;
+            entry.hash = hash;
+            m_lookup.emplace(hash, id);
+            return id;
+        }
+    }
+
+    // Shared entry (or merging into an existing one): copy on write
+    MaterialId newId = acquire(material, reflectivity);
+    release(id);
+    return newId;
+}
+
+void MaterialTable::clear()
+{
+    m_entries.clear();
+    m_freeIds.clear();
+    m_lookup.clear();
+}
+
+void MaterialTable::unlink(MaterialId id)
+{
+    auto range = m_lookup.equal_range(m_entries[id].hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == id)
+        {
+            m_lookup.erase(it);
+            return;
+        }
+    }
+}
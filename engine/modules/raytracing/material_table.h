@@ -0,0 +1,62 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/material_table.h","purpose":"Declares the raytracer material table that deduplicates materials by value and hands out compact ids.","exports":["MaterialTable"],"depends_on":["material.h","<vector>","<unordered_map>","<cstdint>"],"notes":["value_deduplication","reference_counted_ids","copy_on_write_updates"]}
+// Human Summary
+// Instances reference shading parameters by 32-bit id; identical materials share one entry and edits rewrite in place when the entry is not shared.
+
+#pragma once
+/// @file material_table.h
+/// @brief Deduplicated, reference-counted material storage for the CPU ray tracer.
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "material.h"
+
+/// @brief Value-deduplicated material storage addressed by compact ids.
+class MaterialTable
+{
+public:
+    using MaterialId = uint32_t;
+    static constexpr MaterialId kInvalidId = 0xFFFFFFFFu;
+
+    /// @brief Returns the id of an equal entry, or inserts a new one; the entry's refcount is incremented.
+    /// @param material Shading parameters.
+    /// @param reflectivity Legacy reflection strength paired with the material.
+    MaterialId acquire(const Material& material, float reflectivity);
+
+    /// @brief Drops one reference; unreferenced ids are recycled.
+    void release(MaterialId id);
+
+    /// @brief Changes the material behind one reference.
+    /// @details Rewrites the entry in place when this is its only user; otherwise releases it and
+    /// acquires a matching entry so other users keep their material.
+    /// @return Id the caller should reference from now on.
+    MaterialId update(MaterialId id, const Material& material, float reflectivity);
+
+    /// @brief Returns the material for an id.
+    const Material& material(MaterialId id) const { return m_entries[id].material; }
+
+    /// @brief Returns the legacy reflectivity for an id.
+    float reflectivity(MaterialId id) const { return m_entries[id].reflectivity; }
+
+    /// @brief Returns the number of live entries.
+    size_t size() const { return m_entries.size() - m_freeIds.size(); }
+
+    /// @brief Removes all entries.
+    void clear();
+
+private:
+    struct Entry
+    {
+        Material material;
+        float reflectivity = 0.0f;
+        uint32_t refCount = 0;
+        uint64_t hash = 0;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<MaterialId> m_freeIds;
+    std::unordered_multimap<uint64_t, MaterialId> m_lookup;
+
+    void unlink(MaterialId id);
+};
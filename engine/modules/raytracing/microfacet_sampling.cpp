@@ -24,15 +24,11 @@ namespace
 
 namespace microfacet
 {
-    glm::vec3 sampleBeckmannNormal(const glm::vec3& normal, float roughness, SeededRNG& rng)
+    glm::vec3 sampleBeckmannNormal(const glm::vec3& normal, float roughness, const glm::vec2& u)
     {
         // Clamp roughness to avoid singularities
         const float alpha = std::max(0.001f, roughness * roughness);
         
-        // Generate two uniform random numbers
-        const float u1 = rng.uniform();
-        const float u2 = rng.uniform();
-        
         // Sample Beckmann distribution in spherical coordinates
         // theta is the angle from the normal (polar angle)
         // phi is the azimuthal angle
@@ -41,11 +37,12 @@ namespace microfacet
         // tan²(theta) = -alpha² * ln(u1)
         // phi = 2π * u2
         
-        const float tan2Theta = -alpha * alpha * std::log(std::max(1e-6f, u1));
+        // 1 - u keeps the log argument in (0, 1]
+        const float tan2Theta = -alpha * alpha * std::log(std::max(1e-6f, 1.0f - u.x));
         const float cosTheta = 1.0f / std::sqrt(1.0f + tan2Theta);
         const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
         
-        const float phi = 2.0f * PI * u2;
+        const float phi = 2.0f * PI * u.y;
         const float cosPhi = std::cos(phi);
         const float sinPhi = std::sin(phi);
         
@@ -59,48 +56,27 @@ namespace microfacet
         // Transform from tangent space to world space
         return glm::normalize(tangentToWorld(microfacetTangent, normal, tangent, bitangent));
     }
-    
-    std::vector<glm::vec3> sampleBeckmannNormalsStratified(
-        const glm::vec3& normal, 
-        float roughness, 
-        int sampleCount, 
-        SeededRNG& rng)
+
+    float beckmannReflectionPdf(const glm::vec3& normal, const glm::vec3& viewDir, const glm::vec3& reflectedDir, float roughness)
     {
-        std::vector<glm::vec3> samples;
-        samples.reserve(sampleCount);
-        
-        // Clamp roughness to avoid singularities
+        if (glm::dot(reflectedDir, normal) <= 0.0f)
+            return 0.0f;
+        const glm::vec3 halfVector = viewDir + reflectedDir;
+        const float halfLength = glm::length(halfVector);
+        if (halfLength < 1e-6f)
+            return 0.0f;
+        const glm::vec3 h = halfVector / halfLength;
+        const float cosTheta = glm::dot(h, normal);
+        const float VdotH = glm::dot(viewDir, h);
+        if (cosTheta <= 0.0f || VdotH <= 0.0f)
+            return 0.0f;
+
+        // Same alpha as sampleBeckmannNormal(); D(h) cos(theta_h) is the density of h
         const float alpha = std::max(0.001f, roughness * roughness);
-        
-        // Create orthonormal basis around the surface normal
-        glm::vec3 tangent, bitangent;
-        createOrthonormalBasis(normal, tangent, bitangent);
-        
-        // Generate stratified samples
-        for (int i = 0; i < sampleCount; ++i) {
-            // Stratified sampling with jitter
-            const float jitter1 = rng.uniform();
-            const float jitter2 = rng.uniform();
-            
-            const float u1 = rng.stratified(i, sampleCount, jitter1);
-            const float u2 = rng.stratified(i, sampleCount, jitter2);
-            
-            // Sample Beckmann distribution
-            const float tan2Theta = -alpha * alpha * std::log(std::max(1e-6f, u1));
-            const float cosTheta = 1.0f / std::sqrt(1.0f + tan2Theta);
-            const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
-            
-            const float phi = 2.0f * PI * u2;
-            const float cosPhi = std::cos(phi);
-            const float sinPhi = std::sin(phi);
-            
-            // Convert to Cartesian coordinates in tangent space
-            const glm::vec3 microfacetTangent(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
-            
-            // Transform to world space and add to samples
-            samples.push_back(glm::normalize(tangentToWorld(microfacetTangent, normal, tangent, bitangent)));
-        }
-        
-        return samples;
+        const float cos2 = cosTheta * cosTheta;
+        const float tan2 = (1.0f - cos2) / cos2;
+        const float D = std::exp(-tan2 / (alpha * alpha)) / (PI * alpha * alpha * cos2 * cos2);
+        // Jacobian of the reflection about h
+        return D * cosTheta / (4.0f * VdotH);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/path_integrator.h","purpose":"Declares integrator selection, path tracer settings, and the explicit per-path state carried by the iterative path integrator.","exports":["IntegratorType","PathTracerSettings","PathState","integratorTypeName","parseIntegratorType"],"depends_on":["glm/glm.hpp","<string>"],"notes":["one_continuation_ray_per_bounce","russian_roulette","state_is_batchable"]}
+// Human Summary
+// Chooses between the recursive Whitted tracer and the loop-based path tracer; PathState holds everything a path needs between bounces so paths can later be queued and traced in batches.
+
+#pragma once
+/// @file path_integrator.h
+/// @brief Integrator selection and path state for the CPU ray tracer.
+
+#include <string>
+#include <glm/glm.hpp>
+
+/// @brief Light transport algorithm used by Raytracer::renderImage().
+enum class IntegratorType
+{
+    Whitted, ///< Recursive tracer; branches into every glossy and refraction sample at each hit.
+    Path     ///< Iterative path tracer with one continuation ray per bounce; cost is linear in samples.
+};
+
+/// @brief Parameters of the path integrator.
+struct PathTracerSettings
+{
+    IntegratorType integrator = IntegratorType::Whitted;
+    int maxBounces = 8;           ///< Continuation rays per path after the camera ray.
+    int rouletteStartBounce = 3;  ///< First bounce at which Russian roulette may end a path.
+};
+
+/// @brief Everything a path carries from one bounce to the next.
+/// @details Plain values only, with no pointers into the call stack, so paths can be stored in queues and
+/// advanced in batches.
+struct PathState
+{
+    glm::vec3 origin{0.0f};         ///< Origin of the next ray to trace.
+    glm::vec3 direction{0.0f};      ///< Normalized direction of the next ray.
+    glm::vec3 throughput{1.0f};     ///< Product of lobe weights divided by their selection probabilities.
+    glm::vec3 radiance{0.0f};       ///< Radiance gathered so far.
+    float lobePdf = 0.0f;           ///< Density of the direction when it came from a glossy lobe, for MIS with
+                                    ///< environment sampling; 0 for camera, mirror, and refraction rays.
+    int bounce = 0;                 ///< Vertices shaded so far.
+    bool active = true;             ///< False once the path escaped, was absorbed, or was terminated.
+
+    PathState(const glm::vec3& rayOrigin, const glm::vec3& rayDirection)
+        : origin(rayOrigin), direction(rayDirection) {}
+};
+
+/// @brief Returns the lowercase name used by the CLI ("whitted", "path").
+inline const char* integratorTypeName(IntegratorType type)
+{
+    return type == IntegratorType::Path ? "path" : "whitted";
+}
+
+/// @brief Parses an integrator name.
+/// @return False when the name is not recognised; @p type is left unchanged.
+inline bool parseIntegratorType(const std::string& name, IntegratorType& type)
+{
+    if (name == "whitted") { type = IntegratorType::Whitted; return true; }
+    if (name == "path") { type = IntegratorType::Path; return true; }
+    return false;
+}
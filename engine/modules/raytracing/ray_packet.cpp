@@ -0,0 +1,119 @@
+#include "ray_packet.h"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(__EMSCRIPTEN__)
+#define GLINT_RT_PACKET_SSE 1
+#include <emmintrin.h>
+#else
+#define GLINT_RT_PACKET_SSE 0
+#endif
+
+void RayPacket::finalize(uint32_t activeMask)
+{
+    invDirMin = glm::vec3(FLT_MAX);
+    invDirMax = glm::vec3(-FLT_MAX);
+    int positive[3] = {0, 0, 0};
+    int negative[3] = {0, 0, 0};
+
+    float* dirs[3] = {dx, dy, dz};
+    float* invs[3] = {idx, idy, idz};
+    for (int i = 0; i < kSize; ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            // Same clamping as RayTraversalData so box tests match single-ray traversal exactly
+            float d = dirs[axis][i];
+            if (std::abs(d) < 1e-12f) d = std::copysign(1e-12f, d);
+            const float inv = 1.0f / d;
+            invs[axis][i] = inv;
+
+            if (!(activeMask & (1u << i)))
+                continue;
+            invDirMin[axis] = std::min(invDirMin[axis], inv);
+            invDirMax[axis] = std::max(invDirMax[axis], inv);
+            if (inv < 0.0f) negative[axis]++;
+            else positive[axis]++;
+        }
+    }
+
+    coherent = activeMask != 0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        dirIsNeg[axis] = negative[axis] > 0 ? 1 : 0;
+        if (negative[axis] > 0 && positive[axis] > 0)
+            coherent = false;
+    }
+}
+
+bool packetMayHitBounds(const LinearBVHNode& node, const RayPacket& packet)
+{
+    // With a shared origin each slab distance is (plane - origin) * invDir; multiplying the
+    // scalar offset by the packet's reciprocal interval bounds every ray's entry and exit.
+    float enter = 0.0f;
+    float exit = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float nearPlane = packet.dirIsNeg[axis] ? node.boundsMax[axis] : node.boundsMin[axis];
+        const float farPlane = packet.dirIsNeg[axis] ? node.boundsMin[axis] : node.boundsMax[axis];
+        const float a = nearPlane - packet.origin[axis];
+        const float b = farPlane - packet.origin[axis];
+        enter = std::max(enter, std::min(a * packet.invDirMin[axis], a * packet.invDirMax[axis]));
+        exit = std::min(exit, std::max(b * packet.invDirMin[axis], b * packet.invDirMax[axis]));
+    }
+    return enter <= exit;
+}
+
+uint32_t intersectPacketBounds(const LinearBVHNode& node, const RayPacket& packet, uint32_t mask)
+{
+    uint32_t result = 0;
+
+#if GLINT_RT_PACKET_SSE
+    const __m128 minX = _mm_set1_ps(node.boundsMin.x - packet.origin.x);
+    const __m128 minY = _mm_set1_ps(node.boundsMin.y - packet.origin.y);
+    const __m128 minZ = _mm_set1_ps(node.boundsMin.z - packet.origin.z);
+    const __m128 maxX = _mm_set1_ps(node.boundsMax.x - packet.origin.x);
+    const __m128 maxY = _mm_set1_ps(node.boundsMax.y - packet.origin.y);
+    const __m128 maxZ = _mm_set1_ps(node.boundsMax.z - packet.origin.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (int i = 0; i < RayPacket::kSize; i += 4)
+    {
+        const uint32_t groupMask = (mask >> i) & 0xFu;
+        if (!groupMask)
+            continue;
+
+        const __m128 ix = _mm_load_ps(packet.idx + i);
+        const __m128 iy = _mm_load_ps(packet.idy + i);
+        const __m128 iz = _mm_load_ps(packet.idz + i);
+        const __m128 t0x = _mm_mul_ps(minX, ix), t1x = _mm_mul_ps(maxX, ix);
+        const __m128 t0y = _mm_mul_ps(minY, iy), t1y = _mm_mul_ps(maxY, iy);
+        const __m128 t0z = _mm_mul_ps(minZ, iz), t1z = _mm_mul_ps(maxZ, iz);
+
+        __m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+                                  _mm_max_ps(_mm_min_ps(t0z, t1z), zero));
+        __m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+                                 _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_load_ps(packet.tMax + i)));
+
+        const uint32_t hits = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(enter, exit)));
+        result |= (hits & groupMask) << i;
+    }
+#else
+    for (int i = 0; i < RayPacket::kSize; ++i)
+    {
+        if (!(mask & (1u << i)))
+            continue;
+        const glm::vec3 invDir(packet.idx[i], packet.idy[i], packet.idz[i]);
+        glm::vec3 t0 = (node.boundsMin - packet.origin) * invDir;
+        glm::vec3 t1 = (node.boundsMax - packet.origin) * invDir;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, packet.tMax[i]));
+        if (enter <= exit)
+            result |= 1u << i;
+    }
+#endif
+
+    return result;
+}
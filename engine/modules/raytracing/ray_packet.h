@@ -0,0 +1,104 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/ray_packet.h","purpose":"Declares common-origin ray packets and the packet BVH traversal used for coherent primary rays.","exports":["RayPacket","packetMayHitBounds","intersectPacketBounds","traversePacket"],"depends_on":["linear_bvh.h","glm/glm.hpp","<cstdint>"],"notes":["4x4_pixel_blocks","interval_arithmetic_frustum_cull","sse_per_ray_box_tests","requires_uniform_direction_signs"]}
+// Human Summary
+// Sixteen rays sharing an origin are walked through a BVH together: whole packets are culled against node boxes with interval bounds, then survivors are tested four at a time.
+
+#pragma once
+/// @file ray_packet.h
+/// @brief Coherent ray packets and packet traversal of the flattened BVH.
+
+#include <cfloat>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "linear_bvh.h"
+
+/// @brief Sixteen rays (a 4x4 pixel block) sharing one origin, stored as structure of arrays.
+struct RayPacket
+{
+    static constexpr int kBlockSize = 4;                     ///< Pixels per block edge.
+    static constexpr int kSize = kBlockSize * kBlockSize;    ///< Rays per packet.
+    static constexpr uint32_t kAllRays = (1u << kSize) - 1;  ///< Mask with every ray active.
+
+    glm::vec3 origin{0.0f};
+    alignas(16) float dx[kSize], dy[kSize], dz[kSize];       ///< Directions (not necessarily normalized).
+    alignas(16) float idx[kSize], idy[kSize], idz[kSize];    ///< Reciprocal directions.
+    alignas(16) float tMax[kSize];                           ///< Closest hit so far per ray.
+
+    glm::vec3 invDirMin{0.0f};   ///< Per-axis minimum reciprocal direction over active rays.
+    glm::vec3 invDirMax{0.0f};   ///< Per-axis maximum reciprocal direction over active rays.
+    int dirIsNeg[3] = {0, 0, 0}; ///< Shared direction signs (valid when coherent).
+    bool coherent = false;       ///< True when all active rays share direction signs.
+
+    /// @brief Returns one ray's direction.
+    glm::vec3 direction(int i) const { return glm::vec3(dx[i], dy[i], dz[i]); }
+
+    /// @brief Sets one ray's direction.
+    void setDirection(int i, const glm::vec3& d) { dx[i] = d.x; dy[i] = d.y; dz[i] = d.z; }
+
+    /// @brief Computes reciprocal directions, interval bounds, and the coherence flag.
+    /// @details Reciprocals are clamped exactly like RayTraversalData so packet and single-ray
+    /// traversal agree on every box test.
+    void finalize(uint32_t activeMask);
+};
+
+/// @brief Conservative whole-packet test: false only if no active ray can enter the box.
+/// @details Uses interval arithmetic over the packet's reciprocal directions, which is valid
+/// because all rays share the origin and direction signs.
+bool packetMayHitBounds(const LinearBVHNode& node, const RayPacket& packet);
+
+/// @brief Per-ray slab tests for the rays in @p mask, limited to each ray's tMax.
+/// @return Mask of rays whose interval overlaps the box.
+uint32_t intersectPacketBounds(const LinearBVHNode& node, const RayPacket& packet, uint32_t mask);
+
+/// @brief Walks a BVH with a coherent packet, carrying an active-ray mask down the tree.
+/// @param leaf Callback invoked as leaf(node, mask) with the rays that reached the leaf.
+template <typename LeafFn>
+void traversePacket(const LinearBVH& bvh, const RayPacket& packet, uint32_t activeMask,
+                    BVHTraversalStats& stats, LeafFn&& leaf)
+{
+    if (bvh.empty() || !activeMask)
+        return;
+
+    struct StackEntry { uint32_t node; uint32_t mask; };
+    StackEntry stack[LinearBVH::kStackSize];
+    int stackSize = 0;
+    uint32_t current = 0;
+    uint32_t mask = activeMask;
+
+    while (true)
+    {
+        const LinearBVHNode& node = bvh.nodes[current];
+        stats.nodesVisited++;
+
+        const uint32_t hitMask = packetMayHitBounds(node, packet) ? intersectPacketBounds(node, packet, mask) : 0u;
+        if (hitMask)
+        {
+            if (node.isLeaf())
+            {
+                leaf(node, hitMask);
+            }
+            else
+            {
+                // Shared direction signs give every ray the same near child
+                if (packet.dirIsNeg[node.axis])
+                {
+                    stack[stackSize++] = {current + 1, hitMask};
+                    current = node.offset;
+                }
+                else
+                {
+                    stack[stackSize++] = {node.offset, hitMask};
+                    current = current + 1;
+                }
+                mask = hitMask;
+                continue;
+            }
+        }
+
+        if (stackSize == 0)
+            break;
+        --stackSize;
+        current = stack[stackSize].node;
+        mask = stack[stackSize].mask;
+    }
+}
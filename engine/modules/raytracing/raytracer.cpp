@@ -3,139 +3,465 @@
 #include <glm/glm.hpp>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include "brdf.h"
+#include "image_io.h"
 
-Raytracer::Raytracer()
-    : lightPos(glm::vec3(-2.0f, 4.0f, -3.0f)),
-    lightColor(glm::vec3(1.0f, 1.0f, 1.0f)),
-    bvhRoot(nullptr)
-{}
-
-// Build BVH
-static BVHNode* buildBVH(std::vector<const Triangle*>& tris, int depth = 0)
+namespace
 {
-    if (tris.empty())
-        return nullptr;
+    // Per-thread counters; traceRay is const and called concurrently, so rays accumulate
+    // locally and renderImage() gathers them once per tile.
+    struct ThreadRayCounters
+    {
+        BVHTraversalStats traversal;
+        uint64_t rays = 0;
+        BVHTraversalStats shadowTraversal;
+        uint64_t shadowRays = 0;
+        uint64_t shadowRaysBlocked = 0;
+    };
 
-    BVHNode* node = new BVHNode();
+    thread_local ThreadRayCounters t_rayCounters;
 
-    glm::vec3 minBox(FLT_MAX), maxBox(-FLT_MAX);
-    for (auto tri : tris)
+    const glm::vec3 kLumaWeights(0.2126f, 0.7152f, 0.0722f);
+
+    uint32_t pixelKey(int x, int y, int width)
     {
-        for (const glm::vec3& v : { tri->v0, tri->v1, tri->v2 })
-        {
-            minBox = glm::min(minBox, v);
-            maxBox = glm::max(maxBox, v);
-        }
+        return static_cast<uint32_t>(y) * static_cast<uint32_t>(width) + static_cast<uint32_t>(x);
     }
-    node->boundsMin = minBox;
-    node->boundsMax = maxBox;
 
-    if (tris.size() <= 4)
+    // Flat background used when no environment map is set
+    const glm::vec3 kBackground(0.05f);
+
+    glm::vec3 sampleCosineHemisphere(const glm::vec3& normal, const glm::vec2& u)
     {
-        node->triangles = tris;
-        return node;
+        const float r = std::sqrt(u.x);
+        const float phi = 2.0f * glm::pi<float>() * u.y;
+        const glm::vec3 up = std::abs(normal.y) < 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        const glm::vec3 tangent = glm::normalize(glm::cross(normal, up));
+        const glm::vec3 bitangent = glm::cross(normal, tangent);
+        return glm::normalize(tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi)) +
+                              normal * std::sqrt(std::max(0.0f, 1.0f - u.x)));
     }
+}
 
-    int axis = depth % 3;
-    std::sort(tris.begin(), tris.end(), [axis](const Triangle* a, const Triangle* b)
-        {
-            float centerA = (a->v0[axis] + a->v1[axis] + a->v2[axis]) / 3.0f;
-            float centerB = (b->v0[axis] + b->v1[axis] + b->v2[axis]) / 3.0f;
-            return centerA < centerB;
-        });
+Raytracer::Raytracer()
+    : lightPos(glm::vec3(-2.0f, 4.0f, -3.0f)),
+    lightColor(glm::vec3(1.0f, 1.0f, 1.0f))
+{
+    // Mesh leaves hold up to two triangle packets so the AVX2 kernel tests a whole leaf at once
+    m_bvhSettings.maxLeafSize = 2 * TrianglePacket::kWidth;
+}
+
+Raytracer::~Raytracer() = default;
+
+void Raytracer::commit()
+{
+    if (!m_scene.needsBuild())
+        return;
+
+    // Builds share the render threads; commits happen between renders, never inside one
+    if (!m_threadPool)
+        m_threadPool = std::make_unique<ThreadPool>(m_tileSettings.threadCount);
+    m_scene.build(m_bvhSettings, m_threadPool.get());
+    // Cached camera hits index the old hierarchy and may no longer be the closest ones
+    m_gbuffer.clear();
+
+    const TwoLevelBVHStats& stats = m_scene.stats();
+    std::cout << "[Raytracer] Acceleration structure: " << stats.instanceCount << " instances of "
+              << stats.meshCount << " meshes (" << stats.uniqueTriangles << " unique / "
+              << stats.instancedTriangles << " instanced triangles, " << stats.packetBytes / 1024
+              << " KiB packets, " << triangleKernelName(m_scene.triangleKernel()) << " kernel, "
+              << m_materials.size() << " materials); built " << stats.meshesBuilt
+              << " mesh BVHs (" << bvhBuildAlgorithmName(m_bvhSettings.algorithm) << ", " << stats.meshesFromCache
+              << " from cache, " << m_threadPool->threadCount() << " threads) in " << stats.meshBuildTimeMs
+              << " ms, top level in " << stats.topLevel.buildTimeMs << " ms\n";
+}
+
+void Raytracer::setBVHBuildSettings(const BVHBuildSettings& settings)
+{
+    if (settings == m_bvhSettings)
+        return;
+    m_bvhSettings = settings;
+    m_scene.invalidateMeshes();
+}
+
+void Raytracer::setBVHBuildAlgorithm(BVHBuildAlgorithm algorithm)
+{
+    BVHBuildSettings settings = m_bvhSettings;
+    settings.algorithm = algorithm;
+    setBVHBuildSettings(settings);
+}
+
+void Raytracer::setGBufferCacheEnabled(bool enabled)
+{
+    m_gbufferEnabled = enabled;
+    if (!enabled)
+        m_gbuffer.clear();
+}
+
+bool Raytracer::loadEnvironmentMap(const std::string& path)
+{
+    ImageIO::ImageDataFloat image;
+    auto environment = std::make_shared<EnvironmentMap>();
+    if (!ImageIO::LoadImageFloat(path, image, /*flipY=*/true) ||
+        !environment->build(image.pixels.data(), image.width, image.height, image.channels))
+        return false;
+    setEnvironmentMap(std::move(environment));
+    std::cout << "[Raytracer] Environment light: " << image.width << "x" << image.height << "\n";
+    return true;
+}
+
+void Raytracer::setBVHCacheDirectory(const std::filesystem::path& directory)
+{
+    const BVHCache* current = m_scene.cache();
+    if (current ? current->directory() == directory : directory.empty())
+        return;
+    m_scene.setCache(directory.empty() ? nullptr : std::make_shared<BVHCache>(directory));
+}
 
-    size_t mid = tris.size() / 2;
-    std::vector<const Triangle*> leftTris(tris.begin(), tris.begin() + mid);
-    std::vector<const Triangle*> rightTris(tris.begin() + mid, tris.end());
+bool Raytracer::intersectClosest(const Ray& ray, InstanceHit& hit) const
+{
+    ThreadRayCounters& counters = t_rayCounters;
+    counters.rays++;
+    return m_scene.intersect(ray, hit, counters.traversal);
+}
 
-    node->left = buildBVH(leftTris, depth + 1);
-    node->right = buildBVH(rightTris, depth + 1);
+bool Raytracer::occluded(const glm::vec3& origin, const glm::vec3& direction, float tMax) const
+{
+    ThreadRayCounters& counters = t_rayCounters;
+    counters.shadowRays++;
+    Ray ray(origin, direction);
+    ray.direction = direction;
+    const bool blocked = m_scene.occluded(ray, tMax, counters.shadowTraversal);
+    counters.shadowRaysBlocked += blocked ? 1 : 0;
+    return blocked;
+}
 
-    return node;
+uint32_t Raytracer::occludedBatch(const glm::vec3& origin, const glm::vec3* directions, const float* tMax, uint32_t count) const
+{
+    ThreadRayCounters& counters = t_rayCounters;
+    count = std::min(count, kMaxOcclusionBatch);
+    counters.shadowRays += count;
+    const uint32_t blocked = m_scene.occludedBatch(origin, directions, tMax, count, counters.shadowTraversal);
+    for (uint32_t bits = blocked; bits; bits &= bits - 1)
+        counters.shadowRaysBlocked++;
+    return blocked;
 }
 
 // --- Simplified Ray Tracer ---
 glm::vec3 Raytracer::traceRay(const Ray& ray, const Light& lights, int depth) const
+{
+    // Outside renderImage() there is no pixel, so the ray itself keys the sample sequence
+    uint32_t key = 0;
+    const float components[6] = {ray.origin.x, ray.origin.y, ray.origin.z, ray.direction.x, ray.direction.y, ray.direction.z};
+    for (float c : components)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &c, sizeof(bits));
+        key = sampling::hashCombine(key, bits);
+    }
+    sampling::PixelSampler sampler(m_samplerType, m_seed, key, 0);
+    return traceSample(ray, lights, depth, sampler);
+}
+
+glm::vec3 Raytracer::traceSample(const Ray& ray, const Light& lights, int depth, sampling::PixelSampler& sampler,
+                                  float lobePdf) const
 {
     if (depth > 2)
         return glm::vec3(0.0f);
 
-    float tMin = FLT_MAX;
-    glm::vec3 hitNormal;
-    const Triangle* hitObject = nullptr;
+    InstanceHit hit;
+    if (!intersectClosest(ray, hit))
+        return background(ray.direction, lobePdf);
+
+    return shadeHit(ray, hit, lights, depth, sampler);
+}
+
+glm::vec3 Raytracer::background(const glm::vec3& direction, float lobePdf) const
+{
+    if (!m_environment)
+        return kBackground;
+
+    const glm::vec3 radiance = m_environment->eval(direction) * m_environmentIntensity;
+    if (lobePdf <= 0.0f)
+        return radiance;
+    return radiance * sampling::powerHeuristic(lobePdf, m_environment->pdf(direction));
+}
+
+glm::vec3 Raytracer::environmentLighting(const glm::vec3& hitPoint, const glm::vec3& normal, const glm::vec3& viewDir,
+                                         const Material& material, const glm::vec2& lightSample, const glm::vec2& bsdfSample) const
+{
+    // The BSDF is sampled as a mix of a cosine lobe for diffuse and the Beckmann lobe for specular
+    const float diffuseProbability = glm::clamp(1.0f - material.metallic, 0.1f, 0.9f);
+    const auto bsdfPdf = [&](const glm::vec3& direction) {
+        const float cosTheta = std::max(0.0f, glm::dot(direction, normal));
+        return diffuseProbability * cosTheta / glm::pi<float>() +
+               (1.0f - diffuseProbability) * microfacet::beckmannReflectionPdf(normal, viewDir, direction, material.roughness);
+    };
+    const glm::vec3 origin = hitPoint + normal * 0.001f;
+    glm::vec3 result(0.0f);
+
+    // Environment sample
+    const EnvironmentSample light = m_environment->sample(lightSample);
+    if (light.pdf > 0.0f && glm::dot(light.direction, normal) > 0.0f && !occluded(origin, light.direction, FLT_MAX))
+    {
+        const glm::vec3 f = raytracer::LightingSystem::evaluateMaterial(
+            material, normal, viewDir, light.direction, light.radiance * m_environmentIntensity).color;
+        result += f * sampling::powerHeuristic(light.pdf, bsdfPdf(light.direction)) / light.pdf;
+    }
 
-    // BVH or brute-force
-    if (bvhRoot)
-        bvhRoot->intersect(ray, hitObject, tMin, hitNormal);
+    // BSDF sample; the first coordinate picks the lobe and is rescaled for reuse
+    glm::vec3 direction;
+    glm::vec2 u = bsdfSample;
+    if (u.x < diffuseProbability)
+    {
+        u.x /= diffuseProbability;
+        direction = sampleCosineHemisphere(normal, u);
+    }
     else
     {
-        for (const auto& tri : triangles)
-        {
-            float t;
-            glm::vec3 normal;
-            if (tri.intersect(ray, t, normal) && t < tMin)
-            {
-                tMin = t;
-                hitNormal = normal;
-                hitObject = &tri;
-            }
-        }
+        u.x = (u.x - diffuseProbability) / (1.0f - diffuseProbability);
+        direction = microfacet::reflect(-viewDir, microfacet::sampleBeckmannNormal(normal, material.roughness, u));
     }
+    const float pdf = bsdfPdf(direction);
+    if (pdf > 0.0f && glm::dot(direction, normal) > 0.0f && !occluded(origin, direction, FLT_MAX))
+    {
+        const glm::vec3 radiance = m_environment->eval(direction) * m_environmentIntensity;
+        const glm::vec3 f = raytracer::LightingSystem::evaluateMaterial(material, normal, viewDir, direction, radiance).color;
+        result += f * sampling::powerHeuristic(pdf, m_environment->pdf(direction)) / pdf;
+    }
+    return result;
+}
+
+glm::vec3 Raytracer::environmentReflection(const glm::vec3& hitPoint, const glm::vec3& normal, const glm::vec3& viewDir,
+                                           float roughness, const glm::vec2& u) const
+{
+    const EnvironmentSample light = m_environment->sample(u);
+    if (light.pdf <= 0.0f)
+        return glm::vec3(0.0f);
+    const float lobePdf = microfacet::beckmannReflectionPdf(normal, viewDir, light.direction, roughness);
+    if (lobePdf <= 0.0f || occluded(hitPoint + normal * 0.001f, light.direction, FLT_MAX))
+        return glm::vec3(0.0f);
+    // The lobe is the integrand's own weight, so it appears as a ratio of densities
+    return light.radiance * m_environmentIntensity * (lobePdf / light.pdf) *
+           sampling::powerHeuristic(light.pdf, lobePdf);
+}
 
-    if (!hitObject)
-        return glm::vec3(0.05f); // slightly dark background
+raytracer::LightSelection Raytracer::lightSelection(const Light& lights, sampling::PixelSampler& sampler) const
+{
+    raytracer::LightSelection selection;
+    // Only the light list of the running render has a matching sampler
+    if (m_lightSamplerSource != &lights || !m_lightSampler.active())
+        return selection;
+    selection.sampler = &m_lightSampler;
+    selection.pixelSampler = &sampler;
+    selection.dimension = sampler.nextDimension();
+    return selection;
+}
 
-    glm::vec3 hitPoint = ray.origin + tMin * ray.direction;
+glm::vec3 Raytracer::shadeHit(const Ray& ray, const InstanceHit& hit, const Light& lights, int depth,
+                              sampling::PixelSampler& sampler) const
+{
+    const BVHInstance& instance = m_scene.instances()[hit.instanceIndex];
+    glm::vec3 hitPoint = ray.origin + hit.t * ray.direction;
     glm::vec3 viewDir = glm::normalize(-ray.direction);
-    glm::vec3 normal = glm::normalize(hitNormal);
+    glm::vec3 normal = m_scene.shadingNormal(hit);
 
-    const Material& mat = hitObject->material;
+    const Material& mat = m_materials.material(instance.materialId);
 
     // Use the new modular lighting system
+    const raytracer::LightSelection selection = lightSelection(lights, sampler);
     glm::vec3 color = raytracer::LightingSystem::computeLighting(
-        hitPoint, normal, viewDir, mat, lights, *this
+        hitPoint, normal, viewDir, mat, lights, *this, &selection
     );
+    if (m_environment)
+    {
+        const glm::vec2 lightSample = sampler.get2D();
+        color += environmentLighting(hitPoint, normal, viewDir, mat, lightSample, sampler.get2D());
+    }
 
     // Handle transparent materials (refraction)
     if (mat.transmission > 0.01f) {
-        glm::vec3 refractedColor = computeRefraction(hitPoint, ray.direction, normal, mat, lights, depth);
+        glm::vec3 refractedColor = computeRefraction(hitPoint, ray.direction, normal, mat, lights, depth, sampler);
         
         // Mix base color with refracted color based on transmission
         color = glm::mix(color, refractedColor, mat.transmission);
     }
     
     // Reflective contribution based on material properties
-    float effectiveReflectivity = std::max(hitObject->reflectivity, mat.metallic * 0.9f);
-    if (effectiveReflectivity > 0.01f)
-    {
-        // Create RNG for this pixel (deterministic based on ray origin and direction)
-        uint32_t pixelSeed = m_seed;
-        // Mix in ray origin and direction for deterministic per-pixel seeds
-        pixelSeed ^= std::hash<float>{}(hitPoint.x + hitPoint.y + hitPoint.z);
-        pixelSeed ^= std::hash<float>{}(ray.direction.x + ray.direction.y + ray.direction.z);
-        microfacet::SeededRNG rng(pixelSeed);
-        
+    const float reflectionStrength = reflectionWeight(instance.materialId, mat);
+    if (reflectionStrength > 0.0f)
+    {
         glm::vec3 reflectedColor = sampleGlossyReflection(
-            hitPoint, viewDir, normal, mat, lights, depth, rng
+            hitPoint, viewDir, normal, mat, lights, depth, sampler
         );
+        color = glm::mix(color, reflectedColor, reflectionStrength);
+    }
 
-        // For metals, reflection is more prominent
-        float reflectionStrength = effectiveReflectivity;
-        if (mat.metallic > 0.5f) {
-            reflectionStrength = std::min(1.0f, effectiveReflectivity * 1.5f);
+    // Leave color in linear space; screen shader applies tone mapping and gamma
+    return glm::clamp(color, 0.0f, 1.0f);
+}
+
+float Raytracer::reflectionWeight(uint32_t materialId, const Material& mat) const
+{
+    float effectiveReflectivity = std::max(m_materials.reflectivity(materialId), mat.metallic * 0.9f);
+    if (effectiveReflectivity <= 0.01f)
+        return 0.0f;
+
+    // For metals, reflection is more prominent
+    float reflectionStrength = effectiveReflectivity;
+    if (mat.metallic > 0.5f) {
+        reflectionStrength = std::min(1.0f, effectiveReflectivity * 1.5f);
+    }
+
+    // For transparent materials, reduce reflection strength to avoid over-brightening
+    if (mat.transmission > 0.01f) {
+        reflectionStrength *= (1.0f - mat.transmission * 0.5f);
+    }
+    return reflectionStrength;
+}
+
+glm::vec3 Raytracer::tracePath(PathState& path, const Light& lights, sampling::PixelSampler& sampler,
+                               const InstanceHit* cameraHit) const
+{
+    while (path.active)
+        advancePath(path, lights, sampler, path.bounce == 0 ? cameraHit : nullptr);
+    return path.radiance;
+}
+
+void Raytracer::advancePath(PathState& path, const Light& lights, sampling::PixelSampler& sampler,
+                            const InstanceHit* knownHit) const
+{
+    Ray ray(path.origin, path.direction);
+    ray.direction = path.direction;
+    InstanceHit hit;
+    if (knownHit)
+        hit = *knownHit;
+    else if (!intersectClosest(ray, hit))
+    {
+        path.radiance += path.throughput * background(path.direction, path.lobePdf);
+        path.active = false;
+        return;
+    }
+
+    const BVHInstance& instance = m_scene.instances()[hit.instanceIndex];
+    const glm::vec3 hitPoint = path.origin + hit.t * path.direction;
+    const glm::vec3 viewDir = -path.direction;
+    const glm::vec3 normal = m_scene.shadingNormal(hit);
+    const Material& mat = m_materials.material(instance.materialId);
+
+    // The Whitted tracer blends lit surface D, transmission T, and reflection R as
+    // (1 - r) * ((1 - t) * D + t * T) + r * R. D is evaluated at every vertex; one of the
+    // other lobes is continued with probability proportional to its weight.
+    const float transmission = mat.transmission > 0.01f ? mat.transmission : 0.0f;
+    const float reflection = reflectionWeight(instance.materialId, mat);
+    const float directWeight = (1.0f - reflection) * (1.0f - transmission);
+
+    // Every bounce draws the same dimensions so paths stay aligned in the sample sequence
+    const glm::vec2 lobeSample = sampler.get2D();
+    const glm::vec2 directionSample = sampler.get2D();
+    glm::vec2 environmentSamples[3];
+    if (m_environment)
+    {
+        for (glm::vec2& u : environmentSamples)
+            u = sampler.get2D();
+    }
+    const raytracer::LightSelection selection = lightSelection(lights, sampler);
+
+    if (directWeight > 0.0f)
+    {
+        glm::vec3 direct = raytracer::LightingSystem::computeLighting(hitPoint, normal, viewDir, mat, lights, *this, &selection);
+        if (m_environment)
+            direct += environmentLighting(hitPoint, normal, viewDir, mat, environmentSamples[0], environmentSamples[1]);
+        path.radiance += path.throughput * directWeight * glm::clamp(direct, 0.0f, 1.0f);
+    }
+
+    const float transmitWeight = (1.0f - reflection) * transmission;
+    const float continueWeight = reflection + transmitWeight;
+    path.bounce++;
+    if (continueWeight <= 0.0f || path.bounce > m_pathSettings.maxBounces)
+    {
+        path.active = false;
+        return;
+    }
+
+    // The glossy lobe's view of the environment is also sampled from the environment side; the
+    // continuation ray is weighted to match when it escapes
+    const bool glossy = !microfacet::shouldUsePerfectMirror(mat.roughness);
+    if (m_environment && reflection > 0.0f && glossy)
+        path.radiance += path.throughput * reflection * environmentReflection(hitPoint, normal, viewDir, mat.roughness, environmentSamples[2]);
+
+    path.throughput *= continueWeight;
+    path.lobePdf = 0.0f;
+
+    const float lobe = lobeSample.x * continueWeight;
+    if (lobe < reflection)
+    {
+        glm::vec3 reflectedDir = glm::reflect(-viewDir, normal);
+        if (glossy)
+        {
+            const glm::vec3 microfacetNormal = microfacet::sampleBeckmannNormal(normal, mat.roughness, directionSample);
+            const glm::vec3 glossyDir = microfacet::reflect(-viewDir, microfacetNormal);
+            // As in sampleGlossyReflection(), samples below the surface count as zero when the
+            // environment is MIS-sampled, and otherwise fall back to the mirror direction
+            if (glm::dot(glossyDir, normal) > 0.0f)
+            {
+                reflectedDir = glossyDir;
+                if (m_environment)
+                    path.lobePdf = microfacet::beckmannReflectionPdf(normal, viewDir, glm::normalize(glossyDir), mat.roughness);
+            }
+            else if (m_environment)
+            {
+                path.active = false;
+                return;
+            }
         }
+        path.origin = hitPoint + normal * 0.001f;
+        path.direction = glm::normalize(reflectedDir);
+    }
+    else
+    {
+        float ior1, ior2;
+        glm::vec3 adjustedNormal;
+        refraction::determineMediaTransition(path.direction, normal, mat.ior, ior1, ior2, adjustedNormal);
+        const float cosTheta = std::abs(glm::dot(-path.direction, adjustedNormal));
+        const float fresnel = refraction::fresnelSchlick(cosTheta, ior1, ior2);
 
-        // For transparent materials, reduce reflection strength to avoid over-brightening
-        if (mat.transmission > 0.01f) {
-            reflectionStrength *= (1.0f - mat.transmission * 0.5f);
+        // Reuse the lobe sample, rescaled to [0, 1), to pick Fresnel reflection over refraction
+        const float fresnelSample = (lobe - reflection) / transmitWeight;
+        glm::vec3 refractedDir;
+        if (fresnelSample >= fresnel && refraction::refract(path.direction, adjustedNormal, ior1, ior2, refractedDir))
+        {
+            path.origin = hitPoint - adjustedNormal * 0.001f;
+            path.direction = glm::normalize(refractedDir);
         }
+        else
+        {
+            path.origin = hitPoint + adjustedNormal * 0.001f;
+            path.direction = glm::normalize(glm::reflect(path.direction, adjustedNormal));
+        }
+    }
 
-        color = glm::mix(color, reflectedColor, reflectionStrength);
+    // Russian roulette: survivors are reweighted so the estimate stays unbiased
+    if (path.bounce >= m_pathSettings.rouletteStartBounce)
+    {
+        const float survival = std::min(0.95f, std::max(path.throughput.x, std::max(path.throughput.y, path.throughput.z)));
+        if (lobeSample.y >= survival)
+        {
+            path.active = false;
+            return;
+        }
+        path.throughput /= survival;
     }
+}
 
-    // Leave color in linear space; screen shader applies tone mapping and gamma
-    return glm::clamp(color, 0.0f, 1.0f);
+void Raytracer::setPathTracerSettings(const PathTracerSettings& settings)
+{
+    m_pathSettings = settings;
+    m_pathSettings.maxBounces = std::max(0, settings.maxBounces);
+    m_pathSettings.rouletteStartBounce = std::max(1, settings.rouletteStartBounce);
 }
 
 void Raytracer::renderImage(std::vector<glm::vec3>& out,
@@ -146,75 +472,514 @@ void Raytracer::renderImage(std::vector<glm::vec3>& out,
     float fovDeg,
     const Light& lights)
 {
+    if (m_scene.needsBuild())
+        commit();
+
+    auto renderStart = std::chrono::steady_clock::now();
+    m_lightSampler.build(lights.m_lights, m_lightSamplingSettings);
+    m_lightSamplerSource = &lights;
+    m_renderStats = RaytraceRenderStats();
+    std::atomic<uint64_t> totalRays{0}, nodesVisited{0}, trianglesTested{0};
+    std::atomic<uint64_t> shadowRays{0}, shadowRaysBlocked{0}, shadowNodesVisited{0};
+
     const float aspect = float(W) / float(H);
     const float scale = tan(glm::radians(fovDeg * 0.5f));
 
     glm::vec3 right = glm::normalize(glm::cross(camFront, camUp));
     glm::vec3 up = glm::normalize(glm::cross(right, camFront));
 
-    glm::vec3 imageCenter = camFront;
-    glm::vec3 imageRight = right * aspect * scale;
-    glm::vec3 imageUp = up * scale;
+    CameraFrame camera;
+    camera.position = camPos;
+    camera.imageCenter = camFront;
+    camera.imageRight = right * aspect * scale;
+    camera.imageUp = up * scale;
+    camera.width = W;
+    camera.height = H;
+    if (m_gbufferEnabled)
+        m_gbuffer.begin({camera.position, camera.imageCenter, camera.imageRight, camera.imageUp, W, H, m_seed, m_samplerType});
+
+    // Tiles are multiples of the packet block so 4x4 packets never straddle two tiles
+    const int blockSize = RayPacket::kBlockSize;
+    const int tileSize = std::max(blockSize, (m_tileSettings.tileSize + blockSize - 1) / blockSize * blockSize);
+    const std::vector<RenderTile> tiles = buildTileList(W, H, tileSize, m_tileSettings.order);
+    const uint32_t tileCount = static_cast<uint32_t>(tiles.size());
+    const uint64_t pixelCount = static_cast<uint64_t>(W) * static_cast<uint64_t>(H);
+
+    if (!m_threadPool)
+        m_threadPool = std::make_unique<ThreadPool>(m_tileSettings.threadCount);
+
+    // Accumulation restarts with every call; pass 0 is the deterministic pixel-centre sample
+    m_accumColor.assign(pixelCount, glm::vec3(0.0f));
+    m_accumLumaSq.assign(pixelCount, 0.0f);
+    m_sampleCounts.assign(pixelCount, 0u);
+    const bool adaptive = m_progressive.adaptiveThreshold > 0.0f;
+    if (adaptive)
+        m_accumHalf.assign(pixelCount, glm::vec3(0.0f));
+    m_converged.assign(pixelCount, 0u);
+    if (m_aovsEnabled)
+    {
+        // Albedo and normal are averaged like the color; depth and ids come from the centre sample
+        m_aovs.albedo.assign(pixelCount, glm::vec3(0.0f));
+        m_aovs.normal.assign(pixelCount, glm::vec3(0.0f));
+        m_aovs.depth.assign(pixelCount, RaytraceAOVs::kMissDepth);
+        m_aovs.instanceId.assign(pixelCount, RaytraceAOVs::kNoHit);
+        m_aovs.materialId.assign(pixelCount, RaytraceAOVs::kNoHit);
+    }
+    else
+    {
+        m_aovs = RaytraceAOVs();
+    }
+    std::vector<uint8_t> tileActive(tileCount, 1u);
+    m_progress.passesCompleted.store(0, std::memory_order_relaxed);
+
+    const uint32_t targetSpp = static_cast<uint32_t>(std::max(1, m_progressive.targetSpp));
+    const double timeBudgetMs = m_progressive.timeBudgetMs;
+    const auto elapsedMs = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - renderStart).count();
+    };
 
-    // Use proper OpenMP parallelization with atomic progress reporting
-#pragma omp parallel for schedule(dynamic, 8)
-    for (int y = 0; y < H; ++y)
+    std::atomic<uint64_t> primaryPackets{0}, divergentPackets{0}, cachedPrimaryHits{0};
+    uint32_t pass = 0;
+    float noise = -1.0f;
+    const char* stopReason = "target spp";
+
+    while (true)
     {
-        // Thread-safe progress reporting
-        if (y % 50 == 0) {
-            #pragma omp critical
+        m_progress.reset(tileCount, pixelCount);
+        GBufferSample* gbuffer = m_gbufferEnabled ? m_gbuffer.layer(pass) : nullptr;
+        m_threadPool->parallelFor(tileCount, [&](uint32_t tileIndex, unsigned) {
+            // Past the budget, remaining tiles keep their current sample count
+            if (pass > 0 && timeBudgetMs > 0.0 && elapsedMs() >= timeBudgetMs)
+                return;
+            if (!tileActive[tileIndex])
             {
-                std::cout << "[DEBUG] Tracing row " << y << " of " << H << "\n";
+                m_progress.pixelsCompleted.fetch_add(tiles[tileIndex].pixelCount(), std::memory_order_relaxed);
+                m_progress.tilesCompleted.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
-        }
 
-        for (int x = 0; x < W; ++x)
+            const RenderTile& tile = tiles[tileIndex];
+            t_rayCounters = ThreadRayCounters();
+
+            uint64_t packets = 0, divergent = 0, cached = 0;
+            glm::vec3 radiance[RayPacket::kSize];
+            FirstHitAOV aovs[RayPacket::kSize];
+            for (int y0 = tile.y0; y0 < tile.y1; y0 += blockSize)
+            {
+                for (int x0 = tile.x0; x0 < tile.x1; x0 += blockSize)
+                {
+                    uint32_t requestMask = RayPacket::kAllRays;
+                    if (adaptive)
+                    {
+                        for (int i = 0; i < RayPacket::kSize; ++i)
+                        {
+                            const int x = x0 + i % blockSize, y = y0 + i / blockSize;
+                            if (x < W && y < H && m_converged[static_cast<size_t>(H - 1 - y) * W + x])
+                                requestMask &= ~(1u << i);
+                        }
+                        if (!requestMask)
+                            continue;
+                    }
+
+                    const uint32_t mask = traceBlock(camera, x0, y0, pass, requestMask, lights, radiance,
+                                                     m_aovsEnabled ? aovs : nullptr, gbuffer, packets, divergent, cached);
+                    for (int i = 0; i < RayPacket::kSize; ++i)
+                    {
+                        if (!(mask & (1u << i)))
+                            continue;
+                        // Output is stored bottom row first
+                        const size_t index = static_cast<size_t>(H - 1 - (y0 + i / blockSize)) * W + (x0 + i % blockSize);
+                        const float luma = glm::dot(radiance[i], kLumaWeights);
+                        if (adaptive && (m_sampleCounts[index] & 1u) == 0)
+                            m_accumHalf[index] += radiance[i];
+                        m_accumColor[index] += radiance[i];
+                        m_accumLumaSq[index] += luma * luma;
+                        if (m_aovsEnabled)
+                        {
+                            m_aovs.albedo[index] += aovs[i].albedo;
+                            m_aovs.normal[index] += aovs[i].normal;
+                            if (m_sampleCounts[index] == 0)
+                            {
+                                m_aovs.depth[index] = aovs[i].depth;
+                                m_aovs.instanceId[index] = aovs[i].instanceId;
+                                m_aovs.materialId[index] = aovs[i].materialId;
+                            }
+                        }
+                        m_sampleCounts[index]++;
+                    }
+                }
+            }
+
+            totalRays.fetch_add(t_rayCounters.rays, std::memory_order_relaxed);
+            nodesVisited.fetch_add(t_rayCounters.traversal.nodesVisited, std::memory_order_relaxed);
+            trianglesTested.fetch_add(t_rayCounters.traversal.trianglesTested, std::memory_order_relaxed);
+            shadowRays.fetch_add(t_rayCounters.shadowRays, std::memory_order_relaxed);
+            shadowRaysBlocked.fetch_add(t_rayCounters.shadowRaysBlocked, std::memory_order_relaxed);
+            shadowNodesVisited.fetch_add(t_rayCounters.shadowTraversal.nodesVisited, std::memory_order_relaxed);
+            primaryPackets.fetch_add(packets, std::memory_order_relaxed);
+            divergentPackets.fetch_add(divergent, std::memory_order_relaxed);
+            cachedPrimaryHits.fetch_add(cached, std::memory_order_relaxed);
+
+            m_progress.pixelsCompleted.fetch_add(tile.pixelCount(), std::memory_order_relaxed);
+            const uint32_t done = m_progress.tilesCompleted.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+            // Only the tile that crosses a quarter mark prints, so workers never wait on the console
+            if (targetSpp == 1 && done * 4 / tileCount != (done - 1) * 4 / tileCount && done != tileCount)
+                std::cout << "[Raytracer] " << done * 100 / tileCount << "% (" << done << "/" << tileCount << " tiles)\n";
+
+            if (m_tileCallback)
+                m_tileCallback(tile, done, tileCount);
+
+            // Retire converged pixels; the tile is skipped once all of them are done
+            if (adaptive && pass + 1 >= static_cast<uint32_t>(std::max(2, m_progressive.adaptiveMinSpp)))
+                tileActive[tileIndex] = updateTileConvergence(tile, W, H) ? 1u : 0u;
+        });
+
+        m_progress.passesCompleted.store(++pass, std::memory_order_release);
+        if (pass > 1 && (pass & (pass - 1)) == 0)
+            std::cout << "[Raytracer] " << pass << " spp after " << elapsedMs() << " ms\n";
+
+        if (pass >= targetSpp)
+            break;
+        if (adaptive && std::find(tileActive.begin(), tileActive.end(), 1u) == tileActive.end())
         {
-            float u = (x + 0.5f) / W * 2.0f - 1.0f;
-            float v = 1.0f - (y + 0.5f) / H * 2.0f;
+            stopReason = "adaptive convergence";
+            break;
+        }
+        if (timeBudgetMs > 0.0 && elapsedMs() >= timeBudgetMs)
+        {
+            stopReason = "time budget";
+            break;
+        }
+        if (m_progressive.noiseThreshold > 0.0f && pass >= 2)
+        {
+            noise = estimateNoise();
+            if (noise <= m_progressive.noiseThreshold)
+            {
+                stopReason = "noise threshold";
+                break;
+            }
+        }
+    }
 
-            glm::vec3 dir = glm::normalize(imageCenter + u * imageRight + v * imageUp);
-            Ray r(camPos, dir);
-            
-            // Calculate output index correctly for flipped image
-            int outputIndex = (H - 1 - y) * W + x;
-            out[outputIndex] = traceRay(r, lights, 0);
+    uint64_t samples = 0, converged = 0;
+    uint32_t maxSpp = 0;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        out[i] = m_accumColor[i] / static_cast<float>(m_sampleCounts[i]);
+        if (m_aovsEnabled)
+        {
+            m_aovs.albedo[i] /= static_cast<float>(m_sampleCounts[i]);
+            const float length = glm::length(m_aovs.normal[i]);
+            m_aovs.normal[i] = length > 0.0f ? m_aovs.normal[i] / length : glm::vec3(0.0f);
         }
+        samples += m_sampleCounts[i];
+        converged += m_converged[i];
+        maxSpp = std::max(maxSpp, m_sampleCounts[i]);
     }
 
+    m_renderStats.cachedPrimaryHits = cachedPrimaryHits.load();
+    m_renderStats.primaryRays = samples - m_renderStats.cachedPrimaryHits;
+    m_renderStats.totalRays = totalRays.load();
+    m_renderStats.nodesVisited = nodesVisited.load();
+    m_renderStats.trianglesTested = trianglesTested.load();
+    m_renderStats.primaryPackets = primaryPackets.load();
+    m_renderStats.divergentPackets = divergentPackets.load();
+    m_renderStats.shadowRays = shadowRays.load();
+    m_renderStats.shadowRaysBlocked = shadowRaysBlocked.load();
+    m_renderStats.shadowNodesVisited = shadowNodesVisited.load();
+    m_renderStats.tiles = tileCount;
+    m_renderStats.threads = m_threadPool->threadCount();
+    m_renderStats.passes = pass;
+    m_renderStats.averageSpp = static_cast<double>(samples) / static_cast<double>(std::max<uint64_t>(1, pixelCount));
+    m_renderStats.convergedPixels = converged;
+    m_renderStats.maxSpp = maxSpp;
+    m_renderStats.noiseEstimate = pass >= 2 ? (noise >= 0.0f ? noise : estimateNoise()) : -1.0f;
+    m_renderStats.renderTimeMs = elapsedMs();
+
+    const double rays = std::max<double>(1.0, static_cast<double>(m_renderStats.totalRays));
+    std::cout << "[Raytracer] Traced " << m_renderStats.totalRays << " rays in " << m_renderStats.renderTimeMs
+              << " ms (" << integratorTypeName(m_pathSettings.integrator) << ") on " << m_renderStats.threads << " threads, " << tileCount << " " << tileSize << "px "
+              << tileOrderName(m_tileSettings.order) << " tiles (" << m_renderStats.nodesVisited / rays << " nodes, "
+              << m_renderStats.trianglesTested / rays << " triangles per ray";
+    if (m_renderStats.primaryPackets > 0)
+        std::cout << ", " << m_renderStats.primaryPackets << " primary packets, "
+                  << m_renderStats.divergentPackets << " divergent";
+    if (m_renderStats.shadowRays > 0)
+        std::cout << ", " << m_renderStats.shadowRays << " shadow rays (" << 100.0 * m_renderStats.shadowRaysBlocked / m_renderStats.shadowRays
+                  << "% blocked, " << static_cast<double>(m_renderStats.shadowNodesVisited) / m_renderStats.shadowRays << " nodes each)";
+    std::cout << ")\n";
+    if (targetSpp > 1 || timeBudgetMs > 0.0 || m_progressive.noiseThreshold > 0.0f)
+    {
+        std::cout << "[Raytracer] Progressive: " << m_renderStats.averageSpp << " spp over " << pass
+                  << " passes, stopped at " << stopReason;
+        if (adaptive)
+            std::cout << ", " << 100.0 * converged / std::max<uint64_t>(1, pixelCount) << "% of pixels converged early, max "
+                      << maxSpp << " spp";
+        if (m_renderStats.noiseEstimate >= 0.0f)
+            std::cout << " (noise " << m_renderStats.noiseEstimate << ")";
+        std::cout << "\n";
+    }
+    if (m_gbufferEnabled)
+        std::cout << "[Raytracer] G-buffer cache: reused " << m_renderStats.cachedPrimaryHits << " of " << samples
+                  << " camera hits (" << m_gbuffer.layerCount() << " layers, " << m_gbuffer.bytes() / (1024 * 1024) << " MiB)\n";
+    if (m_lightSampler.active())
+        std::cout << "[Raytracer] Light sampling: " << lightSamplingModeName(m_lightSampler.mode()) << ", "
+                  << m_lightSampler.samplesPerPoint() << " of " << lights.m_lights.size() << " lights per shading point\n";
+    m_lightSamplerSource = nullptr;
     std::cout << "[DEBUG] renderImage() finished!\n";
 }
 
-void Raytracer::loadModel(const ObjLoader& obj, const glm::mat4& M, float refl, const Material& mat)
+Raytracer::FirstHitAOV Raytracer::firstHitAOV(const InstanceHit& hit) const
+{
+    const BVHInstance& instance = m_scene.instances()[hit.instanceIndex];
+    const Material& mat = m_materials.material(instance.materialId);
+
+    // Mirrors and glass show what they reflect, so the denoiser expects their albedo near white
+    const float specular = std::max(reflectionWeight(instance.materialId, mat), mat.transmission > 0.01f ? mat.transmission : 0.0f);
+
+    FirstHitAOV aov;
+    aov.albedo = glm::mix(raytracer::material::getBaseColor(mat), glm::vec3(1.0f), specular);
+    aov.normal = m_scene.shadingNormal(hit);
+    aov.depth = hit.t;
+    aov.instanceId = hit.instanceIndex;
+    aov.materialId = instance.materialId;
+    return aov;
+}
+
+uint32_t Raytracer::traceBlock(const CameraFrame& camera, int x0, int y0, uint32_t sampleIndex, uint32_t requestMask,
+                               const Light& lights, glm::vec3* radiance, FirstHitAOV* aovs, GBufferSample* gbuffer,
+                               uint64_t& packets, uint64_t& divergent, uint64_t& cachedHits) const
 {
-    const float* pos = obj.getPositions();
-    const unsigned int* idx = obj.getFaces();
-    const size_t Nv = obj.getVertCount();
-    const size_t Nt = obj.getIndexCount() / 3;
+    const int blockSize = RayPacket::kBlockSize;
+    const int W = camera.width;
+    const int H = camera.height;
+    RayPacket packet;
+    packet.origin = camera.position;
+    uint32_t activeMask = 0;
+    uint64_t rayCount = 0;
+
+    for (int i = 0; i < RayPacket::kSize; ++i)
+    {
+        const int x = x0 + i % blockSize;
+        const int y = y0 + i / blockSize;
+        packet.tMax[i] = FLT_MAX;
+        if (x >= W || y >= H || !(requestMask & (1u << i)))
+        {
+            packet.setDirection(i, camera.imageCenter);
+            continue;
+        }
+
+        // The first sample goes through the pixel centre; later ones are jittered within the pixel
+        glm::vec2 jitter(0.5f);
+        if (sampleIndex > 0)
+            jitter = sampling::PixelSampler(m_samplerType, m_seed, pixelKey(x, y, W), sampleIndex).get2D();
 
-    std::vector<glm::vec3> wPos(Nv);
-    for (size_t i = 0; i < Nv; ++i)
+        float u = (x + jitter.x) / W * 2.0f - 1.0f;
+        float v = 1.0f - (y + jitter.y) / H * 2.0f;
+
+        glm::vec3 dir = glm::normalize(camera.imageCenter + u * camera.imageRight + v * camera.imageUp);
+        Ray r(camera.position, dir);
+        packet.setDirection(i, r.direction);
+        activeMask |= 1u << i;
+        rayCount++;
+    }
+
+    // Cached camera hits are restored; only the remaining rays are traced
+    InstanceHit hits[RayPacket::kSize];
+    uint32_t hitMask = 0;
+    uint32_t traceMask = activeMask;
+    if (gbuffer)
     {
-        glm::vec4 p(pos[i * 3 + 0],
-            pos[i * 3 + 1],
-            pos[i * 3 + 2], 1.0f);
-        wPos[i] = glm::vec3(M * p);
+        for (int i = 0; i < RayPacket::kSize; ++i)
+        {
+            if (!(activeMask & (1u << i)))
+                continue;
+            const GBufferSample& sample = gbuffer[static_cast<size_t>(y0 + i / blockSize) * W + (x0 + i % blockSize)];
+            if (sample.instance == GBufferSample::kEmpty)
+                continue;
+            if (GBufferCache::restore(sample, m_scene, hits[i]))
+                hitMask |= 1u << i;
+            traceMask &= ~(1u << i);
+            rayCount--;
+            cachedHits++;
+        }
     }
 
-    for (size_t i = 0; i < Nt; ++i)
+    if (m_packetTracing && traceMask)
     {
-        glm::vec3 v0 = wPos[idx[i * 3 + 0]];
-        glm::vec3 v1 = wPos[idx[i * 3 + 1]];
-        glm::vec3 v2 = wPos[idx[i * 3 + 2]];
-        triangles.emplace_back(v0, v1, v2, refl, mat);
+        packet.finalize(traceMask);
+        packets++;
+        if (!packet.coherent)
+            divergent++;
+        hitMask |= m_scene.intersectPacket(packet, traceMask, hits, t_rayCounters.traversal);
+        t_rayCounters.rays += rayCount;
     }
 
-    // Build BVH
-    std::vector<const Triangle*> triPtrs;
-    for (const auto& tri : triangles)
-        triPtrs.push_back(&tri);
+    for (int i = 0; i < RayPacket::kSize; ++i)
+    {
+        if (!(activeMask & (1u << i)))
+            continue;
+
+        Ray r(camera.position, packet.direction(i));
+        r.direction = packet.direction(i);
+
+        // Dimension 0 is the camera jitter drawn above
+        sampling::PixelSampler sampler(m_samplerType, m_seed, pixelKey(x0 + i % blockSize, y0 + i / blockSize, W), sampleIndex);
+        sampler.nextDimension();
 
-    bvhRoot = buildBVH(triPtrs);
+        // Without packets the camera ray is traced here, exactly as traceRay() would
+        const bool traced = (traceMask & (1u << i)) != 0;
+        if (!m_packetTracing && traced && intersectClosest(r, hits[i]))
+            hitMask |= 1u << i;
+        if (gbuffer && traced)
+        {
+            GBufferSample& sample = gbuffer[static_cast<size_t>(y0 + i / blockSize) * W + (x0 + i % blockSize)];
+            GBufferCache::store(sample, (hitMask & (1u << i)) ? &hits[i] : nullptr, m_scene);
+        }
+
+        if (!(hitMask & (1u << i)))
+        {
+            radiance[i] = background(r.direction, 0.0f);
+            if (aovs)
+            {
+                aovs[i] = FirstHitAOV();
+                aovs[i].albedo = radiance[i];
+            }
+            continue;
+        }
+
+        if (aovs)
+            aovs[i] = firstHitAOV(hits[i]);
+
+        if (m_pathSettings.integrator == IntegratorType::Path)
+        {
+            PathState path(r.origin, r.direction);
+            radiance[i] = tracePath(path, lights, sampler, &hits[i]);
+        }
+        else
+        {
+            radiance[i] = shadeHit(r, hits[i], lights, 0, sampler);
+        }
+    }
+    return activeMask;
+}
+
+bool Raytracer::updateTileConvergence(const RenderTile& tile, int W, int H)
+{
+    // Two-buffer estimator: compare the full mean with the mean of every second sample,
+    // normalized by the square root of the brightness to approximate perceived noise
+    bool active = false;
+    for (int y = tile.y0; y < tile.y1; ++y)
+    {
+        for (int x = tile.x0; x < tile.x1; ++x)
+        {
+            const size_t index = static_cast<size_t>(H - 1 - y) * W + x;
+            if (m_converged[index])
+                continue;
+
+            const uint32_t n = m_sampleCounts[index];
+            if (n < static_cast<uint32_t>(std::max(2, m_progressive.adaptiveMinSpp)))
+            {
+                active = true;
+                continue;
+            }
+
+            const uint32_t halfCount = (n + 1) / 2;
+            const float full = glm::dot(m_accumColor[index], kLumaWeights) / n;
+            const float half = glm::dot(m_accumHalf[index], kLumaWeights) / halfCount;
+            const float error = std::abs(full - half) / std::sqrt(std::max(full, 1e-4f));
+            if (error < m_progressive.adaptiveThreshold)
+                m_converged[index] = 1u;
+            else
+                active = true;
+        }
+    }
+    return active;
+}
+
+void Raytracer::sampleDensityImage(std::vector<glm::vec3>& out) const
+{
+    out.resize(m_sampleCounts.size());
+    uint32_t minCount = UINT32_MAX, maxCount = 0;
+    for (uint32_t n : m_sampleCounts)
+    {
+        minCount = std::min(minCount, n);
+        maxCount = std::max(maxCount, n);
+    }
+
+    const float range = maxCount > minCount ? static_cast<float>(maxCount - minCount) : 1.0f;
+    for (size_t i = 0; i < m_sampleCounts.size(); ++i)
+    {
+        // Blue -> green -> red ramp over the observed sample range
+        const float t = (m_sampleCounts[i] - minCount) / range;
+        out[i] = glm::vec3(glm::clamp(2.0f * t - 1.0f, 0.0f, 1.0f),
+                           1.0f - std::abs(2.0f * t - 1.0f),
+                           glm::clamp(1.0f - 2.0f * t, 0.0f, 1.0f));
+    }
+}
+
+float Raytracer::estimateNoise() const
+{
+    // Mean over pixels of the relative standard error of the luminance estimate
+    double sum = 0.0;
+    size_t counted = 0;
+    for (size_t i = 0; i < m_sampleCounts.size(); ++i)
+    {
+        const uint32_t n = m_sampleCounts[i];
+        if (n < 2)
+            continue;
+        const float mean = glm::dot(m_accumColor[i], kLumaWeights) / n;
+        const float variance = std::max(0.0f, m_accumLumaSq[i] / n - mean * mean) * n / (n - 1);
+        sum += std::sqrt(variance / n) / std::max(mean, 1e-3f);
+        counted++;
+    }
+    return counted ? static_cast<float>(sum / counted) : -1.0f;
+}
+
+void Raytracer::setProgressiveSettings(const ProgressiveRenderSettings& settings)
+{
+    m_progressive = settings;
+    m_progressive.targetSpp = std::max(1, settings.targetSpp);
+    m_progressive.timeBudgetMs = std::max(0.0, settings.timeBudgetMs);
+    m_progressive.noiseThreshold = std::max(0.0f, settings.noiseThreshold);
+    m_progressive.adaptiveThreshold = std::max(0.0f, settings.adaptiveThreshold);
+    m_progressive.adaptiveMinSpp = std::max(2, settings.adaptiveMinSpp);
+}
+
+void Raytracer::setTileSchedulerSettings(const TileSchedulerSettings& settings)
+{
+    if (settings.threadCount != m_tileSettings.threadCount)
+        m_threadPool.reset();
+    m_tileSettings = settings;
+}
+
+uint32_t Raytracer::loadModel(const ObjLoader& obj, const glm::mat4& M, float refl, const Material& mat)
+{
+    // Meshes are stored once in object space; the BVHs are built in commit()
+    uint32_t meshIndex = m_scene.addMesh(obj);
+    return m_scene.addInstance(meshIndex, M, m_materials.acquire(mat, refl));
+}
+
+bool Raytracer::setInstanceTransform(uint32_t instanceId, const glm::mat4& transform)
+{
+    return m_scene.setInstanceTransform(instanceId, transform);
+}
+
+bool Raytracer::setInstanceMaterial(uint32_t instanceId, float reflectivity, const Material& mat)
+{
+    if (instanceId >= m_scene.instances().size() || !m_scene.instances()[instanceId].active)
+        return false;
+    const uint32_t oldId = m_scene.instances()[instanceId].materialId;
+    return m_scene.setInstanceMaterial(instanceId, m_materials.update(oldId, mat, reflectivity));
+}
+
+bool Raytracer::removeInstance(uint32_t instanceId)
+{
+    if (instanceId >= m_scene.instances().size() || !m_scene.instances()[instanceId].active)
+        return false;
+    m_materials.release(m_scene.instances()[instanceId].materialId);
+    return m_scene.removeInstance(instanceId);
 }
 
 glm::vec3 Raytracer::sampleGlossyReflection(
@@ -224,7 +989,7 @@ glm::vec3 Raytracer::sampleGlossyReflection(
     const Material& material,
     const Light& lights,
     int depth,
-    microfacet::SeededRNG& rng) const
+    sampling::PixelSampler& sampler) const
 {
     // Check for perfect mirror fallback
     if (microfacet::shouldUsePerfectMirror(material.roughness))
@@ -232,28 +997,36 @@ glm::vec3 Raytracer::sampleGlossyReflection(
         // Perfect mirror reflection
         glm::vec3 reflectedDir = glm::reflect(-viewDir, normal);
         Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-        return traceRay(reflectedRay, lights, depth + 1);
+        return traceSample(reflectedRay, lights, depth + 1, sampler);
     }
     
     // Glossy reflection with multiple samples
     glm::vec3 totalReflectedColor(0.0f);
     int validSamples = 0;
     
-    // Generate stratified microfacet normals
-    std::vector<glm::vec3> microfacetNormals = microfacet::sampleBeckmannNormalsStratified(
-        normal, material.roughness, m_reflectionSpp, rng
-    );
-    
-    for (const glm::vec3& microfacetNormal : microfacetNormals)
+    // The lobe samples share one sampler dimension so they are stratified against each other
+    const uint32_t dimension = sampler.nextDimension();
+    const uint32_t sampleCount = static_cast<uint32_t>(std::max(1, m_reflectionSpp));
+    // With an environment, as many environment samples are MIS-combined with the lobe samples;
+    // beyond the recursion limit the lobe sees nothing, so neither strategy runs
+    const bool sampleEnvironment = m_environment && depth + 1 <= 2;
+    const uint32_t environmentDimension = m_environment ? sampler.nextDimension() : 0;
+    for (uint32_t s = 0; s < sampleCount; ++s)
     {
+        const glm::vec3 microfacetNormal = microfacet::sampleBeckmannNormal(
+            normal, material.roughness, sampler.sample2D(dimension, s, sampleCount));
+
         // Compute reflection direction using the microfacet normal
         glm::vec3 reflectedDir = microfacet::reflect(-viewDir, microfacetNormal);
         
         // Ensure the reflected ray is above the surface (avoid self-intersection)
         if (glm::dot(reflectedDir, normal) > 0.0f)
         {
-            Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-            glm::vec3 sampleColor = traceRay(reflectedRay, lights, depth + 1);
+            reflectedDir = glm::normalize(reflectedDir);
+            const float lobePdf = sampleEnvironment
+                ? microfacet::beckmannReflectionPdf(normal, viewDir, reflectedDir, material.roughness) : 0.0f;
+            Ray reflectedRay(hitPoint + normal * 0.001f, reflectedDir);
+            glm::vec3 sampleColor = traceSample(reflectedRay, lights, depth + 1, sampler, lobePdf);
             
             // Weight the sample (in a full implementation, this would include the BRDF weight)
             // For now, we use equal weighting for all valid samples
@@ -261,6 +1034,17 @@ glm::vec3 Raytracer::sampleGlossyReflection(
             validSamples++;
         }
     }
+
+    if (sampleEnvironment)
+    {
+        // Each MIS strategy is averaged over its own sample count; lobe samples below the
+        // horizon contribute zero rather than shrinking the denominator
+        glm::vec3 environmentColor(0.0f);
+        for (uint32_t s = 0; s < sampleCount; ++s)
+            environmentColor += environmentReflection(hitPoint, normal, viewDir, material.roughness,
+                                                      sampler.sample2D(environmentDimension, s, sampleCount));
+        return (totalReflectedColor + environmentColor) / float(sampleCount);
+    }
     
     // Average the samples by valid sample count
     if (validSamples > 0)
@@ -272,7 +1056,7 @@ glm::vec3 Raytracer::sampleGlossyReflection(
         // Fallback to perfect mirror if no valid samples
         glm::vec3 reflectedDir = glm::reflect(-viewDir, normal);
         Ray reflectedRay(hitPoint + normal * 0.001f, glm::normalize(reflectedDir));
-        totalReflectedColor = traceRay(reflectedRay, lights, depth + 1);
+        totalReflectedColor = traceSample(reflectedRay, lights, depth + 1, sampler);
     }
     
     return totalReflectedColor;
@@ -284,7 +1068,8 @@ glm::vec3 Raytracer::computeRefraction(
     const glm::vec3& normal,
     const Material& material,
     const Light& lights,
-    int depth) const
+    int depth,
+    sampling::PixelSampler& sampler) const
 {
     // Determine media transition (entering or exiting material)
     float ior1, ior2;
@@ -304,14 +1089,14 @@ glm::vec3 Raytracer::computeRefraction(
     if (hasRefraction) {
         // Compute refracted ray contribution
         Ray refractedRay(hitPoint - adjustedNormal * 0.001f, refractedDir);
-        glm::vec3 refractedColor = traceRay(refractedRay, lights, depth + 1);
+        glm::vec3 refractedColor = traceSample(refractedRay, lights, depth + 1, sampler);
         
         // Mix reflection and refraction based on Fresnel
         if (fresnelReflectance < 1.0f) {
             // Compute reflection ray
             glm::vec3 reflectedDir = glm::reflect(incident, adjustedNormal);
             Ray reflectedRay(hitPoint + adjustedNormal * 0.001f, reflectedDir);
-            glm::vec3 reflectedColor = traceRay(reflectedRay, lights, depth + 1);
+            glm::vec3 reflectedColor = traceSample(reflectedRay, lights, depth + 1, sampler);
             
             // Blend reflection and refraction
             finalColor = fresnelReflectance * reflectedColor + (1.0f - fresnelReflectance) * refractedColor;
@@ -322,7 +1107,7 @@ glm::vec3 Raytracer::computeRefraction(
         // Total internal reflection - only reflection
         glm::vec3 reflectedDir = glm::reflect(incident, adjustedNormal);
         Ray reflectedRay(hitPoint + adjustedNormal * 0.001f, reflectedDir);
-        finalColor = traceRay(reflectedRay, lights, depth + 1);
+        finalColor = traceSample(reflectedRay, lights, depth + 1, sampler);
     }
     
     return finalColor;
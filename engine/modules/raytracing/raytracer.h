@@ -1,5 +1,5 @@
 // Machine Summary Block
-// {"file":"engine/modules/raytracing/raytracer.h","purpose":"Declares the CPU ray tracer used for offline renders and previews.","exports":["Raytracer"],"depends_on":["ray.h","objloader.h","material.h","light.h","glm/glm.hpp"],"notes":["supports_glossy_reflections","builds_BVH_for_acceleration"]}
+// {"file":"engine/modules/raytracing/raytracer.h","purpose":"Declares the CPU ray tracer used for offline renders and previews.","exports":["Raytracer"],"depends_on":["ray.h","objloader.h","material.h","light.h","two_level_bvh.h","material_table.h","thread_pool.h","tile_scheduler.h","sampler.h","path_integrator.h","environment_map.h","light_sampler.h","bvh_builder.h","gbuffer_cache.h","glm/glm.hpp"],"notes":["supports_glossy_reflections","builds_BVH_once_per_commit","instanced_two_level_BVH","deduplicated_material_table","flattened_BVH_stack_traversal","reports_traversal_counters","tiled_work_stealing_render","any_hit_occlusion_queries","counter_based_sampling","iterative_path_integrator","first_hit_aovs","hdr_environment_light_with_mis","many_light_sampling","on_disk_bvh_cache","selectable_parallel_bvh_builder","first_hit_gbuffer_cache"]}
 // Human Summary
 // Core ray tracing engine handling BVH generation, glossy reflections, and refraction sampling.
 
@@ -11,20 +11,74 @@
 #define GLINT_ENABLE_RAYTRACING 1
 #endif
 
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <vector>
 #include <glm/glm.hpp>
 #include "ray.h"
 #include "objloader.h"
 #include "material.h"
 #include "light.h"
+#include "tile_scheduler.h"
+#include "sampler.h"
+#include "path_integrator.h"
+#include "environment_map.h"
+#include "light_sampler.h"
+#include "bvh_builder.h"
+
+/// @brief First-hit auxiliary outputs (AOVs) of the most recent renderImage() call.
+/// @details Same size and row order as the color output. Albedo and normal are averaged over a
+/// pixel's samples, which is what the denoiser expects; depth and ids come from the pixel-centre sample.
+struct RaytraceAOVs
+{
+    static constexpr uint32_t kNoHit = 0xFFFFFFFFu;   ///< Id stored where the camera ray missed.
+    static constexpr float kMissDepth = FLT_MAX;      ///< Depth stored where the camera ray missed.
+
+    std::vector<glm::vec3> albedo;     ///< Surface albedo; specular and transmissive surfaces tend to white, misses hold the background.
+    std::vector<glm::vec3> normal;     ///< Normalized world-space shading normal; zero where every sample missed.
+    std::vector<float> depth;          ///< Distance from the camera to the first hit.
+    std::vector<uint32_t> instanceId;  ///< Raytracer instance id returned by loadModel().
+    std::vector<uint32_t> materialId;  ///< Material table entry.
+
+    /// @brief Returns true when no AOVs were produced.
+    bool empty() const { return albedo.empty(); }
+};
 
 #if GLINT_ENABLE_RAYTRACING
-#include "triangle.h"
-#include "BVHNode.h"
+#include "two_level_bvh.h"
+#include "material_table.h"
+#include "thread_pool.h"
+#include "gbuffer_cache.h"
 #include "microfacet_sampling.h"
 #include "raytracer_lighting.h"
 #include "refraction.h"
 
+/// @brief Ray and traversal counters gathered by the most recent renderImage() call.
+struct RaytraceRenderStats
+{
+    uint64_t primaryRays = 0;       ///< Camera rays traced.
+    uint64_t totalRays = 0;         ///< All rays traced, including secondary bounces.
+    uint64_t nodesVisited = 0;      ///< BVH nodes tested across all rays.
+    uint64_t trianglesTested = 0;   ///< Ray/triangle tests across all rays.
+    uint64_t primaryPackets = 0;    ///< 4x4 camera ray packets traced together.
+    uint64_t divergentPackets = 0;  ///< Packets whose rays were traced individually.
+    uint64_t shadowRays = 0;        ///< Occlusion queries (not included in totalRays).
+    uint64_t shadowRaysBlocked = 0; ///< Occlusion queries that found a blocker.
+    uint64_t shadowNodesVisited = 0; ///< BVH nodes tested by occlusion queries.
+    uint64_t cachedPrimaryHits = 0; ///< Camera rays answered from the G-buffer cache (not in primaryRays).
+    uint32_t tiles = 0;             ///< Tiles scheduled per pass.
+    uint32_t passes = 0;            ///< Progressive passes run.
+    double averageSpp = 0.0;        ///< Camera samples per pixel, averaged over the image.
+    float noiseEstimate = -1.0f;    ///< Mean relative standard error, or -1 with fewer than two passes.
+    uint64_t convergedPixels = 0;   ///< Pixels adaptive sampling stopped early.
+    uint32_t maxSpp = 0;            ///< Highest per-pixel sample count.
+    unsigned threads = 0;           ///< Threads that rendered the tiles.
+    double renderTimeMs = 0.0;      ///< Wall-clock time of the render.
+};
+
 /// @brief CPU raytracer capable of loading scene meshes and producing path-traced images.
 class Raytracer
 {
@@ -32,21 +86,114 @@ public:
     /// @brief Constructs an empty raytracer instance.
     Raytracer();
 
-    /// @brief Adds geometry from an ObjLoader into the acceleration structure.
+    /// @brief Releases the acceleration structure.
+    ~Raytracer();
+
+    Raytracer(const Raytracer&) = delete;
+    Raytracer& operator=(const Raytracer&) = delete;
+
+    /// @brief Adds an instance of the loader's mesh; identical meshes share one bottom-level BVH.
     /// @param loader Mesh data source.
-    /// @param transform World transform applied to triangles.
+    /// @param transform Object-to-world transform of the instance.
     /// @param reflectivity Reflection strength used during shading.
     /// @param mat Material applied to the geometry.
-    void loadModel(const ObjLoader& loader, const glm::mat4& transform, float reflectivity, const Material& mat);
+    /// @return Instance id for later updates.
+    uint32_t loadModel(const ObjLoader& loader, const glm::mat4& transform, float reflectivity, const Material& mat);
+
+    /// @brief Moves an instance; the next commit() only rebuilds the top-level BVH.
+    /// @param instanceId Id returned by loadModel().
+    /// @param transform New object-to-world transform.
+    /// @return False when the id is unknown.
+    bool setInstanceTransform(uint32_t instanceId, const glm::mat4& transform);
+
+    /// @brief Updates an instance's material and reflectivity without touching the BVHs.
+    /// @details The material table entry is edited in place when no other instance shares it.
+    /// @return False when the id is unknown.
+    bool setInstanceMaterial(uint32_t instanceId, float reflectivity, const Material& mat);
+
+    /// @brief Removes an instance; its mesh is released once no other instance uses it.
+    /// @return False when the id is unknown.
+    bool removeInstance(uint32_t instanceId);
+
+    /// @brief Drops all meshes, instances, and materials while keeping settings such as seed and spp.
+    void clearScene() { m_scene.clear(); m_materials.clear(); }
+
+    /// @brief Returns the number of distinct materials referenced by the scene.
+    size_t getMaterialCount() const { return m_materials.size(); }
+
+    /// @brief Builds bottom-level BVHs for new meshes and the top-level BVH over instances.
+    /// @details Call once after the last loadModel(); renderImage() commits implicitly if the scene changed.
+    void commit();
+
+    /// @brief Reports whether geometry or transforms changed since the last commit().
+    /// @return True when the acceleration structure is out of date.
+    bool needsCommit() const { return m_scene.needsBuild(); }
+
+    /// @brief Sets the builder, leaf size, bin count, and cost model used for mesh BVHs.
+    /// @details Mesh BVHs built with different settings are rebuilt by the next commit().
+    /// @param settings Builder parameters.
+    void setBVHBuildSettings(const BVHBuildSettings& settings);
+
+    /// @brief Selects the mesh BVH builder, e.g. LBVH for fast previews and binned SAH for final renders.
+    /// @details Changing it rebuilds the mesh BVHs on the next commit(); builds use the render threads.
+    void setBVHBuildAlgorithm(BVHBuildAlgorithm algorithm);
+
+    /// @brief Returns the active BVH builder parameters.
+    /// @return Builder settings.
+    const BVHBuildSettings& getBVHBuildSettings() const { return m_bvhSettings; }
+
+    /// @brief Reuses mesh BVHs across runs through files in @p directory; an empty path disables the cache.
+    /// @details Applies to meshes built by later commits. Files are keyed by mesh content and the
+    /// builder settings, so changed assets or settings simply miss.
+    void setBVHCacheDirectory(const std::filesystem::path& directory);
+
+    /// @brief Caps the SIMD level used for leaf triangle tests; the best supported level is used by default.
+    /// @param maxKernel Highest kernel to allow (Scalar forces the portable path).
+    void setMaxTriangleKernel(TriangleKernel maxKernel) { m_scene.setMaxTriangleKernel(maxKernel); }
+
+    /// @brief Returns the leaf triangle kernel selected for this CPU.
+    TriangleKernel getTriangleKernel() const { return m_scene.triangleKernel(); }
+
+    /// @brief Returns mesh/instance counts and build timings from the last commit().
+    /// @return Acceleration structure statistics.
+    const TwoLevelBVHStats& getSceneStats() const { return m_scene.stats(); }
+
+    /// @brief Returns ray and traversal counters from the last renderImage().
+    /// @return Render statistics.
+    const RaytraceRenderStats& getLastRenderStats() const { return m_renderStats; }
 
     /// @brief Traces a single ray into the scene and returns the accumulated radiance.
+    /// @details Always uses the Whitted integrator. Sample values are keyed on the ray itself, so
+    /// repeated calls return the same result.
     /// @param r Input ray in world space.
     /// @param lights Active scene lighting configuration.
     /// @param depth Remaining recursion depth (defaults to 3).
     /// @return RGB radiance contribution.
     glm::vec3 traceRay(const Ray& r, const Light& lights, int depth = 3) const;
 
+    /// @brief Maximum number of rays accepted by occludedBatch().
+    static constexpr uint32_t kMaxOcclusionBatch = 32;
+
+    /// @brief Reports whether anything blocks a ray within (0, tMax).
+    /// @details Any-hit query that stops at the first blocker; cheaper than traceRay() for shadow
+    /// and visibility tests. Safe to call from render threads.
+    /// @param origin World-space ray origin, already offset from the surface it leaves.
+    /// @param direction Normalized world-space direction.
+    /// @param tMax Distance to the target; blockers at or beyond it are ignored.
+    /// @return True when the ray is blocked.
+    bool occluded(const glm::vec3& origin, const glm::vec3& direction, float tMax) const;
+
+    /// @brief Runs occluded() for several rays leaving one point, such as one shadow ray per light.
+    /// @param origin Shared world-space origin.
+    /// @param directions Normalized directions.
+    /// @param tMax Per-ray distance limits.
+    /// @param count Number of rays, at most kMaxOcclusionBatch.
+    /// @return Mask of blocked rays (bit i for ray i).
+    uint32_t occludedBatch(const glm::vec3& origin, const glm::vec3* directions, const float* tMax, uint32_t count) const;
+
     /// @brief Renders a full image using the loaded scene geometry.
+    /// @details Runs progressive passes until the target spp, time budget, or noise threshold set
+    /// with setProgressiveSettings() is reached; the output holds the per-pixel sample mean.
     /// @param out Output color buffer.
     /// @param W Image width in pixels.
     /// @param H Image height in pixels.
@@ -79,13 +226,226 @@ public:
     /// @return Samples per pixel value.
     int getReflectionSpp() const { return m_reflectionSpp; }
 
+    /// @brief Selects the integrator used by renderImage() and its bounce limits.
+    /// @details The path integrator traces one continuation ray per bounce and ignores the
+    /// reflection spp; use the progressive spp to trade time for noise instead.
+    void setPathTracerSettings(const PathTracerSettings& settings);
+
+    /// @brief Returns the integrator settings.
+    const PathTracerSettings& getPathTracerSettings() const { return m_pathSettings; }
+
+    /// @brief Selects the sequence used for pixel jitter and glossy lobe samples (Sobol by default).
+    /// @details Values depend only on seed, pixel, sample, and dimension, never on the thread.
+    void setSamplerType(sampling::SamplerType type) { m_samplerType = type; }
+
+    /// @brief Returns the active sample sequence.
+    sampling::SamplerType getSamplerType() const { return m_samplerType; }
+
+    /// @brief Enables tracing primary rays in 4x4 pixel packets (on by default).
+    /// @details Images are identical either way; packets only change traversal cost.
+    /// @param enabled False traces every camera ray individually.
+    void setPacketTracing(bool enabled) { m_packetTracing = enabled; }
+
+    /// @brief Returns true when primary rays are traced in packets.
+    bool getPacketTracing() const { return m_packetTracing; }
+
+    /// @brief Sets tile size, tile order, and render thread count for renderImage().
+    /// @details The worker pool is recreated on the next render when the thread count changes.
+    void setTileSchedulerSettings(const TileSchedulerSettings& settings);
+
+    /// @brief Returns the tiling and threading parameters.
+    const TileSchedulerSettings& getTileSchedulerSettings() const { return m_tileSettings; }
+
+    /// @brief Installs a callback invoked on the rendering thread after each tile completes.
+    /// @param callback Thread-safe callback, or nullptr to remove it.
+    void setTileCompletedCallback(TileCompletedCallback callback) { m_tileCallback = std::move(callback); }
+
+    /// @brief Sets the progressive stop conditions used by renderImage().
+    /// @details With the defaults (1 spp, no budgets) renderImage() traces one pixel-centre sample.
+    void setProgressiveSettings(const ProgressiveRenderSettings& settings);
+
+    /// @brief Returns the progressive stop conditions.
+    const ProgressiveRenderSettings& getProgressiveSettings() const { return m_progressive; }
+
+    /// @brief Returns the number of samples accumulated per pixel by the last renderImage().
+    /// @details Same layout as the output buffer. Counts differ between pixels when the time
+    /// budget expired part-way through a pass.
+    const std::vector<uint32_t>& getSampleCounts() const { return m_sampleCounts; }
+
+    /// @brief Writes a heat map of the last render's sample counts (blue = fewest, red = most).
+    /// @param out Resized to the render size; same layout as the renderImage() output.
+    void sampleDensityImage(std::vector<glm::vec3>& out) const;
+
+    /// @brief Enables first-hit AOVs (albedo, normal, depth, ids) in later renderImage() calls.
+    /// @details They are produced from the camera rays already traced for color, in the same pass.
+    void setAOVsEnabled(bool enabled) { m_aovsEnabled = enabled; }
+
+    /// @brief Returns true when renderImage() produces AOVs.
+    bool getAOVsEnabled() const { return m_aovsEnabled; }
+
+    /// @brief Returns the AOVs of the last renderImage(); empty unless enabled.
+    const RaytraceAOVs& getAOVs() const { return m_aovs; }
+
+    /// @brief Lights the scene with an HDR environment, or restores the flat background when null.
+    /// @details Misses return the environment, and every shading point samples it directly,
+    /// combined with BSDF and glossy-lobe samples by multiple importance sampling.
+    void setEnvironmentMap(std::shared_ptr<const EnvironmentMap> environment) { m_environment = std::move(environment); }
+
+    /// @brief Loads an HDR image and lights the scene with it (rows bottom first, like the GL upload).
+    /// @return False when the image cannot be read or has no usable pixels; the current environment is kept.
+    bool loadEnvironmentMap(const std::string& path);
+
+    /// @brief Returns the environment light, or nullptr when none is set.
+    const EnvironmentMap* getEnvironmentMap() const { return m_environment.get(); }
+
+    /// @brief Scales the radiance of the environment map (1 by default).
+    void setEnvironmentIntensity(float intensity) { m_environmentIntensity = std::max(0.0f, intensity); }
+
+    /// @brief Returns the environment radiance scale.
+    float getEnvironmentIntensity() const { return m_environmentIntensity; }
+
+    /// @brief Chooses how local lights are selected at each shading point.
+    /// @details By default scenes with a handful of lights evaluate all of them; larger scenes
+    /// pick LightSamplingSettings::samplesPerPoint lights from a light BVH per shading point.
+    void setLightSamplingSettings(const LightSamplingSettings& settings) { m_lightSamplingSettings = settings; }
+
+    /// @brief Returns the light selection settings.
+    const LightSamplingSettings& getLightSamplingSettings() const { return m_lightSamplingSettings; }
+
+    /// @brief Keeps the first hit of every camera ray between renders (off by default).
+    /// @details Later renders with the same camera, resolution, seed and sampler reshade the
+    /// cached hits and trace only secondary and shadow rays, so light, material and exposure
+    /// edits re-render quickly. Any geometry change clears the cache. Disabling frees it.
+    void setGBufferCacheEnabled(bool enabled);
+
+    /// @brief Returns true when camera hits are cached between renders.
+    bool getGBufferCacheEnabled() const { return m_gbufferEnabled; }
+
+    /// @brief Returns lock-free progress counters of the current (or last) renderImage() call.
+    /// @details Safe to poll from another thread while a render is running.
+    const RenderProgress& getRenderProgress() const { return m_progress; }
+
 private:
-    std::vector<Triangle> triangles;
     glm::vec3 lightPos{0.0f};
     glm::vec3 lightColor{1.0f};
-    BVHNode* bvhRoot = nullptr;
+    TwoLevelBVH m_scene;
+    MaterialTable m_materials;
+    BVHBuildSettings m_bvhSettings;
+    RaytraceRenderStats m_renderStats;
     uint32_t m_seed = 0;
     int m_reflectionSpp = 8;
+    sampling::SamplerType m_samplerType = sampling::SamplerType::Sobol;
+    PathTracerSettings m_pathSettings;
+    bool m_packetTracing = true;
+    TileSchedulerSettings m_tileSettings;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    TileCompletedCallback m_tileCallback;
+    RenderProgress m_progress;
+    ProgressiveRenderSettings m_progressive;
+    std::vector<glm::vec3> m_accumColor;   ///< Radiance sums per pixel.
+    std::vector<float> m_accumLumaSq;      ///< Sums of squared luminance, for the noise estimate.
+    std::vector<uint32_t> m_sampleCounts;  ///< Samples per pixel.
+    std::vector<glm::vec3> m_accumHalf;    ///< Radiance sums of every second sample (adaptive error estimate).
+    std::vector<uint8_t> m_converged;      ///< Pixels adaptive sampling no longer samples.
+    bool m_aovsEnabled = false;
+    RaytraceAOVs m_aovs;
+    std::shared_ptr<const EnvironmentMap> m_environment;
+    float m_environmentIntensity = 1.0f;
+    LightSamplingSettings m_lightSamplingSettings;
+    LightSampler m_lightSampler;            ///< Rebuilt by each renderImage() from its light list.
+    const Light* m_lightSamplerSource = nullptr; ///< Light list m_lightSampler was built for, while rendering.
+    bool m_gbufferEnabled = false;
+    GBufferCache m_gbuffer;                 ///< Camera hits of earlier renders; cleared by every rebuild.
+
+    /// @brief AOV values of one camera sample.
+    struct FirstHitAOV
+    {
+        glm::vec3 albedo{0.0f};
+        glm::vec3 normal{0.0f};
+        float depth = RaytraceAOVs::kMissDepth;
+        uint32_t instanceId = RaytraceAOVs::kNoHit;
+        uint32_t materialId = RaytraceAOVs::kNoHit;
+    };
+
+    /// @brief Pinhole camera basis shared by every block of a render.
+    struct CameraFrame
+    {
+        glm::vec3 position{0.0f};
+        glm::vec3 imageCenter{0.0f};
+        glm::vec3 imageRight{0.0f};
+        glm::vec3 imageUp{0.0f};
+        int width = 0;
+        int height = 0;
+    };
+
+    /// @brief Finds the closest hit along a ray and updates the per-thread counters.
+    /// @return True when something was hit.
+    bool intersectClosest(const Ray& ray, InstanceHit& hit) const;
+
+    /// @brief traceRay() with the sampler of the camera sample the ray belongs to.
+    /// @param lobePdf Density of the ray under the glossy lobe that drew it when the environment was
+    /// also sampled for that lobe, else 0; weights the environment seen on a miss.
+    glm::vec3 traceSample(const Ray& ray, const Light& lights, int depth, sampling::PixelSampler& sampler,
+                          float lobePdf = 0.0f) const;
+
+    /// @brief Radiance of a ray that left the scene.
+    /// @param lobePdf As for traceSample(); 0 returns the unweighted environment.
+    glm::vec3 background(const glm::vec3& direction, float lobePdf) const;
+
+    /// @brief Reserves the light-pick dimension for a shading point when lights are sampled.
+    /// @return A selection without a sampler when every light is evaluated; no dimension is drawn then.
+    raytracer::LightSelection lightSelection(const Light& lights, sampling::PixelSampler& sampler) const;
+
+    /// @brief Direct lighting from the environment at a shading point.
+    /// @details One environment sample and one BSDF sample, each with a shadow ray, combined with
+    /// the power heuristic.
+    glm::vec3 environmentLighting(const glm::vec3& hitPoint, const glm::vec3& normal, const glm::vec3& viewDir,
+                                  const Material& material, const glm::vec2& lightSample, const glm::vec2& bsdfSample) const;
+
+    /// @brief Environment sample for a glossy reflection lobe, MIS-weighted against the lobe's own rays.
+    /// @return Unoccluded environment radiance times lobe density over environment density, or 0.
+    glm::vec3 environmentReflection(const glm::vec3& hitPoint, const glm::vec3& normal, const glm::vec3& viewDir,
+                                    float roughness, const glm::vec2& u) const;
+
+    /// @brief Shades a known hit; traceSample() is intersectClosest() followed by this.
+    glm::vec3 shadeHit(const Ray& ray, const InstanceHit& hit, const Light& lights, int depth,
+                       sampling::PixelSampler& sampler) const;
+
+    /// @brief Blend weight of the reflection lobe for a material, shared by both integrators.
+    float reflectionWeight(uint32_t materialId, const Material& mat) const;
+
+    /// @brief Runs the path integrator until the path terminates and returns its radiance.
+    /// @param cameraHit Hit of the camera ray when it was already traced in a packet, else nullptr.
+    glm::vec3 tracePath(PathState& path, const Light& lights, sampling::PixelSampler& sampler,
+                        const InstanceHit* cameraHit) const;
+
+    /// @brief Advances a path by one vertex: shades it and replaces the ray with the continuation.
+    /// @param knownHit Hit for the current ray if already found, else nullptr to trace it.
+    void advancePath(PathState& path, const Light& lights, sampling::PixelSampler& sampler,
+                     const InstanceHit* knownHit) const;
+
+    /// @brief Traces one camera sample for each pixel of a 4x4 block, as a packet when enabled.
+    /// @param sampleIndex 0 for the pixel-centre sample, otherwise the jittered sample number.
+    /// @param radiance Receives RayPacket::kSize colors, indexed row-major within the block.
+    /// @param requestMask Block pixels to sample; others are skipped.
+    /// @param aovs Receives RayPacket::kSize first-hit AOVs, or nullptr when AOVs are off.
+    /// @param gbuffer Cached camera hits of this sample (image order), or nullptr; filled slots
+    /// skip the camera ray, empty ones are filled.
+    /// @param cachedHits Incremented for every camera ray answered from @p gbuffer.
+    /// @return Mask of requested block pixels inside the image.
+    uint32_t traceBlock(const CameraFrame& camera, int x0, int y0, uint32_t sampleIndex, uint32_t requestMask,
+                        const Light& lights, glm::vec3* radiance, FirstHitAOV* aovs, GBufferSample* gbuffer,
+                        uint64_t& packets, uint64_t& divergent, uint64_t& cachedHits) const;
+
+    /// @brief Computes the AOVs of a camera ray's first hit.
+    FirstHitAOV firstHitAOV(const InstanceHit& hit) const;
+
+    /// @brief Marks pixels of a tile whose two-buffer error fell below the adaptive threshold.
+    /// @return True while the tile still has unconverged pixels.
+    bool updateTileConvergence(const RenderTile& tile, int W, int H);
+
+    /// @brief Returns the mean relative standard error over pixels with at least two samples.
+    float estimateNoise() const;
     
     /// @brief Samples glossy reflections using microfacet importance sampling.
     glm::vec3 sampleGlossyReflection(
@@ -95,7 +455,7 @@ private:
         const Material& material,
         const Light& lights,
         int depth,
-        microfacet::SeededRNG& rng
+        sampling::PixelSampler& sampler
     ) const;
     
     /// @brief Computes refraction contribution for dielectric materials.
@@ -105,7 +465,8 @@ private:
         const glm::vec3& normal,
         const Material& material,
         const Light& lights,
-        int depth
+        int depth,
+        sampling::PixelSampler& sampler
     ) const;
 };
 
@@ -116,13 +477,37 @@ class Raytracer
 {
 public:
     Raytracer() = default;
-    void loadModel(const ObjLoader&, const glm::mat4&, float, const Material&) {}
+    uint32_t loadModel(const ObjLoader&, const glm::mat4&, float, const Material&) { return 0; }
+    bool setInstanceTransform(uint32_t, const glm::mat4&) { return false; }
+    bool setInstanceMaterial(uint32_t, float, const Material&) { return false; }
+    bool removeInstance(uint32_t) { return false; }
+    void clearScene() {}
+    void commit() {}
+    bool needsCommit() const { return false; }
     glm::vec3 traceRay(const Ray&, const Light&, int = 3) const { return glm::vec3(0.0f); }
+    bool occluded(const glm::vec3&, const glm::vec3&, float) const { return false; }
+    uint32_t occludedBatch(const glm::vec3&, const glm::vec3*, const float*, uint32_t) const { return 0; }
     void renderImage(std::vector<glm::vec3>&, int, int, glm::vec3, glm::vec3, glm::vec3, float, const Light&) {}
     void setSeed(uint32_t) {}
     uint32_t getSeed() const { return 0; }
     void setReflectionSpp(int) {}
+    void setSamplerType(sampling::SamplerType) {}
+    void setPathTracerSettings(const PathTracerSettings&) {}
     int getReflectionSpp() const { return 0; }
+    void setPacketTracing(bool) {}
+    bool getPacketTracing() const { return false; }
+    void setTileSchedulerSettings(const TileSchedulerSettings&) {}
+    void setProgressiveSettings(const ProgressiveRenderSettings&) {}
+    void sampleDensityImage(std::vector<glm::vec3>& out) const { out.clear(); }
+    void setAOVsEnabled(bool) {}
+    const RaytraceAOVs& getAOVs() const { static const RaytraceAOVs empty; return empty; }
+    void setEnvironmentMap(std::shared_ptr<const EnvironmentMap>) {}
+    bool loadEnvironmentMap(const std::string&) { return false; }
+    void setEnvironmentIntensity(float) {}
+    void setLightSamplingSettings(const LightSamplingSettings&) {}
+    void setBVHCacheDirectory(const std::filesystem::path&) {}
+    void setBVHBuildAlgorithm(BVHBuildAlgorithm) {}
+    void setGBufferCacheEnabled(bool) {}
 };
 
 #endif // GLINT_ENABLE_RAYTRACING
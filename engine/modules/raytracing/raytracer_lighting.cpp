@@ -2,6 +2,7 @@
 #include "raytracer.h"
 #include "brdf.h"
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
 #include <limits>
 
@@ -35,6 +36,7 @@ namespace raytracer {
                     sample.direction = lightVec / sample.distance;
                     // Inverse square falloff for point lights
                     float attenuation = 1.0f / (1.0f + 0.1f * sample.distance + 0.01f * sample.distance * sample.distance);
+                    attenuation *= lightRangeWindow(sample.distance, light.range);
                     sample.color = light.color * light.intensity * attenuation;
                     sample.valid = glm::dot(sample.direction, normal) > 0.0f;
                 }
@@ -54,6 +56,7 @@ namespace raytracer {
                     
                     if (cosTheta > outerCone) {
                         float attenuation = 1.0f / (1.0f + 0.1f * sample.distance + 0.01f * sample.distance * sample.distance);
+                        attenuation *= lightRangeWindow(sample.distance, light.range);
                         
                         // Smooth falloff between inner and outer cone
                         if (cosTheta < innerCone) {
@@ -117,19 +120,25 @@ namespace raytracer {
         return ambientContrib * ambientLight * 0.1f; // Keep ambient subtle
     }
 
+    namespace {
+        // Offset along the normal that keeps shadow rays off the surface they leave
+        constexpr float kShadowBias = 0.001f;
+
+        float shadowRayLength(float lightDistance) {
+            // Directional lights report infinity; stop just short of local lights
+            return std::isinf(lightDistance) ? FLT_MAX : std::max(0.0f, lightDistance - 2.0f * kShadowBias);
+        }
+    }
+
     bool LightingSystem::isInShadow(
         const glm::vec3& hitPoint,
+        const glm::vec3& normal,
         const glm::vec3& lightDir,
         float lightDistance,
         const Raytracer& raytracer)
     {
-        // Offset to avoid self-intersection
-        Ray shadowRay(hitPoint + lightDir * 0.001f, lightDir);
-        
-        // Check intersection - implementation depends on raytracer's public interface
-        // For now, we'll return false (no shadows) to focus on lighting
-        // TODO: Add proper shadow ray intersection
-        return false;
+        const glm::vec3 origin = hitPoint + normal * kShadowBias;
+        return raytracer.occluded(origin, lightDir, shadowRayLength(lightDistance));
     }
 
     glm::vec3 LightingSystem::computeLighting(
@@ -138,26 +147,84 @@ namespace raytracer {
         const glm::vec3& viewDir,
         const Material& material,
         const Light& lights,
-        const Raytracer& raytracer)
+        const Raytracer& raytracer,
+        const LightSelection* selection)
     {
         glm::vec3 color(0.0f);
 
         // Add ambient lighting
         color += computeAmbient(material, lights.m_globalAmbient);
 
-        // Process each light
-        for (const auto& light : lights.m_lights) {
-            LightSample sample = sampleLight(light, hitPoint, normal);
-            
-            if (sample.valid) {
-                // Check for shadows (currently disabled for debugging)
-                bool inShadow = false; // isInShadow(hitPoint, sample.direction, sample.distance, raytracer);
-                
-                if (!inShadow) {
-                    MaterialEval eval = evaluateMaterial(material, normal, viewDir, sample.direction, sample.color);
-                    color += eval.color;
+        // Lights facing the point are gathered first so their shadow rays go out as one batch
+        constexpr uint32_t kBatch = Raytracer::kMaxOcclusionBatch;
+        LightSample samples[kBatch];
+        glm::vec3 directions[kBatch];
+        float distances[kBatch];
+        const glm::vec3 origin = hitPoint + normal * kShadowBias;
+
+        const LightSampler* sampler = selection ? selection->sampler : nullptr;
+        if (sampler && sampler->active() && selection->pixelSampler &&
+            sampler->lightCount() == lights.m_lights.size()) {
+            // Directional lights first, then the picked local lights scaled by 1 / (count * probability)
+            const std::vector<uint32_t>& always = sampler->alwaysEvaluated();
+            const uint32_t picks = sampler->samplesPerPoint();
+            const size_t total = always.size() + picks;
+            size_t next = 0;
+            while (next < total) {
+                uint32_t count = 0;
+                for (; next < total && count < kBatch; ++next) {
+                    LightSample sample;
+                    if (next < always.size()) {
+                        sample = sampleLight(lights.m_lights[always[next]], hitPoint, normal);
+                    } else {
+                        const uint32_t k = static_cast<uint32_t>(next - always.size());
+                        const float u = selection->pixelSampler->sample2D(selection->dimension, k, picks).x;
+                        const LightPick pick = sampler->pick(hitPoint, normal, u);
+                        if (pick.probability <= 0.0f)
+                            continue;
+                        sample = sampleLight(lights.m_lights[pick.index], hitPoint, normal);
+                        sample.color /= static_cast<float>(picks) * pick.probability;
+                    }
+                    if (!sample.valid)
+                        continue;
+                    directions[count] = sample.direction;
+                    distances[count] = shadowRayLength(sample.distance);
+                    samples[count++] = sample;
+                }
+                if (count == 0)
+                    continue;
+
+                const uint32_t blocked = raytracer.occludedBatch(origin, directions, distances, count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (blocked & (1u << i))
+                        continue;
+                    color += evaluateMaterial(material, normal, viewDir, samples[i].direction, samples[i].color).color;
                 }
             }
+            return color;
+        }
+
+        size_t next = 0;
+        while (next < lights.m_lights.size()) {
+            uint32_t count = 0;
+            for (; next < lights.m_lights.size() && count < kBatch; ++next) {
+                LightSample sample = sampleLight(lights.m_lights[next], hitPoint, normal);
+                if (!sample.valid)
+                    continue;
+                directions[count] = sample.direction;
+                distances[count] = shadowRayLength(sample.distance);
+                samples[count++] = sample;
+            }
+            if (count == 0)
+                continue;
+
+            const uint32_t blocked = raytracer.occludedBatch(origin, directions, distances, count);
+            for (uint32_t i = 0; i < count; ++i) {
+                if (blocked & (1u << i))
+                    continue;
+                MaterialEval eval = evaluateMaterial(material, normal, viewDir, samples[i].direction, samples[i].color);
+                color += eval.color;
+            }
         }
 
         return color;
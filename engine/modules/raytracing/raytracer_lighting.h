@@ -1,5 +1,5 @@
 // Machine Summary Block
-// {"file":"engine/modules/raytracing/raytracer_lighting.h","purpose":"Declares lighting helpers for the raytracing module","exports":["raytracer::LightingSystem","raytracer::material::getBaseColor","raytracer::material::getAmbientColor","raytracer::material::getF0"],"depends_on":["glm/glm.hpp","light.h","material.h","ray.h"],"notes":["samples_lights","performs_shadow_queries"]}
+// {"file":"engine/modules/raytracing/raytracer_lighting.h","purpose":"Declares lighting helpers for the raytracing module","exports":["raytracer::LightingSystem","raytracer::LightSelection","raytracer::material::getBaseColor","raytracer::material::getAmbientColor","raytracer::material::getF0"],"depends_on":["glm/glm.hpp","light.h","light_sampler.h","material.h","ray.h","sampler.h"],"notes":["samples_lights","performs_shadow_queries","stochastic_light_selection"]}
 // Human Summary
 // Lighting utilities that evaluate materials and lights for the ray tracer.
 
@@ -9,8 +9,10 @@
 
 #include <glm/glm.hpp>
 #include "light.h"
+#include "light_sampler.h"
 #include "material.h"
 #include "ray.h"
+#include "sampler.h"
 
 class Raytracer;
 
@@ -24,6 +26,13 @@ namespace raytracer {
         bool valid = false;        ///< Indicates whether the light contributes.
     };
 
+    /// @brief Picks a few local lights per shading point instead of evaluating all of them.
+    struct LightSelection {
+        const LightSampler* sampler = nullptr;             ///< Built for the light list being shaded.
+        const sampling::PixelSampler* pixelSampler = nullptr;
+        uint32_t dimension = 0;                            ///< Dimension reserved for the picks.
+    };
+
     /// @brief Captures diffuse/specular evaluation for a material.
     struct MaterialEval {
         glm::vec3 diffuse{0.0f};  ///< Diffuse lighting term.
@@ -57,21 +66,28 @@ namespace raytracer {
         );
 
         /// @brief Determines whether a surface point is shadowed for a light.
+        /// @details Casts an any-hit ray from the point, offset along @p normal, towards the light.
         static bool isInShadow(
             const glm::vec3& hitPoint,
+            const glm::vec3& normal,
             const glm::vec3& lightDir,
             float lightDistance,
             const Raytracer& raytracer
         );
 
         /// @brief Computes the full lighting contribution for a shading point.
+        /// @details Shadow rays towards every light facing the point are tested as one batch.
+        /// With an active @p selection, directional lights are still all evaluated but only
+        /// LightSampler::samplesPerPoint() local lights are picked, each weighted by the inverse
+        /// of its pick probability.
         static glm::vec3 computeLighting(
             const glm::vec3& hitPoint,
             const glm::vec3& normal,
             const glm::vec3& viewDir,
             const Material& material,
             const Light& lights,
-            const Raytracer& raytracer
+            const Raytracer& raytracer,
+            const LightSelection* selection = nullptr
         );
     };
 
@@ -0,0 +1,155 @@
+#include "sampler.h"
+#include <algorithm>
+
+namespace
+{
+    // Direction numbers of the second Sobol dimension (primitive polynomial x + 1): v_i = v_{i-1} ^ (v_{i-1} >> 1)
+    struct SobolDirections
+    {
+        uint32_t v[32] = {};
+        constexpr SobolDirections()
+        {
+            v[0] = 1u << 31;
+            for (int i = 1; i < 32; ++i)
+                v[i] = v[i - 1] ^ (v[i - 1] >> 1);
+        }
+    };
+
+    constexpr SobolDirections kSobolDim1;
+
+    uint32_t reverseBits(uint32_t x)
+    {
+        x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+        x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+        x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+        x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    // Hash that only lets each bit depend on lower bits (Burley 2020, "Practical Hash-based Owen Scrambling")
+    uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed)
+    {
+        x += seed;
+        x ^= x * 0x6c50b47cu;
+        x ^= x * 0xb82f1e52u;
+        x ^= x * 0xc7afe638u;
+        x ^= x * 0x8d22f6e6u;
+        return x;
+    }
+
+    // Owen scrambling of a fixed-point fraction: each bit is flipped by a hash of the bits above it
+    uint32_t nestedUniformScramble(uint32_t x, uint32_t seed)
+    {
+        return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+    }
+}
+
+namespace sampling
+{
+    uint32_t sobol(uint32_t index, uint32_t dimension)
+    {
+        if (dimension == 0)
+            return reverseBits(index);
+
+        uint32_t result = 0;
+        for (int bit = 0; index; index >>= 1, ++bit)
+        {
+            if (index & 1u)
+                result ^= kSobolDim1.v[bit];
+        }
+        return result;
+    }
+
+    glm::vec2 owenScrambledSobol2D(uint32_t index, uint32_t seed)
+    {
+        const uint32_t shuffled = nestedUniformScramble(index, seed);
+        const uint32_t x = nestedUniformScramble(sobol(shuffled, 0), hashCombine(seed, 0u));
+        const uint32_t y = nestedUniformScramble(sobol(shuffled, 1), hashCombine(seed, 1u));
+        return glm::vec2(toUnitFloat(x), toUnitFloat(y));
+    }
+
+    PixelSampler::PixelSampler(SamplerType type, uint32_t seed, uint32_t pixelKey, uint32_t sampleIndex)
+        : m_type(type),
+          m_pixelSeed(hashCombine(hash32(seed), pixelKey)),
+          m_sampleIndex(sampleIndex)
+    {
+    }
+
+    glm::vec2 PixelSampler::sample2D(uint32_t dimension, uint32_t subIndex, uint32_t subCount) const
+    {
+        const uint32_t dimensionSeed = hashCombine(m_pixelSeed, dimension);
+        if (m_type == SamplerType::Random)
+        {
+            HashRNG rng(hashCombine(dimensionSeed, m_sampleIndex * subCount + subIndex));
+            const float x = rng.uniform();
+            return glm::vec2(x, rng.uniform());
+        }
+
+        // Shuffle whole camera samples but keep a vertex's sub-samples in one aligned block, so a
+        // power-of-two set is itself a stratified Sobol net
+        const uint32_t sampleSlot = nestedUniformScramble(m_sampleIndex, hashCombine(dimensionSeed, 0x5eedu));
+        const uint32_t index = sampleSlot * subCount + subIndex;
+        const uint32_t x = nestedUniformScramble(sobol(index, 0), hashCombine(dimensionSeed, 0u));
+        const uint32_t y = nestedUniformScramble(sobol(index, 1), hashCombine(dimensionSeed, 1u));
+        return glm::vec2(toUnitFloat(x), toUnitFloat(y));
+    }
+
+    void AliasTable::build(const float* weights, uint32_t count)
+    {
+        m_bins.assign(count, Bin());
+        m_probabilities.assign(count, 0.0f);
+        m_totalWeight = 0.0;
+        if (count == 0)
+            return;
+
+        for (uint32_t i = 0; i < count; ++i)
+            m_totalWeight += std::max(0.0f, weights[i]);
+
+        // Vose's method: bins below the mean are topped up by bins above it
+        std::vector<double> scaled(count);
+        std::vector<uint32_t> small, large;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const double p = m_totalWeight > 0.0 ? std::max(0.0f, weights[i]) / m_totalWeight : 1.0 / count;
+            m_probabilities[i] = static_cast<float>(p);
+            scaled[i] = p * count;
+            m_bins[i].alias = i;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty())
+        {
+            const uint32_t s = small.back();
+            small.pop_back();
+            const uint32_t l = large.back();
+            m_bins[s].threshold = static_cast<float>(scaled[s]);
+            m_bins[s].alias = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Leftovers are full bins up to rounding error
+        for (uint32_t i : small)
+            m_bins[i].threshold = 1.0f;
+        for (uint32_t i : large)
+            m_bins[i].threshold = 1.0f;
+    }
+
+    uint32_t AliasTable::sample(float u, float& remapped) const
+    {
+        const uint32_t count = size();
+        const float scaled = u * static_cast<float>(count);
+        const uint32_t bin = std::min(static_cast<uint32_t>(scaled), count - 1);
+        const float x = std::min(scaled - static_cast<float>(bin), 0.99999994f);
+        const Bin& b = m_bins[bin];
+        if (x < b.threshold)
+        {
+            remapped = std::min(x / b.threshold, 0.99999994f);
+            return bin;
+        }
+        remapped = std::min((x - b.threshold) / (1.0f - b.threshold), 0.99999994f);
+        return b.alias;
+    }
+}
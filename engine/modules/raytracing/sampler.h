@@ -0,0 +1,162 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/sampler.h","purpose":"Declares the allocation-free sample generators used by the CPU raytracer: a counter-based hash RNG and Owen-scrambled Sobol sampling.","exports":["sampling::SamplerType","sampling::hash32","sampling::hashCombine","sampling::toUnitFloat","sampling::HashRNG","sampling::sobol","sampling::owenScrambledSobol2D","sampling::PixelSampler","sampling::AliasTable","sampling::powerHeuristic","sampling::samplerTypeName","sampling::parseSamplerType"],"depends_on":["glm/glm.hpp","<cstdint>","<string>"],"notes":["keyed_on_pixel_sample_dimension","deterministic_across_thread_counts","no_heap_allocation","burley_hash_based_owen_scrambling","alias_method_discrete_sampling"]}
+// Human Summary
+// Every random number is a pure function of (seed, pixel, sample, dimension), so renders repeat exactly no matter which thread traced a pixel, and samplers live on the stack.
+
+#pragma once
+/// @file sampler.h
+/// @brief Counter-based RNG and low-discrepancy sample sequences for the ray tracer.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace sampling
+{
+    /// @brief Source of the per-pixel sample values.
+    enum class SamplerType
+    {
+        Random, ///< Independent hashed values per (pixel, sample, dimension).
+        Sobol   ///< Owen-scrambled Sobol points; converges faster for smooth integrands.
+    };
+
+    /// @brief lowbias32 integer finalizer; a good avalanche for sequential inputs.
+    inline uint32_t hash32(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    /// @brief Mixes @p value into @p seed.
+    inline uint32_t hashCombine(uint32_t seed, uint32_t value)
+    {
+        return seed ^ (hash32(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+    }
+
+    /// @brief Maps 32 random bits to [0, 1) using the top 24 bits.
+    inline float toUnitFloat(uint32_t bits)
+    {
+        return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /// @brief Counter-based generator: value n is hash(key, n), so the state is two integers.
+    class HashRNG
+    {
+    public:
+        explicit HashRNG(uint32_t key = 0) : m_key(key) {}
+
+        /// @brief Returns the next 32 random bits.
+        uint32_t nextUint() { return hash32(hashCombine(m_key, m_counter++)); }
+
+        /// @brief Returns a uniform float in [0, 1).
+        float uniform() { return toUnitFloat(nextUint()); }
+
+    private:
+        uint32_t m_key = 0;
+        uint32_t m_counter = 0;
+    };
+
+    /// @brief Unscrambled Sobol value of @p index in dimension 0 or 1, as a 32-bit fixed-point fraction.
+    uint32_t sobol(uint32_t index, uint32_t dimension);
+
+    /// @brief 2D Sobol point with hash-based Owen scrambling and index shuffling.
+    /// @details Different seeds give statistically independent, still stratified, point sets; this
+    /// is how the sampler pads 2D Sobol to arbitrary dimensions.
+    glm::vec2 owenScrambledSobol2D(uint32_t index, uint32_t seed);
+
+    /// @brief Sample values for one camera sample of one pixel.
+    /// @details Dimensions are consumed in a fixed order along the path, so the value returned for
+    /// a given call depends only on the constructor arguments and the calls made before it.
+    class PixelSampler
+    {
+    public:
+        /// @param type Sequence to draw from.
+        /// @param seed Render seed.
+        /// @param pixelKey Unique id of the pixel (e.g. y * width + x).
+        /// @param sampleIndex Camera sample number within the pixel.
+        PixelSampler(SamplerType type, uint32_t seed, uint32_t pixelKey, uint32_t sampleIndex);
+
+        /// @brief Reserves the next 2D dimension for use with sample2D().
+        uint32_t nextDimension() { return m_dimension++; }
+
+        /// @brief Returns the next 2D sample.
+        glm::vec2 get2D() { return sample2D(nextDimension(), 0, 1); }
+
+        /// @brief Returns the next 1D sample (one dimension pair is consumed).
+        float get1D() { return get2D().x; }
+
+        /// @brief Returns point @p subIndex of a @p subCount point set in a reserved dimension.
+        /// @details Sets used by one vertex (e.g. several glossy lobe samples) are stratified
+        /// against each other and across camera samples when @p subCount is a power of two.
+        glm::vec2 sample2D(uint32_t dimension, uint32_t subIndex, uint32_t subCount) const;
+
+    private:
+        SamplerType m_type = SamplerType::Sobol;
+        uint32_t m_pixelSeed = 0;
+        uint32_t m_sampleIndex = 0;
+        uint32_t m_dimension = 0;
+    };
+
+    /// @brief Discrete distribution sampled in constant time with Walker's alias method.
+    class AliasTable
+    {
+    public:
+        /// @brief Builds the table from non-negative weights.
+        /// @details When every weight is zero the distribution is uniform, but totalWeight() stays 0.
+        void build(const float* weights, uint32_t count);
+
+        /// @brief Picks an entry.
+        /// @param u Uniform value in [0, 1).
+        /// @param remapped Receives a fresh uniform value in [0, 1) recovered from @p u, so one
+        /// value can drive both the choice and a continuous offset within the entry.
+        /// @return Index of the chosen entry.
+        uint32_t sample(float u, float& remapped) const;
+
+        /// @brief Returns the probability of picking entry @p index.
+        float probability(uint32_t index) const { return m_probabilities[index]; }
+
+        /// @brief Returns the sum of the weights the table was built from.
+        double totalWeight() const { return m_totalWeight; }
+
+        uint32_t size() const { return static_cast<uint32_t>(m_bins.size()); }
+        bool empty() const { return m_bins.empty(); }
+
+    private:
+        struct Bin
+        {
+            float threshold = 1.0f; ///< Keep this bin when the in-bin sample falls below the threshold.
+            uint32_t alias = 0;     ///< Entry returned otherwise.
+        };
+        std::vector<Bin> m_bins;
+        std::vector<float> m_probabilities;
+        double m_totalWeight = 0.0;
+    };
+
+    /// @brief Power heuristic (beta = 2) weight of a sample drawn with @p pdfA when @p pdfB is the other strategy.
+    inline float powerHeuristic(float pdfA, float pdfB)
+    {
+        const float a = pdfA * pdfA;
+        const float b = pdfB * pdfB;
+        return a > 0.0f ? a / (a + b) : 0.0f;
+    }
+
+    /// @brief Returns the lowercase name used by the CLI ("random", "sobol").
+    inline const char* samplerTypeName(SamplerType type)
+    {
+        return type == SamplerType::Random ? "random" : "sobol";
+    }
+
+    /// @brief Parses a sampler name.
+    /// @return False when the name is not recognised; @p type is left unchanged.
+    inline bool parseSamplerType(const std::string& name, SamplerType& type)
+    {
+        if (name == "random") { type = SamplerType::Random; return true; }
+        if (name == "sobol") { type = SamplerType::Sobol; return true; }
+        return false;
+    }
+}
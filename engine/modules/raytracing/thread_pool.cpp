@@ -0,0 +1,153 @@
+#include "thread_pool.h"
+
+namespace
+{
+    uint64_t packRange(uint32_t begin, uint32_t end)
+    {
+        return (static_cast<uint64_t>(end) << 32) | begin;
+    }
+
+    uint32_t rangeBegin(uint64_t range) { return static_cast<uint32_t>(range); }
+    uint32_t rangeEnd(uint64_t range) { return static_cast<uint32_t>(range >> 32); }
+}
+
+ThreadPool::ThreadPool(unsigned threadCount)
+    : m_threadCount(threadCount > 0 ? threadCount : defaultThreadCount())
+{
+    m_ranges.reset(new WorkRange[m_threadCount]);
+    m_threads.reserve(m_threadCount - 1);
+    for (unsigned i = 1; i < m_threadCount; ++i)
+        m_threads.emplace_back(&ThreadPool::workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+unsigned ThreadPool::defaultThreadCount()
+{
+    const unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::parallelFor(uint32_t count, const Task& fn)
+{
+    if (count == 0)
+        return;
+
+    if (m_threadCount == 1 || count == 1)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            fn(i, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+
+    // Contiguous slices keep neighbouring indices (and their cache lines) on one worker
+    for (unsigned w = 0; w < m_threadCount; ++w)
+    {
+        const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * w / m_threadCount);
+        const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (w + 1) / m_threadCount);
+        m_ranges[w].range.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &fn;
+        m_busyWorkers = m_threadCount - 1;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    runWorker(0, fn);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_task = nullptr;
+}
+
+void ThreadPool::workerMain(unsigned worker)
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        const Task* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop)
+                return;
+            seenGeneration = m_generation;
+            task = m_task;
+        }
+
+        runWorker(worker, *task);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0)
+            m_done.notify_one();
+    }
+}
+
+void ThreadPool::runWorker(unsigned worker, const Task& fn)
+{
+    uint32_t index = 0;
+    do
+    {
+        while (popLocal(worker, index))
+            fn(index, worker);
+    } while (steal(worker));
+}
+
+bool ThreadPool::popLocal(unsigned worker, uint32_t& index)
+{
+    std::atomic<uint64_t>& range = m_ranges[worker].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while (true)
+    {
+        const uint32_t begin = rangeBegin(current);
+        const uint32_t end = rangeEnd(current);
+        if (begin >= end)
+            return false;
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_acq_rel))
+        {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::steal(unsigned worker)
+{
+    for (unsigned offset = 1; offset < m_threadCount; ++offset)
+    {
+        const unsigned victim = (worker + offset) % m_threadCount;
+        std::atomic<uint64_t>& range = m_ranges[victim].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        while (true)
+        {
+            const uint32_t begin = rangeBegin(current);
+            const uint32_t end = rangeEnd(current);
+            if (begin >= end)
+                break;
+
+            // Take the back half (at least one index); the owner keeps working from the front
+            const uint32_t take = (end - begin + 1) / 2;
+            if (range.compare_exchange_weak(current, packRange(begin, end - take), std::memory_order_acq_rel))
+            {
+                // Our own range is empty, so no other thread writes it concurrently
+                m_ranges[worker].range.store(packRange(end - take, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,70 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/thread_pool.h","purpose":"Declares the persistent work-stealing thread pool used by the CPU raytracer.","exports":["ThreadPool"],"depends_on":["<atomic>","<condition_variable>","<functional>","<memory>","<mutex>","<thread>","<vector>"],"notes":["caller_thread_participates","per_worker_index_ranges","lock_free_range_stealing"]}
+// Human Summary
+// Fixed set of worker threads that run parallel-for jobs; each worker drains its own index range and steals half of another worker's remainder when it runs dry.
+
+#pragma once
+/// @file thread_pool.h
+/// @brief Work-stealing thread pool for parallel-for style jobs.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Persistent worker threads executing index-range jobs with work stealing.
+/// @details Each job's index space is split into one contiguous range per worker. A range is a
+/// single 64-bit atomic (begin | end << 32): the owner pops from the front and thieves take the
+/// back half with compare-and-swap, so no locks are taken while a job runs.
+class ThreadPool
+{
+public:
+    /// @brief Job body, invoked as fn(index, workerIndex).
+    using Task = std::function<void(uint32_t index, unsigned worker)>;
+
+    /// @brief Starts the workers.
+    /// @param threadCount Total threads including the caller; 0 selects the hardware concurrency.
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @brief Returns the number of threads that execute jobs, including the caller.
+    unsigned threadCount() const { return m_threadCount; }
+
+    /// @brief Runs @p fn for every index in [0, count) and blocks until all have finished.
+    /// @details The calling thread works as worker 0. Jobs must not call parallelFor() on the same pool.
+    void parallelFor(uint32_t count, const Task& fn);
+
+    /// @brief Returns the hardware concurrency, at least 1.
+    static unsigned defaultThreadCount();
+
+private:
+    struct alignas(64) WorkRange
+    {
+        std::atomic<uint64_t> range{0};
+    };
+
+    unsigned m_threadCount = 1;
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<WorkRange[]> m_ranges;
+
+    std::mutex m_submitMutex;  // serializes parallelFor() callers
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const Task* m_task = nullptr;
+    uint64_t m_generation = 0;
+    unsigned m_busyWorkers = 0;
+    bool m_stop = false;
+
+    void workerMain(unsigned worker);
+    void runWorker(unsigned worker, const Task& fn);
+    bool popLocal(unsigned worker, uint32_t& index);
+    bool steal(unsigned worker);
+};
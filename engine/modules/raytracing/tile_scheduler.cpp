@@ -0,0 +1,95 @@
+#include "tile_scheduler.h"
+#include <algorithm>
+
+namespace
+{
+    // Interleaves the low 16 bits of x and y into a Z-order key
+    uint32_t mortonKey(uint32_t x, uint32_t y)
+    {
+        auto spread = [](uint32_t v) {
+            v &= 0xFFFFu;
+            v = (v | (v << 8)) & 0x00FF00FFu;
+            v = (v | (v << 4)) & 0x0F0F0F0Fu;
+            v = (v | (v << 2)) & 0x33333333u;
+            v = (v | (v << 1)) & 0x55555555u;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+}
+
+std::vector<RenderTile> buildTileList(int width, int height, int tileSize, TileOrder order)
+{
+    std::vector<RenderTile> tiles;
+    if (width <= 0 || height <= 0)
+        return tiles;
+
+    tileSize = std::max(1, tileSize);
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+
+    auto makeTile = [&](int tx, int ty) {
+        RenderTile tile;
+        tile.x0 = tx * tileSize;
+        tile.y0 = ty * tileSize;
+        tile.x1 = std::min(width, tile.x0 + tileSize);
+        tile.y1 = std::min(height, tile.y0 + tileSize);
+        return tile;
+    };
+
+    tiles.reserve(static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY));
+    switch (order)
+    {
+        case TileOrder::Scanline:
+            for (int ty = 0; ty < tilesY; ++ty)
+                for (int tx = 0; tx < tilesX; ++tx)
+                    tiles.push_back(makeTile(tx, ty));
+            break;
+
+        case TileOrder::Morton:
+        {
+            std::vector<std::pair<uint32_t, int>> keys;
+            keys.reserve(static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY));
+            for (int ty = 0; ty < tilesY; ++ty)
+                for (int tx = 0; tx < tilesX; ++tx)
+                    keys.emplace_back(mortonKey(static_cast<uint32_t>(tx), static_cast<uint32_t>(ty)), ty * tilesX + tx);
+            std::sort(keys.begin(), keys.end());
+            for (const auto& key : keys)
+                tiles.push_back(makeTile(key.second % tilesX, key.second / tilesX));
+            break;
+        }
+
+        case TileOrder::Spiral:
+        {
+            // Square spiral from the centre tile, skipping positions outside the grid
+            const size_t total = static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY);
+            int x = (tilesX - 1) / 2;
+            int y = (tilesY - 1) / 2;
+            const int dx[4] = {1, 0, -1, 0};
+            const int dy[4] = {0, 1, 0, -1};
+            int dir = 0;
+            int runLength = 1;
+            tiles.push_back(makeTile(x, y));
+            while (tiles.size() < total)
+            {
+                for (int run = 0; run < 2 && tiles.size() < total; ++run)
+                {
+                    for (int step = 0; step < runLength && tiles.size() < total; ++step)
+                    {
+                        x += dx[dir];
+                        y += dy[dir];
+                        if (x >= 0 && x < tilesX && y >= 0 && y < tilesY)
+                            tiles.push_back(makeTile(x, y));
+                    }
+                    dir = (dir + 1) % 4;
+                }
+                runLength++;
+            }
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+        tiles[i].index = static_cast<uint32_t>(i);
+    return tiles;
+}
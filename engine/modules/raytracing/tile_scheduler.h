@@ -0,0 +1,111 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/tile_scheduler.h","purpose":"Declares image tiling, tile ordering, scheduler settings, and lock-free render progress for the CPU raytracer.","exports":["TileOrder","RenderTile","TileSchedulerSettings","ProgressiveRenderSettings","RenderProgress","TileCompletedCallback","buildTileList","tileOrderName","parseTileOrder"],"depends_on":["<atomic>","<cstdint>","<functional>","<string>","<vector>"],"notes":["scanline_morton_spiral_orders","progressive_stop_conditions","adaptive_sampling_thresholds","atomic_progress_counters","tile_callback_runs_on_worker_threads"]}
+// Human Summary
+// Splits an image into square tiles in a chosen order and tracks completed tiles and pixels with atomics so progress can be read while a render runs.
+
+#pragma once
+/// @file tile_scheduler.h
+/// @brief Render tiles, tile ordering, and progress tracking for the tiled CPU renderer.
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// @brief Order in which tiles are handed to workers.
+enum class TileOrder
+{
+    Scanline, ///< Row by row from the top.
+    Morton,   ///< Z-order curve; neighbouring tiles are scheduled close together.
+    Spiral    ///< Outward from the image centre, so the subject resolves first.
+};
+
+/// @brief Pixel rectangle [x0, x1) x [y0, y1) rendered as one unit of work.
+struct RenderTile
+{
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    uint32_t index = 0; ///< Position in the schedule.
+
+    /// @brief Returns the number of pixels covered.
+    uint64_t pixelCount() const { return static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0); }
+};
+
+/// @brief Tiling and threading parameters for renderImage().
+struct TileSchedulerSettings
+{
+    int tileSize = 32;                  ///< Tile edge in pixels; rounded up to the ray packet block size.
+    TileOrder order = TileOrder::Morton;
+    unsigned threadCount = 0;           ///< Render threads including the caller; 0 uses every hardware thread.
+};
+
+/// @brief Stop conditions for progressive rendering; whichever is reached first ends the render.
+/// @details Every pixel receives at least one sample regardless of the budgets.
+struct ProgressiveRenderSettings
+{
+    int targetSpp = 1;            ///< Samples per pixel to accumulate.
+    double timeBudgetMs = 0.0;    ///< Wall-clock budget; no new tiles start after it expires. 0 disables.
+    float noiseThreshold = 0.0f;  ///< Mean relative standard error to stop at. 0 disables.
+    float adaptiveThreshold = 0.0f; ///< Per-pixel error below which a pixel stops receiving samples. 0 disables.
+    int adaptiveMinSpp = 4;       ///< Samples a pixel takes before it may be marked converged.
+};
+
+/// @brief Progress of the current render, updated with atomics only.
+/// @details Tile and pixel counters cover the pass in flight; passesCompleted counts finished passes.
+struct RenderProgress
+{
+    std::atomic<uint32_t> tilesCompleted{0};
+    std::atomic<uint64_t> pixelsCompleted{0};
+    std::atomic<uint32_t> tileCount{0};
+    std::atomic<uint64_t> pixelCount{0};
+    std::atomic<uint32_t> passesCompleted{0};
+
+    /// @brief Starts tracking a pass with the given totals.
+    void reset(uint32_t tiles, uint64_t pixels)
+    {
+        tilesCompleted.store(0, std::memory_order_relaxed);
+        pixelsCompleted.store(0, std::memory_order_relaxed);
+        tileCount.store(tiles, std::memory_order_relaxed);
+        pixelCount.store(pixels, std::memory_order_release);
+    }
+
+    /// @brief Returns completed pixels as a fraction in [0, 1].
+    float fraction() const
+    {
+        const uint64_t total = pixelCount.load(std::memory_order_acquire);
+        return total ? static_cast<float>(pixelsCompleted.load(std::memory_order_relaxed)) / static_cast<float>(total) : 0.0f;
+    }
+};
+
+/// @brief Called after each tile finishes, from the worker thread that rendered it.
+/// @details Receives the tile and the number of tiles completed so far (including this one).
+/// Implementations must be thread-safe and should return quickly.
+using TileCompletedCallback = std::function<void(const RenderTile& tile, uint32_t tilesCompleted, uint32_t tileCount)>;
+
+/// @brief Splits a width x height image into tiles in the requested order.
+std::vector<RenderTile> buildTileList(int width, int height, int tileSize, TileOrder order);
+
+/// @brief Returns the lowercase name used by the CLI ("scanline", "morton", "spiral").
+inline const char* tileOrderName(TileOrder order)
+{
+    switch (order)
+    {
+        case TileOrder::Scanline: return "scanline";
+        case TileOrder::Morton: return "morton";
+        case TileOrder::Spiral: return "spiral";
+    }
+    return "morton";
+}
+
+/// @brief Parses a tile order name.
+/// @return False when the name is not recognised; @p order is left unchanged.
+inline bool parseTileOrder(const std::string& name, TileOrder& order)
+{
+    if (name == "scanline") { order = TileOrder::Scanline; return true; }
+    if (name == "morton") { order = TileOrder::Morton; return true; }
+    if (name == "spiral") { order = TileOrder::Spiral; return true; }
+    return false;
+}
@@ -0,0 +1,285 @@
+#include "triangle_packet.h"
+#include <cfloat>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(__EMSCRIPTEN__)
+#define GLINT_RT_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define GLINT_RT_SIMD_X86 0
+#endif
+
+// GCC/Clang need per-function target attributes to emit AVX2 without compiling the whole
+// module for it; MSVC accepts the intrinsics directly.
+#if GLINT_RT_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define GLINT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GLINT_TARGET_AVX2
+#endif
+
+namespace
+{
+    // Epsilon of the reference Moeller-Trumbore test. The parallel test scales it by
+    // |e1|*|e2|*|d|: rays arrive in object space with unnormalized directions, so det alone
+    // shrinks with the instance scale. t is already in world units and uses it as is.
+    constexpr float kEpsilon = 1e-6f;
+    constexpr float kEpsilon2 = kEpsilon * kEpsilon;
+
+    bool intersectPacketsScalar(const TrianglePacket* packets, uint32_t packetCount,
+                                const PacketRay& ray, float& tMax, PacketHit& hit)
+    {
+        const glm::vec3& o = ray.origin;
+        const glm::vec3& d = ray.direction;
+        const float dirScale = kEpsilon2 * glm::dot(d, d);
+        bool found = false;
+
+        for (uint32_t k = 0; k < packetCount; ++k)
+        {
+            const TrianglePacket& packet = packets[k];
+            for (int lane = 0; lane < TrianglePacket::kWidth; ++lane)
+            {
+                glm::vec3 e1 = packet.e1(lane);
+                glm::vec3 e2 = packet.e2(lane);
+
+                glm::vec3 p = glm::cross(d, e2);
+                float det = glm::dot(e1, p);
+                // Squared, so zero-edge padding lanes fail it too
+                if (det * det <= dirScale * glm::dot(e1, e1) * glm::dot(e2, e2)) continue;
+
+                float invDet = 1.0f / det;
+                glm::vec3 s = o - packet.v0(lane);
+                float u = glm::dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+
+                glm::vec3 q = glm::cross(s, e1);
+                float v = glm::dot(d, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+
+                float t = glm::dot(e2, q) * invDet;
+                if (t <= kEpsilon || t >= tMax) continue;
+
+                tMax = t;
+                hit.u = u;
+                hit.v = v;
+                hit.packet = k;
+                hit.lane = static_cast<uint32_t>(lane);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+#if GLINT_RT_SIMD_X86
+    // Picks the nearest accepted lane; ties keep the lowest lane to match scalar ordering
+    inline bool resolveLanes(int mask, const float* t, const float* u, const float* v,
+                             int width, uint32_t packetBase, float& tMax, PacketHit& hit)
+    {
+        bool found = false;
+        for (int lane = 0; lane < width; ++lane)
+        {
+            if (!(mask & (1 << lane)) || t[lane] >= tMax)
+                continue;
+            tMax = t[lane];
+            hit.u = u[lane];
+            hit.v = v[lane];
+            hit.packet = packetBase + static_cast<uint32_t>(lane / TrianglePacket::kWidth);
+            hit.lane = static_cast<uint32_t>(lane % TrianglePacket::kWidth);
+            found = true;
+        }
+        return found;
+    }
+
+    bool intersectPacketsSSE2(const TrianglePacket* packets, uint32_t packetCount,
+                              const PacketRay& ray, float& tMax, PacketHit& hit)
+    {
+        const __m128 ox = _mm_set1_ps(ray.origin.x), oy = _mm_set1_ps(ray.origin.y), oz = _mm_set1_ps(ray.origin.z);
+        const __m128 dx = _mm_set1_ps(ray.direction.x), dy = _mm_set1_ps(ray.direction.y), dz = _mm_set1_ps(ray.direction.z);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 eps = _mm_set1_ps(kEpsilon);
+        const __m128 dirScale = _mm_set1_ps(kEpsilon2 * glm::dot(ray.direction, ray.direction));
+        bool found = false;
+
+        for (uint32_t k = 0; k < packetCount; ++k)
+        {
+            const TrianglePacket& packet = packets[k];
+            const __m128 e1x = _mm_load_ps(packet.e1x), e1y = _mm_load_ps(packet.e1y), e1z = _mm_load_ps(packet.e1z);
+            const __m128 e2x = _mm_load_ps(packet.e2x), e2y = _mm_load_ps(packet.e2y), e2z = _mm_load_ps(packet.e2z);
+
+            // p = d x e2, det = e1 . p
+            const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(e2y, dz));
+            const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(e2z, dx));
+            const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(e2x, dy));
+            const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            const __m128 e1len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, e1x), _mm_mul_ps(e1y, e1y)), _mm_mul_ps(e1z, e1z));
+            const __m128 e2len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, e2x), _mm_mul_ps(e2y, e2y)), _mm_mul_ps(e2z, e2z));
+            __m128 mask = _mm_cmpgt_ps(_mm_mul_ps(det, det), _mm_mul_ps(dirScale, _mm_mul_ps(e1len2, e2len2)));
+            if (!_mm_movemask_ps(mask)) continue;
+
+            const __m128 invDet = _mm_div_ps(one, det);
+            const __m128 sx = _mm_sub_ps(ox, _mm_load_ps(packet.v0x));
+            const __m128 sy = _mm_sub_ps(oy, _mm_load_ps(packet.v0y));
+            const __m128 sz = _mm_sub_ps(oz, _mm_load_ps(packet.v0z));
+            const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+            // q = s x e1
+            const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(e1y, sz));
+            const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(e1z, sx));
+            const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(e1x, sy));
+            const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+            const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, eps), _mm_cmplt_ps(t, _mm_set1_ps(tMax))));
+
+            const int bits = _mm_movemask_ps(mask);
+            if (!bits) continue;
+
+            alignas(16) float tv[4], uv[4], vv[4];
+            _mm_store_ps(tv, t);
+            _mm_store_ps(uv, u);
+            _mm_store_ps(vv, v);
+            found |= resolveLanes(bits, tv, uv, vv, 4, k, tMax, hit);
+        }
+        return found;
+    }
+
+    // Two 4-wide packets fused into one 8-wide register
+    GLINT_TARGET_AVX2 inline __m256 loadPair(const float* lo, const float* hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(lo)), _mm_load_ps(hi), 1);
+    }
+
+    GLINT_TARGET_AVX2 bool intersectPacketsAVX2(const TrianglePacket* packets, uint32_t packetCount,
+                                                const PacketRay& ray, float& tMax, PacketHit& hit)
+    {
+        // Odd trailing packets pair with an all-degenerate packet
+        static const TrianglePacket kEmptyPacket = {};
+
+        const __m256 ox = _mm256_set1_ps(ray.origin.x), oy = _mm256_set1_ps(ray.origin.y), oz = _mm256_set1_ps(ray.origin.z);
+        const __m256 dx = _mm256_set1_ps(ray.direction.x), dy = _mm256_set1_ps(ray.direction.y), dz = _mm256_set1_ps(ray.direction.z);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 eps = _mm256_set1_ps(kEpsilon);
+        const __m256 dirScale = _mm256_set1_ps(kEpsilon2 * glm::dot(ray.direction, ray.direction));
+        bool found = false;
+
+        for (uint32_t k = 0; k < packetCount; k += 2)
+        {
+            const TrianglePacket& a = packets[k];
+            const TrianglePacket& b = (k + 1 < packetCount) ? packets[k + 1] : kEmptyPacket;
+
+            const __m256 e1x = loadPair(a.e1x, b.e1x), e1y = loadPair(a.e1y, b.e1y), e1z = loadPair(a.e1z, b.e1z);
+            const __m256 e2x = loadPair(a.e2x, b.e2x), e2y = loadPair(a.e2y, b.e2y), e2z = loadPair(a.e2z, b.e2z);
+
+            const __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(e2y, dz));
+            const __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(e2z, dx));
+            const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(e2x, dy));
+            const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+            const __m256 e1len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, e1x), _mm256_mul_ps(e1y, e1y)), _mm256_mul_ps(e1z, e1z));
+            const __m256 e2len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, e2x), _mm256_mul_ps(e2y, e2y)), _mm256_mul_ps(e2z, e2z));
+            __m256 mask = _mm256_cmp_ps(_mm256_mul_ps(det, det), _mm256_mul_ps(dirScale, _mm256_mul_ps(e1len2, e2len2)), _CMP_GT_OQ);
+            if (!_mm256_movemask_ps(mask)) continue;
+
+            const __m256 invDet = _mm256_div_ps(one, det);
+            const __m256 sx = _mm256_sub_ps(ox, loadPair(a.v0x, b.v0x));
+            const __m256 sy = _mm256_sub_ps(oy, loadPair(a.v0y, b.v0y));
+            const __m256 sz = _mm256_sub_ps(oz, loadPair(a.v0z, b.v0z));
+            const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), invDet);
+            mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+
+            const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(e1y, sz));
+            const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(e1z, sx));
+            const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(e1x, sy));
+            const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), invDet);
+            mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ)));
+
+            const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), invDet);
+            mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(t, eps, _CMP_GT_OQ), _mm256_cmp_ps(t, _mm256_set1_ps(tMax), _CMP_LT_OQ)));
+
+            const int bits = _mm256_movemask_ps(mask);
+            if (!bits) continue;
+
+            alignas(32) float tv[8], uv[8], vv[8];
+            _mm256_store_ps(tv, t);
+            _mm256_store_ps(uv, u);
+            _mm256_store_ps(vv, v);
+            found |= resolveLanes(bits, tv, uv, vv, 8, k, tMax, hit);
+        }
+        return found;
+    }
+
+    bool cpuSupportsAVX2()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif // GLINT_RT_SIMD_X86
+}
+
+TrianglePacketIntersectFn selectTriangleKernel(TriangleKernel maxKernel, TriangleKernel* chosen)
+{
+    TriangleKernel kernel = TriangleKernel::Scalar;
+    TrianglePacketIntersectFn fn = intersectPacketsScalar;
+#if GLINT_RT_SIMD_X86
+    if (maxKernel >= TriangleKernel::AVX2 && cpuSupportsAVX2())
+    {
+        kernel = TriangleKernel::AVX2;
+        fn = intersectPacketsAVX2;
+    }
+    else if (maxKernel >= TriangleKernel::SSE2)
+    {
+        // SSE2 is part of the x86-64 baseline
+        kernel = TriangleKernel::SSE2;
+        fn = intersectPacketsSSE2;
+    }
+#else
+    (void)maxKernel;
+#endif
+    if (chosen)
+        *chosen = kernel;
+    return fn;
+}
+
+const char* triangleKernelName(TriangleKernel kernel)
+{
+    switch (kernel)
+    {
+    case TriangleKernel::AVX2: return "AVX2";
+    case TriangleKernel::SSE2: return "SSE2";
+    default: return "scalar";
+    }
+}
+
+void packTriangle(TrianglePacket& packet, int lane, const glm::vec3& v0, const glm::vec3& v1,
+                  const glm::vec3& v2, uint32_t primId)
+{
+    const glm::vec3 e1 = v1 - v0;
+    const glm::vec3 e2 = v2 - v0;
+    packet.v0x[lane] = v0.x; packet.v0y[lane] = v0.y; packet.v0z[lane] = v0.z;
+    packet.e1x[lane] = e1.x; packet.e1y[lane] = e1.y; packet.e1z[lane] = e1.z;
+    packet.e2x[lane] = e2.x; packet.e2y[lane] = e2.y; packet.e2z[lane] = e2.z;
+    packet.primId[lane] = primId;
+}
+
+void clearTriangleLane(TrianglePacket& packet, int lane)
+{
+    packTriangle(packet, lane, glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), TrianglePacket::kInvalidId);
+}
@@ -0,0 +1,75 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/triangle_packet.h","purpose":"Declares structure-of-arrays triangle packets and the SIMD intersection kernels that test them.","exports":["TrianglePacket","PacketRay","PacketHit","TriangleKernel","TrianglePacketIntersectFn","selectTriangleKernel","triangleKernelName","packTriangle"],"depends_on":["glm/glm.hpp","<cstdint>"],"notes":["four_wide_soa_layout","precomputed_edges","runtime_cpu_dispatch_scalar_sse2_avx2"]}
+// Human Summary
+// Mesh triangles packed four at a time with precomputed edges so leaf tests run as one SIMD Moeller-Trumbore per packet (two packets per AVX2 op).
+
+#pragma once
+/// @file triangle_packet.h
+/// @brief SoA triangle packets and SIMD ray/triangle intersection kernels.
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+/// @brief Four triangles stored as vertex 0 plus two edges, one array per component.
+/// @details Unused lanes hold zero edges, which every kernel rejects as degenerate.
+struct alignas(16) TrianglePacket
+{
+    static constexpr int kWidth = 4;
+    static constexpr uint32_t kInvalidId = 0xFFFFFFFFu;
+
+    float v0x[kWidth], v0y[kWidth], v0z[kWidth];
+    float e1x[kWidth], e1y[kWidth], e1z[kWidth];
+    float e2x[kWidth], e2y[kWidth], e2z[kWidth];
+    uint32_t primId[kWidth]; ///< Source triangle index per lane, kInvalidId for padding.
+
+    /// @brief Returns lane vertex 0.
+    glm::vec3 v0(int lane) const { return glm::vec3(v0x[lane], v0y[lane], v0z[lane]); }
+    /// @brief Returns lane edge v1 - v0.
+    glm::vec3 e1(int lane) const { return glm::vec3(e1x[lane], e1y[lane], e1z[lane]); }
+    /// @brief Returns lane edge v2 - v0.
+    glm::vec3 e2(int lane) const { return glm::vec3(e2x[lane], e2y[lane], e2z[lane]); }
+};
+
+static_assert(sizeof(TrianglePacket) == 160, "TrianglePacket layout changed");
+
+/// @brief Ray in the space of the packets being tested; the direction need not be normalized.
+struct PacketRay
+{
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f};
+};
+
+/// @brief Closest hit found by a packet kernel.
+struct PacketHit
+{
+    float u = 0.0f;           ///< Barycentric weight of v1.
+    float v = 0.0f;           ///< Barycentric weight of v2.
+    uint32_t packet = 0;      ///< Packet index relative to the first packet passed in.
+    uint32_t lane = 0;        ///< Lane within that packet.
+};
+
+/// @brief Available intersection kernel implementations.
+enum class TriangleKernel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/// @brief Tests @p packetCount consecutive packets and keeps the closest hit in (0, tMax).
+/// @return True when a hit closer than the incoming tMax was found; tMax and hit are updated.
+using TrianglePacketIntersectFn = bool (*)(const TrianglePacket* packets, uint32_t packetCount,
+                                           const PacketRay& ray, float& tMax, PacketHit& hit);
+
+/// @brief Returns the kernel for the best instruction set the CPU supports, capped at @p maxKernel.
+TrianglePacketIntersectFn selectTriangleKernel(TriangleKernel maxKernel, TriangleKernel* chosen = nullptr);
+
+/// @brief Returns a short name for logging.
+const char* triangleKernelName(TriangleKernel kernel);
+
+/// @brief Writes one triangle into a packet lane.
+void packTriangle(TrianglePacket& packet, int lane, const glm::vec3& v0, const glm::vec3& v1,
+                  const glm::vec3& v2, uint32_t primId);
+
+/// @brief Fills a lane with a degenerate triangle that never reports a hit.
+void clearTriangleLane(TrianglePacket& packet, int lane);
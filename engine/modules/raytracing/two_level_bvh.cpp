@@ -0,0 +1,693 @@
+#include "two_level_bvh.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    // FNV-1a over raw bytes; cheap compared to a BVH build and stable across runs
+    uint64_t hashBytes(uint64_t h, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    uint64_t hashMesh(const ObjLoader& loader)
+    {
+        const uint64_t vertCount = static_cast<uint64_t>(loader.getVertCount());
+        const uint64_t indexCount = static_cast<uint64_t>(loader.getIndexCount());
+        uint64_t h = 14695981039346656037ull;
+        h = hashBytes(h, &vertCount, sizeof(vertCount));
+        h = hashBytes(h, &indexCount, sizeof(indexCount));
+        h = hashBytes(h, loader.getPositions(), vertCount * 3 * sizeof(float));
+        h = hashBytes(h, loader.getFaces(), indexCount * sizeof(unsigned int));
+        // Identical positions with different smoothing or UVs shade differently, so they are distinct meshes
+        if (loader.getNormals())
+            h = hashBytes(h, loader.getNormals(), vertCount * 3 * sizeof(float));
+        if (loader.hasTexcoords())
+            h = hashBytes(h, loader.getTexcoords(), vertCount * 2 * sizeof(float));
+        return h;
+    }
+
+    // Meshes below this size gain little from a cooperative build, so several are built at once instead
+    constexpr size_t kCooperativeBuildTriangles = 64 * 1024;
+
+    // Runs fn(begin, end) over fixed slices of [0, count), spread over the pool when there is one
+    template <typename Fn>
+    void forEachChunk(ThreadPool* pool, size_t count, const Fn& fn)
+    {
+        constexpr size_t kChunk = 16 * 1024;
+        const size_t chunks = (count + kChunk - 1) / kChunk;
+        const auto run = [&](size_t chunk) { fn(chunk * kChunk, std::min(count, (chunk + 1) * kChunk)); };
+        if (!pool)
+        {
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+                run(chunk);
+            return;
+        }
+        pool->parallelFor(static_cast<uint32_t>(chunks), [&](uint32_t chunk, unsigned) { run(chunk); });
+    }
+
+    // Top-level leaves stay tiny: each entry costs a ray transform plus a bottom-level traversal
+    BVHBuildSettings topLevelSettings()
+    {
+        BVHBuildSettings settings;
+        settings.maxLeafSize = 2;
+        settings.intersectionCost = 4.0f;
+        return settings;
+    }
+}
+
+TwoLevelBVH::TwoLevelBVH()
+{
+    setMaxTriangleKernel(TriangleKernel::AVX2);
+}
+
+void TwoLevelBVH::setMaxTriangleKernel(TriangleKernel maxKernel)
+{
+    m_kernel = selectTriangleKernel(maxKernel, &m_kernelType);
+}
+
+void TwoLevelBVH::clear()
+{
+    m_meshes.clear();
+    m_instances.clear();
+    m_freeMeshes.clear();
+    m_freeInstances.clear();
+    m_topLevel.clear();
+    m_stats = TwoLevelBVHStats();
+    m_topLevelDirty = false;
+}
+
+uint32_t TwoLevelBVH::addMesh(const ObjLoader& loader)
+{
+    const uint64_t hash = hashMesh(loader);
+    const size_t triCount = static_cast<size_t>(loader.getIndexCount()) / 3;
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        if (m_meshes[i].refCount > 0 && m_meshes[i].contentHash == hash && m_meshes[i].triangleCount == triCount)
+            return static_cast<uint32_t>(i);
+    }
+
+    const float* pos = loader.getPositions();
+    const unsigned int* idx = loader.getFaces();
+    const size_t vertCount = static_cast<size_t>(std::max(0, loader.getVertCount()));
+
+    MeshBVH mesh;
+    mesh.contentHash = hash;
+    mesh.triangleCount = triCount;
+    mesh.positions.assign(reinterpret_cast<const glm::vec3*>(pos), reinterpret_cast<const glm::vec3*>(pos) + vertCount);
+    mesh.indices.assign(idx, idx + triCount * 3);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        mesh.bounds.grow(mesh.positions[idx[i]]);
+
+    // Vertex attributes stay shared and indexed; only the final hit of a ray reads them
+    if (const float* normals = loader.getNormals())
+    {
+        const glm::vec3* begin = reinterpret_cast<const glm::vec3*>(normals);
+        mesh.normals.assign(begin, begin + vertCount);
+    }
+    if (loader.hasTexcoords())
+    {
+        const glm::vec2* begin = reinterpret_cast<const glm::vec2*>(loader.getTexcoords());
+        mesh.uvs.assign(begin, begin + vertCount);
+    }
+    if (loader.hasTangents())
+    {
+        const glm::vec3* begin = reinterpret_cast<const glm::vec3*>(loader.getTangents());
+        mesh.tangents.assign(begin, begin + vertCount);
+    }
+
+    uint32_t meshIndex;
+    if (!m_freeMeshes.empty())
+    {
+        meshIndex = m_freeMeshes.back();
+        m_freeMeshes.pop_back();
+        m_meshes[meshIndex] = std::move(mesh);
+    }
+    else
+    {
+        meshIndex = static_cast<uint32_t>(m_meshes.size());
+        m_meshes.push_back(std::move(mesh));
+    }
+    m_topLevelDirty = true;
+    return meshIndex;
+}
+
+uint32_t TwoLevelBVH::addInstance(uint32_t meshIndex, const glm::mat4& transform, uint32_t materialId)
+{
+    BVHInstance instance;
+    instance.meshIndex = meshIndex;
+    instance.materialId = materialId;
+    updateInstanceTransform(instance, transform);
+    m_meshes[meshIndex].refCount++;
+
+    uint32_t instanceIndex;
+    if (!m_freeInstances.empty())
+    {
+        instanceIndex = m_freeInstances.back();
+        m_freeInstances.pop_back();
+        m_instances[instanceIndex] = instance;
+    }
+    else
+    {
+        instanceIndex = static_cast<uint32_t>(m_instances.size());
+        m_instances.push_back(instance);
+    }
+    m_topLevelDirty = true;
+    return instanceIndex;
+}
+
+bool TwoLevelBVH::setInstanceTransform(uint32_t instanceIndex, const glm::mat4& transform)
+{
+    if (instanceIndex >= m_instances.size() || !m_instances[instanceIndex].active)
+        return false;
+    updateInstanceTransform(m_instances[instanceIndex], transform);
+    m_topLevelDirty = true;
+    return true;
+}
+
+bool TwoLevelBVH::setInstanceMaterial(uint32_t instanceIndex, uint32_t materialId)
+{
+    if (instanceIndex >= m_instances.size() || !m_instances[instanceIndex].active)
+        return false;
+    m_instances[instanceIndex].materialId = materialId;
+    return true;
+}
+
+bool TwoLevelBVH::removeInstance(uint32_t instanceIndex)
+{
+    if (instanceIndex >= m_instances.size() || !m_instances[instanceIndex].active)
+        return false;
+
+    BVHInstance& instance = m_instances[instanceIndex];
+    instance.active = false;
+    instance.worldBounds = AABB();
+    m_freeInstances.push_back(instanceIndex);
+
+    MeshBVH& mesh = m_meshes[instance.meshIndex];
+    if (--mesh.refCount == 0)
+    {
+        // Keep the slot so other mesh indices stay valid; drop the storage and let addMesh() reuse it
+        mesh.packets = std::vector<TrianglePacket>();
+        mesh.positions = std::vector<glm::vec3>();
+        mesh.indices = std::vector<uint32_t>();
+        mesh.normals = std::vector<glm::vec3>();
+        mesh.uvs = std::vector<glm::vec2>();
+        mesh.tangents = std::vector<glm::vec3>();
+        mesh.triangleCount = 0;
+        mesh.bvh = LinearBVH();
+        mesh.bounds = AABB();
+        mesh.contentHash = 0;
+        mesh.dirty = false;
+        m_freeMeshes.push_back(instance.meshIndex);
+    }
+
+    m_topLevelDirty = true;
+    return true;
+}
+
+void TwoLevelBVH::updateInstanceTransform(BVHInstance& instance, const glm::mat4& transform) const
+{
+    instance.objectToWorld = transform;
+    instance.worldToObject = glm::inverse(transform);
+
+    // Baked world-space triangles took their normal from the transformed edges, which flips
+    // under mirroring transforms; the geometric normal keeps that, vertex normals do not.
+    const glm::mat3 linear(transform);
+    instance.normalToWorld = glm::transpose(glm::inverse(linear));
+    instance.faceNormalSign = glm::determinant(linear) < 0.0f ? -1.0f : 1.0f;
+
+    instance.worldBounds = AABB();
+    const AABB& local = m_meshes[instance.meshIndex].bounds;
+    if (!local.valid())
+        return;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec3 p((corner & 1) ? local.max.x : local.min.x,
+                    (corner & 2) ? local.max.y : local.min.y,
+                    (corner & 4) ? local.max.z : local.min.z);
+        instance.worldBounds.grow(glm::vec3(transform * glm::vec4(p, 1.0f)));
+    }
+}
+
+bool TwoLevelBVH::buildMesh(MeshBVH& mesh, const BVHBuildSettings& settings, ThreadPool* pool) const
+{
+    BVHBuildSettings packetSettings = settings;
+    packetSettings.packetWidth = TrianglePacket::kWidth;
+
+    const uint64_t cacheKey = m_cache ? BVHCache::key(mesh.contentHash, mesh.triangleCount, packetSettings) : 0;
+    if (m_cache && m_cache->load(cacheKey, mesh))
+    {
+        mesh.dirty = false;
+        return true;
+    }
+
+    const glm::vec3* positions = mesh.positions.data();
+    const uint32_t* indices = mesh.indices.data();
+    std::vector<AABB> triBounds(mesh.triangleCount);
+    forEachChunk(pool, mesh.triangleCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            triBounds[i].grow(positions[indices[i * 3 + 0]]);
+            triBounds[i].grow(positions[indices[i * 3 + 1]]);
+            triBounds[i].grow(positions[indices[i * 3 + 2]]);
+        }
+    });
+    BVHBuildStats meshStats;
+    buildBVH(triBounds, packetSettings, mesh.bvh, meshStats, pool);
+
+    // Re-point each leaf from its primIndices range to a run of packets in leaf order, then fill the runs
+    const int width = TrianglePacket::kWidth;
+    std::vector<uint32_t> leaves;
+    std::vector<uint32_t> firstPrims;
+    leaves.reserve(meshStats.leafCount);
+    firstPrims.reserve(meshStats.leafCount);
+    uint32_t packetCount = 0;
+    for (uint32_t n = 0; n < mesh.bvh.nodes.size(); ++n)
+    {
+        LinearBVHNode& node = mesh.bvh.nodes[n];
+        if (!node.isLeaf())
+            continue;
+        leaves.push_back(n);
+        firstPrims.push_back(node.offset);
+        node.offset = packetCount;
+        packetCount += (node.primCount + width - 1) / width;
+    }
+    mesh.packets.assign(packetCount, TrianglePacket());
+    forEachChunk(pool, leaves.size(), [&](size_t begin, size_t end) {
+        for (size_t leaf = begin; leaf < end; ++leaf)
+        {
+            const LinearBVHNode& node = mesh.bvh.nodes[leaves[leaf]];
+            for (uint32_t i = 0; i < node.primCount; i += width)
+            {
+                TrianglePacket& packet = mesh.packets[node.offset + i / width];
+                for (int lane = 0; lane < width; ++lane)
+                {
+                    if (i + lane >= node.primCount)
+                    {
+                        clearTriangleLane(packet, lane);
+                        continue;
+                    }
+                    const uint32_t tri = mesh.bvh.primIndices[firstPrims[leaf] + i + lane];
+                    packTriangle(packet, lane, positions[indices[tri * 3 + 0]],
+                                 positions[indices[tri * 3 + 1]], positions[indices[tri * 3 + 2]], tri);
+                }
+            }
+        }
+    });
+
+    // Packets now carry the geometry and the source triangle ids
+    mesh.bvh.primIndices = std::vector<uint32_t>();
+    mesh.dirty = false;
+    if (m_cache)
+        m_cache->store(cacheKey, mesh);
+    return false;
+}
+
+void TwoLevelBVH::invalidateMeshes()
+{
+    for (MeshBVH& mesh : m_meshes)
+    {
+        if (mesh.refCount == 0)
+            continue;
+        mesh.dirty = true;
+        m_topLevelDirty = true;
+    }
+}
+
+void TwoLevelBVH::build(const BVHBuildSettings& meshSettings, ThreadPool* pool)
+{
+    if (!m_topLevelDirty)
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    m_stats.meshesBuilt = 0;
+    m_stats.meshesFromCache = 0;
+    m_stats.meshCount = 0;
+    m_stats.uniqueTriangles = 0;
+    m_stats.packetBytes = 0;
+
+    // Large meshes take every thread in turn; small ones are built side by side, one per thread
+    std::vector<uint32_t> smallMeshes;
+    std::vector<uint8_t> fromCache(m_meshes.size(), 0);
+    for (uint32_t i = 0; i < m_meshes.size(); ++i)
+    {
+        MeshBVH& mesh = m_meshes[i];
+        if (mesh.refCount == 0 || !mesh.dirty)
+            continue;
+        if (pool && mesh.triangleCount < kCooperativeBuildTriangles)
+            smallMeshes.push_back(i);
+        else
+            fromCache[i] = buildMesh(mesh, meshSettings, pool) ? 1 : 0;
+        m_stats.meshesBuilt++;
+    }
+    if (!smallMeshes.empty())
+    {
+        pool->parallelFor(static_cast<uint32_t>(smallMeshes.size()), [&](uint32_t i, unsigned) {
+            const uint32_t meshIndex = smallMeshes[i];
+            fromCache[meshIndex] = buildMesh(m_meshes[meshIndex], meshSettings, nullptr) ? 1 : 0;
+        });
+    }
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        const MeshBVH& mesh = m_meshes[i];
+        if (mesh.refCount == 0)
+            continue;
+        m_stats.meshesFromCache += fromCache[i];
+        m_stats.meshCount++;
+        m_stats.uniqueTriangles += mesh.triangleCount;
+        m_stats.packetBytes += mesh.packets.size() * sizeof(TrianglePacket);
+    }
+    m_stats.meshBuildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Removed instances and instances of empty meshes never enter the top level
+    std::vector<AABB> instanceBounds;
+    std::vector<uint32_t> instanceIds;
+    instanceBounds.reserve(m_instances.size());
+    instanceIds.reserve(m_instances.size());
+    m_stats.instanceCount = 0;
+    m_stats.instancedTriangles = 0;
+    for (size_t i = 0; i < m_instances.size(); ++i)
+    {
+        if (!m_instances[i].active)
+            continue;
+        m_stats.instanceCount++;
+        if (!m_instances[i].worldBounds.valid())
+            continue;
+        instanceBounds.push_back(m_instances[i].worldBounds);
+        instanceIds.push_back(static_cast<uint32_t>(i));
+        m_stats.instancedTriangles += m_meshes[m_instances[i].meshIndex].triangleCount;
+    }
+
+    buildBVHBinnedSAH(instanceBounds, topLevelSettings(), m_topLevel, m_stats.topLevel);
+    for (uint32_t& prim : m_topLevel.primIndices)
+        prim = instanceIds[prim];
+
+    m_topLevelDirty = false;
+}
+
+bool TwoLevelBVH::intersectLeaf(uint32_t instanceIndex, const LinearBVHNode& node, const PacketRay& objectRay,
+                                float& tMax, InstanceHit& hit, BVHTraversalStats& stats) const
+{
+    const MeshBVH& mesh = m_meshes[m_instances[instanceIndex].meshIndex];
+    stats.trianglesTested += node.primCount;
+    const uint32_t packetCount = (node.primCount + TrianglePacket::kWidth - 1) / TrianglePacket::kWidth;
+    const TrianglePacket* packets = &mesh.packets[node.offset];
+    PacketHit packetHit;
+    if (!m_kernel(packets, packetCount, objectRay, tMax, packetHit))
+        return false;
+
+    const TrianglePacket& packet = packets[packetHit.packet];
+    hit.instanceIndex = instanceIndex;
+    hit.triangleIndex = packet.primId[packetHit.lane];
+    hit.u = packetHit.u;
+    hit.v = packetHit.v;
+    hit.packet = &packet;
+    hit.lane = packetHit.lane;
+    return true;
+}
+
+bool TwoLevelBVH::intersectInstance(uint32_t instanceIndex, const Ray& ray, float& tMax, InstanceHit& hit,
+                                    BVHTraversalStats& stats) const
+{
+    const BVHInstance& instance = m_instances[instanceIndex];
+    const MeshBVH& mesh = m_meshes[instance.meshIndex];
+
+    // Leave the object-space direction unnormalized so hit distances stay in world units
+    Ray objectRay = ray;
+    objectRay.origin = glm::vec3(instance.worldToObject * glm::vec4(ray.origin, 1.0f));
+    objectRay.direction = glm::mat3(instance.worldToObject) * ray.direction;
+
+    RayTraversalData localRay(objectRay);
+    PacketRay packetRay;
+    packetRay.origin = objectRay.origin;
+    packetRay.direction = objectRay.direction;
+
+    bool found = false;
+    mesh.bvh.traverseLeaves(localRay, tMax, stats,
+        [&](const LinearBVHNode& node, float& tLocal) {
+            found |= intersectLeaf(instanceIndex, node, packetRay, tLocal, hit, stats);
+            return false;
+        });
+    return found;
+}
+
+bool TwoLevelBVH::intersect(const Ray& ray, InstanceHit& hit, BVHTraversalStats& stats) const
+{
+    float tHit = hit.t;
+    bool found = false;
+
+    RayTraversalData worldRay(ray);
+    m_topLevel.traverse(worldRay, tHit, stats,
+        [&](uint32_t instanceIndex, float& tMax) {
+            found |= intersectInstance(instanceIndex, ray, tMax, hit, stats);
+            return false;
+        });
+
+    if (found)
+        hit.t = tHit;
+    return found;
+}
+
+bool TwoLevelBVH::occludedInstance(uint32_t instanceIndex, const Ray& ray, float tMax, BVHTraversalStats& stats) const
+{
+    const BVHInstance& instance = m_instances[instanceIndex];
+    const MeshBVH& mesh = m_meshes[instance.meshIndex];
+
+    Ray objectRay = ray;
+    objectRay.origin = glm::vec3(instance.worldToObject * glm::vec4(ray.origin, 1.0f));
+    objectRay.direction = glm::mat3(instance.worldToObject) * ray.direction;
+
+    RayTraversalData localRay(objectRay);
+    PacketRay packetRay;
+    packetRay.origin = objectRay.origin;
+    packetRay.direction = objectRay.direction;
+
+    // A leaf is one kernel call, so the exit is per leaf rather than per triangle
+    const TrianglePacket* packets = mesh.packets.data();
+    return mesh.bvh.traverseLeaves(localRay, tMax, stats,
+        [&](const LinearBVHNode& node, float& tLocal) {
+            stats.trianglesTested += node.primCount;
+            const uint32_t packetCount = (node.primCount + TrianglePacket::kWidth - 1) / TrianglePacket::kWidth;
+            float tHit = tLocal;
+            PacketHit packetHit;
+            return m_kernel(packets + node.offset, packetCount, packetRay, tHit, packetHit);
+        });
+}
+
+bool TwoLevelBVH::occludedWorld(const Ray& ray, float tMax, uint32_t& occluder, BVHTraversalStats& stats) const
+{
+    RayTraversalData worldRay(ray);
+    return m_topLevel.traverse(worldRay, tMax, stats,
+        [&](uint32_t instanceIndex, float& t) {
+            if (!occludedInstance(instanceIndex, ray, t, stats))
+                return false;
+            occluder = instanceIndex;
+            return true;
+        });
+}
+
+bool TwoLevelBVH::occluded(const Ray& ray, float tMax, BVHTraversalStats& stats) const
+{
+    uint32_t occluder = 0;
+    return occludedWorld(ray, tMax, occluder, stats);
+}
+
+uint32_t TwoLevelBVH::occludedBatch(const glm::vec3& origin, const glm::vec3* directions, const float* tMax,
+                                    uint32_t count, BVHTraversalStats& stats) const
+{
+    uint32_t blocked = 0;
+    uint32_t lastOccluder = UINT32_MAX;
+    count = std::min<uint32_t>(count, 32u);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Ray ray(origin, directions[i]);
+        ray.direction = directions[i];
+
+        // Try the previous blocker before the full walk; it must still overlap this ray's interval
+        if (lastOccluder != UINT32_MAX)
+        {
+            const BVHInstance& instance = m_instances[lastOccluder];
+            const RayTraversalData worldRay(ray);
+            LinearBVHNode boundsNode;
+            boundsNode.boundsMin = instance.worldBounds.min;
+            boundsNode.boundsMax = instance.worldBounds.max;
+            if (intersectNodeBounds(boundsNode, worldRay, tMax[i]) &&
+                occludedInstance(lastOccluder, ray, tMax[i], stats))
+            {
+                blocked |= 1u << i;
+                continue;
+            }
+        }
+
+        uint32_t occluder = 0;
+        if (occludedWorld(ray, tMax[i], occluder, stats))
+        {
+            blocked |= 1u << i;
+            lastOccluder = occluder;
+        }
+    }
+    return blocked;
+}
+
+uint32_t TwoLevelBVH::intersectPacket(RayPacket& packet, uint32_t activeMask, InstanceHit* hits,
+                                      BVHTraversalStats& stats) const
+{
+    uint32_t hitMask = 0;
+    if (!activeMask)
+        return 0;
+
+    if (!packet.coherent)
+    {
+        // Mixed direction signs: no shared child order or interval bounds, trace rays one by one
+        for (int i = 0; i < RayPacket::kSize; ++i)
+        {
+            if (!(activeMask & (1u << i)))
+                continue;
+            Ray ray(packet.origin, packet.direction(i));
+            ray.direction = packet.direction(i);
+            InstanceHit hit;
+            hit.t = packet.tMax[i];
+            if (intersect(ray, hit, stats))
+            {
+                hits[i] = hit;
+                packet.tMax[i] = hit.t;
+                hitMask |= 1u << i;
+            }
+        }
+        return hitMask;
+    }
+
+    traversePacket(m_topLevel, packet, activeMask, stats,
+        [&](const LinearBVHNode& topNode, uint32_t mask) {
+            for (uint32_t k = 0; k < topNode.primCount; ++k)
+            {
+                const uint32_t instanceIndex = m_topLevel.primIndices[topNode.offset + k];
+                const BVHInstance& instance = m_instances[instanceIndex];
+                const MeshBVH& mesh = m_meshes[instance.meshIndex];
+
+                // Rays share an origin, so the object-space packet still does
+                RayPacket local;
+                local.origin = glm::vec3(instance.worldToObject * glm::vec4(packet.origin, 1.0f));
+                const glm::mat3 toObject(instance.worldToObject);
+                for (int i = 0; i < RayPacket::kSize; ++i)
+                {
+                    local.setDirection(i, toObject * packet.direction(i));
+                    local.tMax[i] = packet.tMax[i];
+                }
+                local.finalize(mask);
+
+                if (local.coherent)
+                {
+                    traversePacket(mesh.bvh, local, mask, stats,
+                        [&](const LinearBVHNode& node, uint32_t leafMask) {
+                            for (int i = 0; i < RayPacket::kSize; ++i)
+                            {
+                                if (!(leafMask & (1u << i)))
+                                    continue;
+                                PacketRay objectRay;
+                                objectRay.origin = local.origin;
+                                objectRay.direction = local.direction(i);
+                                if (intersectLeaf(instanceIndex, node, objectRay, local.tMax[i], hits[i], stats))
+                                    hitMask |= 1u << i;
+                            }
+                        });
+                }
+                else
+                {
+                    // The instance transform split the packet's direction signs
+                    for (int i = 0; i < RayPacket::kSize; ++i)
+                    {
+                        if (!(mask & (1u << i)))
+                            continue;
+                        Ray ray(packet.origin, packet.direction(i));
+                        ray.direction = packet.direction(i);
+                        if (intersectInstance(instanceIndex, ray, local.tMax[i], hits[i], stats))
+                            hitMask |= 1u << i;
+                    }
+                }
+
+                for (int i = 0; i < RayPacket::kSize; ++i)
+                {
+                    if (mask & (1u << i))
+                        packet.tMax[i] = local.tMax[i];
+                }
+            }
+        });
+
+    for (int i = 0; i < RayPacket::kSize; ++i)
+    {
+        if (hitMask & (1u << i))
+            hits[i].t = packet.tMax[i];
+    }
+    return hitMask;
+}
+
+SurfaceAttributes TwoLevelBVH::surfaceAttributes(const InstanceHit& hit) const
+{
+    const BVHInstance& instance = m_instances[hit.instanceIndex];
+    const MeshBVH& mesh = m_meshes[instance.meshIndex];
+
+    SurfaceAttributes surface;
+    surface.geometricNormal = geometricNormal(hit);
+    if (!interpolatedNormal(hit, surface.normal))
+        surface.normal = surface.geometricNormal;
+
+    const uint32_t* tri = &mesh.indices[static_cast<size_t>(hit.triangleIndex) * 3];
+    const float w = 1.0f - hit.u - hit.v;
+    if (!mesh.uvs.empty())
+    {
+        surface.uv = w * mesh.uvs[tri[0]] + hit.u * mesh.uvs[tri[1]] + hit.v * mesh.uvs[tri[2]];
+        surface.hasUV = true;
+    }
+    if (!mesh.tangents.empty())
+    {
+        const glm::vec3 t = w * mesh.tangents[tri[0]] + hit.u * mesh.tangents[tri[1]] + hit.v * mesh.tangents[tri[2]];
+        const glm::vec3 worldTangent = glm::mat3(instance.objectToWorld) * t;
+        if (glm::dot(worldTangent, worldTangent) > 1e-12f)
+        {
+            surface.tangent = glm::normalize(worldTangent);
+            surface.hasTangent = true;
+        }
+    }
+    return surface;
+}
+
+glm::vec3 TwoLevelBVH::shadingNormal(const InstanceHit& hit) const
+{
+    glm::vec3 normal;
+    return interpolatedNormal(hit, normal) ? normal : geometricNormal(hit);
+}
+
+bool TwoLevelBVH::interpolatedNormal(const InstanceHit& hit, glm::vec3& normal) const
+{
+    const BVHInstance& instance = m_instances[hit.instanceIndex];
+    const MeshBVH& mesh = m_meshes[instance.meshIndex];
+    if (mesh.normals.empty())
+        return false;
+
+    const uint32_t* tri = &mesh.indices[static_cast<size_t>(hit.triangleIndex) * 3];
+    const float w = 1.0f - hit.u - hit.v;
+    const glm::vec3 n = w * mesh.normals[tri[0]] + hit.u * mesh.normals[tri[1]] + hit.v * mesh.normals[tri[2]];
+    // Opposing vertex normals can cancel out; the face normal is the only sensible answer then
+    if (glm::dot(n, n) > 1e-12f)
+    {
+        normal = glm::normalize(instance.normalToWorld * n);
+        return true;
+    }
+    return false;
+}
+
+glm::vec3 TwoLevelBVH::geometricNormal(const InstanceHit& hit) const
+{
+    const BVHInstance& instance = m_instances[hit.instanceIndex];
+    const glm::vec3 faceNormal = glm::cross(hit.packet->e1(hit.lane), hit.packet->e2(hit.lane));
+    return glm::normalize(instance.normalToWorld * faceNormal) * instance.faceNormalSign;
+}
@@ -0,0 +1,228 @@
+// Machine Summary Block
+// {"file":"engine/modules/raytracing/two_level_bvh.h","purpose":"Declares the two-level acceleration structure: object-space mesh BVHs shared by transformed instances.","exports":["MeshBVH","BVHInstance","InstanceHit","SurfaceAttributes","TwoLevelBVH"],"depends_on":["linear_bvh.h","bvh_builder.h","bvh_cache.h","triangle_packet.h","objloader.h","glm/glm.hpp"],"notes":["meshes_deduplicated_by_content_hash","leaves_store_soa_triangle_packets","transform_changes_rebuild_top_level_only","rays_transformed_per_instance","early_exit_any_hit_queries","deferred_vertex_attribute_interpolation","optional_on_disk_mesh_bvh_cache","parallel_mesh_builds"]}
+// Human Summary
+// Bottom-level BVHs are built once per unique mesh in object space; a small top-level BVH over instance world bounds carries transforms and material ids.
+
+#pragma once
+/// @file two_level_bvh.h
+/// @brief Instanced two-level BVH used by the CPU ray tracer.
+
+#include <cfloat>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "linear_bvh.h"
+#include "bvh_builder.h"
+#include "bvh_cache.h"
+#include "triangle_packet.h"
+#include "ray_packet.h"
+#include "objloader.h"
+
+/// @brief Object-space triangle packets and their bottom-level hierarchy.
+/// @details Leaves store the index of their first packet in @c offset and their triangle count in
+/// @c primCount; a leaf owns ceil(primCount / TrianglePacket::kWidth) consecutive packets.
+struct MeshBVH
+{
+    std::vector<TrianglePacket> packets;     ///< Object-space triangles grouped per leaf.
+    std::vector<glm::vec3> positions;        ///< Object-space vertex positions, kept so the hierarchy can be rebuilt.
+    std::vector<uint32_t> indices;           ///< Three vertex indices per source triangle.
+    std::vector<glm::vec3> normals;          ///< Object-space vertex normals; empty shades with the face normal.
+    std::vector<glm::vec2> uvs;              ///< Vertex texture coordinates, or empty.
+    std::vector<glm::vec3> tangents;         ///< Object-space vertex tangents, or empty.
+    size_t triangleCount = 0;                ///< Source triangles in the mesh.
+    LinearBVH bvh;                           ///< Bottom-level hierarchy over @c packets.
+    AABB bounds;                             ///< Object-space bounds of all triangles.
+    uint64_t contentHash = 0;        ///< Hash of the source positions and indices.
+    uint32_t refCount = 0;           ///< Live instances referencing the mesh; storage is released at zero.
+    bool dirty = true;               ///< True until the bottom-level BVH has been built.
+};
+
+/// @brief Placement of a mesh in the scene together with its material id.
+struct BVHInstance
+{
+    uint32_t meshIndex = 0;                ///< Index into TwoLevelBVH::meshes().
+    glm::mat4 objectToWorld{1.0f};         ///< Instance transform.
+    glm::mat4 worldToObject{1.0f};         ///< Cached inverse transform used to move rays into object space.
+    glm::mat3 normalToWorld{1.0f};         ///< Inverse-transpose of the transform's linear part.
+    float faceNormalSign = 1.0f;           ///< -1 for mirroring transforms, which flip the winding of the triangles.
+    AABB worldBounds;                      ///< Mesh bounds transformed to world space.
+    uint32_t materialId = 0;               ///< Entry in the owner's material table, shared by every triangle.
+    bool active = true;                    ///< False once removed; ids of other instances stay stable and the slot is reused.
+};
+
+/// @brief Closest hit reported by TwoLevelBVH::intersect.
+struct InstanceHit
+{
+    float t = FLT_MAX;                  ///< World-space hit distance.
+    uint32_t instanceIndex = 0;         ///< Instance that was hit.
+    uint32_t triangleIndex = 0;         ///< Source triangle index within the instance's mesh.
+    float u = 0.0f;                     ///< Barycentric weight of the second vertex.
+    float v = 0.0f;                     ///< Barycentric weight of the third vertex.
+    const TrianglePacket* packet = nullptr; ///< Packet holding the hit triangle, or nullptr on miss.
+    uint32_t lane = 0;                  ///< Lane of the hit triangle within @c packet.
+};
+
+/// @brief World-space shading attributes of a hit.
+/// @details Intersection only reports distance and barycentrics; these are interpolated from the
+/// mesh's vertex attributes once the closest hit is known.
+struct SurfaceAttributes
+{
+    glm::vec3 geometricNormal{0.0f, 1.0f, 0.0f}; ///< Face normal, following the triangle winding.
+    glm::vec3 normal{0.0f, 1.0f, 0.0f};          ///< Interpolated vertex normal (the face normal without vertex normals).
+    glm::vec2 uv{0.0f};                          ///< Interpolated texture coordinates; zero without UVs.
+    glm::vec3 tangent{0.0f};                     ///< Interpolated tangent; zero without tangents.
+    bool hasUV = false;
+    bool hasTangent = false;
+};
+
+/// @brief Aggregate sizes and timings for the current acceleration structure.
+struct TwoLevelBVHStats
+{
+    size_t meshCount = 0;           ///< Unique meshes.
+    size_t instanceCount = 0;       ///< Live instances referencing those meshes.
+    size_t uniqueTriangles = 0;     ///< Triangles actually stored.
+    size_t packetBytes = 0;         ///< Memory held by triangle packets.
+    size_t instancedTriangles = 0;  ///< Triangles as seen by rays (sum over instances).
+    size_t meshesBuilt = 0;         ///< Bottom-level BVHs rebuilt by the last build().
+    size_t meshesFromCache = 0;     ///< Of those, hierarchies loaded from the BVH cache instead of built.
+    double meshBuildTimeMs = 0.0;   ///< Time spent on bottom-level builds in the last build().
+    BVHBuildStats topLevel;         ///< Statistics from the last top-level build.
+};
+
+/// @brief Instanced scene hierarchy: one bottom-level BVH per unique mesh plus a top-level BVH over instances.
+class TwoLevelBVH
+{
+public:
+    TwoLevelBVH();
+
+    /// @brief Caps the SIMD level of the leaf intersection kernel (the CPU may support less).
+    void setMaxTriangleKernel(TriangleKernel maxKernel);
+
+    /// @brief Returns the leaf intersection kernel in use.
+    TriangleKernel triangleKernel() const { return m_kernelType; }
+
+    /// @brief Loads and stores bottom-level BVHs through @p cache; nullptr (the default) always builds.
+    void setCache(std::shared_ptr<const BVHCache> cache) { m_cache = std::move(cache); }
+
+    /// @brief Returns the BVH cache, or nullptr when disabled.
+    const BVHCache* cache() const { return m_cache.get(); }
+
+    /// @brief Removes all meshes and instances.
+    void clear();
+
+    /// @brief Returns the mesh index for the loader's geometry, creating it if no identical mesh exists.
+    /// @param loader Mesh data source; positions and indices are hashed to detect duplicates.
+    /// @return Mesh index; slots of released meshes are reused.
+    uint32_t addMesh(const ObjLoader& loader);
+
+    /// @brief Places a mesh in the scene.
+    /// @param meshIndex Mesh returned by addMesh().
+    /// @param transform Object-to-world transform.
+    /// @param materialId Material table entry applied to the instance.
+    /// @return Instance index; slots of removed instances are reused.
+    uint32_t addInstance(uint32_t meshIndex, const glm::mat4& transform, uint32_t materialId);
+
+    /// @brief Moves an instance; only the top level is rebuilt on the next build().
+    /// @return False when the index is out of range or the instance was removed.
+    bool setInstanceTransform(uint32_t instanceIndex, const glm::mat4& transform);
+
+    /// @brief Points an instance at another material entry; the hierarchy is unaffected.
+    /// @return False when the index is out of range or the instance was removed.
+    bool setInstanceMaterial(uint32_t instanceIndex, uint32_t materialId);
+
+    /// @brief Removes an instance and releases its mesh once no other instance uses it.
+    /// @return False when the index is out of range or the instance was already removed.
+    bool removeInstance(uint32_t instanceIndex);
+
+    /// @brief Marks every mesh for a rebuild, e.g. after the builder settings changed.
+    void invalidateMeshes();
+
+    /// @brief Builds dirty bottom-level BVHs and the top-level BVH if anything changed.
+    /// @details With a pool, large meshes are built one after another with all threads, and
+    /// small meshes are built concurrently, one per thread.
+    /// @param meshSettings Builder parameters for bottom-level hierarchies; the packet width is
+    ///        always taken from TrianglePacket.
+    /// @param pool Threads to build with, or nullptr to build on the calling thread.
+    void build(const BVHBuildSettings& meshSettings, ThreadPool* pool = nullptr);
+
+    /// @brief Returns true when build() has pending work.
+    bool needsBuild() const { return m_topLevelDirty; }
+
+    /// @brief Finds the closest hit along a world-space ray.
+    /// @param ray World-space ray.
+    /// @param hit Receives the closest hit; untouched on miss.
+    /// @param stats Traversal counters for both levels.
+    /// @return True on hit.
+    bool intersect(const Ray& ray, InstanceHit& hit, BVHTraversalStats& stats) const;
+
+    /// @brief Finds the closest hits for a world-space packet of rays sharing one origin.
+    /// @details Coherent packets walk both levels together; once direction signs diverge (the
+    /// whole packet, or its image in an instance's object space) the remaining rays are traced
+    /// individually. Results match intersect() ray for ray.
+    /// @param packet World-space packet; tMax holds each ray's limit and is shrunk to its hit distance.
+    /// @param activeMask Rays to trace.
+    /// @param hits Array of RayPacket::kSize hits; entries of rays that miss are untouched.
+    /// @param stats Traversal counters; packet node visits count once per packet.
+    /// @return Mask of rays that hit.
+    uint32_t intersectPacket(RayPacket& packet, uint32_t activeMask, InstanceHit* hits, BVHTraversalStats& stats) const;
+
+    /// @brief Any-hit query: reports whether anything blocks the ray in (0, tMax).
+    /// @details Both levels are walked near child first and the walk stops at the first hit,
+    /// without tracking which hit is closest.
+    /// @param ray World-space ray.
+    /// @param tMax Distance along the ray beyond which blockers are ignored (e.g. the light distance).
+    /// @param stats Traversal counters for both levels.
+    /// @return True when the ray is blocked.
+    bool occluded(const Ray& ray, float tMax, BVHTraversalStats& stats) const;
+
+    /// @brief Any-hit queries for up to 32 rays leaving one point, e.g. a shading point's shadow rays.
+    /// @details The instance that blocked the previous ray is tested before walking the top
+    /// level, since lights seen from one point are often hidden behind the same object.
+    /// @param origin Shared world-space origin.
+    /// @param directions Normalized world-space directions.
+    /// @param tMax Per-ray distance limits.
+    /// @param count Number of rays, at most 32.
+    /// @param stats Traversal counters for both levels.
+    /// @return Mask of blocked rays (bit i for ray i).
+    uint32_t occludedBatch(const glm::vec3& origin, const glm::vec3* directions, const float* tMax,
+                           uint32_t count, BVHTraversalStats& stats) const;
+
+    /// @brief Interpolates the vertex attributes of a hit and moves them to world space.
+    /// @param hit Closest hit returned by intersect() or intersectPacket().
+    SurfaceAttributes surfaceAttributes(const InstanceHit& hit) const;
+
+    /// @brief Returns the world-space shading normal of a hit (the interpolated vertex normal)
+    /// without interpolating the other attributes.
+    glm::vec3 shadingNormal(const InstanceHit& hit) const;
+
+    const std::vector<MeshBVH>& meshes() const { return m_meshes; }
+    const std::vector<BVHInstance>& instances() const { return m_instances; }
+    const TwoLevelBVHStats& stats() const { return m_stats; }
+    bool empty() const { return m_instances.empty(); }
+
+private:
+    std::vector<MeshBVH> m_meshes;
+    std::vector<BVHInstance> m_instances;
+    std::vector<uint32_t> m_freeMeshes;
+    std::vector<uint32_t> m_freeInstances;
+    LinearBVH m_topLevel;
+    TwoLevelBVHStats m_stats;
+    bool m_topLevelDirty = false;
+    TrianglePacketIntersectFn m_kernel = nullptr;
+    TriangleKernel m_kernelType = TriangleKernel::Scalar;
+    std::shared_ptr<const BVHCache> m_cache;
+
+    /// @return True when the hierarchy came from the cache.
+    bool buildMesh(MeshBVH& mesh, const BVHBuildSettings& settings, ThreadPool* pool) const;
+    bool intersectLeaf(uint32_t instanceIndex, const LinearBVHNode& node, const PacketRay& objectRay,
+                       float& tMax, InstanceHit& hit, BVHTraversalStats& stats) const;
+    bool intersectInstance(uint32_t instanceIndex, const Ray& ray, float& tMax, InstanceHit& hit,
+                           BVHTraversalStats& stats) const;
+    bool occludedInstance(uint32_t instanceIndex, const Ray& ray, float tMax, BVHTraversalStats& stats) const;
+    bool occludedWorld(const Ray& ray, float tMax, uint32_t& occluder, BVHTraversalStats& stats) const;
+    void updateInstanceTransform(BVHInstance& instance, const glm::mat4& transform) const;
+    /// @return False when the mesh has no vertex normals or they cancel out at the hit.
+    bool interpolatedNormal(const InstanceHit& hit, glm::vec3& normal) const;
+    glm::vec3 geometricNormal(const InstanceHit& hit) const;
+};
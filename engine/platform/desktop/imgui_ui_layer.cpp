@@ -724,6 +724,12 @@ void ImGuiUILayer::renderSettingsPanel(const UIState& state)
                 ImGui::SameLine(120);
                 ImGui::Text("%zu (%.1f MB)", state.renderStats.uniqueTextures, state.renderStats.texturesMB);
                 
+                if (state.renderStats.renderTargetsMB > 0.0f) {
+                    ImGui::Text("Targets:");
+                    ImGui::SameLine(120);
+                    ImGui::Text("%.1f MB", state.renderStats.renderTargetsMB);
+                }
+                
                 ImGui::Text("Est. VRAM:");
                 ImGui::SameLine(120);
                 ImGui::Text("%.1f MB", state.renderStats.vramMB);
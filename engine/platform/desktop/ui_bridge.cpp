@@ -1111,6 +1111,8 @@ std::string UIBridge::buildShareLink() const
         addLightOp.AddMember("color", lightColor, allocator);
         
         addLightOp.AddMember("intensity", light.intensity, allocator);
+        if (light.type != LightType::DIRECTIONAL && light.range > 0.0f)
+            addLightOp.AddMember("range", light.range, allocator);
         
         ops.PushBack(addLightOp, allocator);
     }
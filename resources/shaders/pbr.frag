@@ -6,12 +6,72 @@ in vec3 vWorldPos;
 in vec2 vUV;
 in mat3 vTBN;
 
-// Lights
-struct Light { vec3 position; vec3 color; float intensity; };
-#define MAX_LIGHTS 10
-uniform int numLights;
-uniform Light lights[MAX_LIGHTS];
-uniform vec3 viewPos;
+// Per-frame camera and tone-mapping state (std140, see uniform_buffers.h)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float exposure;
+    float gamma;
+    int toneMappingMode;
+    int shadingMode; // 0=Flat, 1=Gouraud
+};
+
+// Light grid (std140, see uniform_buffers.h); the lights themselves live in buffer textures (light_clusters.h)
+layout(std140) uniform LightBlock {
+    vec4 globalAmbient; // .a is often unused, so we just use .rgb
+    vec4 clusterDepth;  // x = scale, y = bias: slice = floor(log(view depth) * x + y)
+    ivec4 clusterDims;  // tiles across x, tiles across y, depth slices
+    ivec4 lightCounts;  // x = lights in lightData, y = unbounded lights heading clusterLights
+};
+
+// 4 texels per light: (position, intensity) (color, range) (direction, type) (cone cosines)
+uniform samplerBuffer lightData;
+
+struct Light {
+    vec3 position;
+    float intensity; // If 0, treat as disabled
+    vec3 color;
+    float range;     // 0 = unbounded
+};
+
+Light fetchLight(int index)
+{
+    vec4 a = texelFetch(lightData, index * 4);
+    vec4 b = texelFetch(lightData, index * 4 + 1);
+    return Light(a.xyz, a.w, b.rgb, b.w);
+}
+
+// Smooth cutoff of ranged lights, 0 at the range (lightRangeWindow in light.h)
+float rangeWindow(float dist, float range)
+{
+    if (range <= 0.0) return 1.0;
+    float x = dist / range;
+    float w = clamp(1.0 - x * x * x * x, 0.0, 1.0);
+    return w * w;
+}
+
+// Per-cluster light lists, binned on the CPU every frame
+uniform usamplerBuffer clusterRanges; // (first, count) into clusterLights per cluster
+uniform usamplerBuffer clusterLights; // light indices: the unbounded lights, then every cluster's list
+
+// Cluster list of a visible world-space point as (first, count)
+ivec2 clusterLightRange(vec3 worldPos)
+{
+    vec4 viewSpace = view * vec4(worldPos, 1.0);
+    vec4 clip = projection * viewSpace;
+    ivec3 cell;
+    cell.xy = clamp(ivec2(floor((clip.xy / clip.w * 0.5 + 0.5) * vec2(clusterDims.xy))), ivec2(0), clusterDims.xy - 1);
+    cell.z = clamp(int(floor(log(max(-viewSpace.z, 1e-6)) * clusterDepth.x + clusterDepth.y)), 0, clusterDims.z - 1);
+    return ivec2(texelFetch(clusterRanges, (cell.z * clusterDims.y + cell.y) * clusterDims.x + cell.x).xy);
+}
+
+// k-th light reaching the point: unbounded lights first, then the cluster's own
+int clusterLightIndex(int k, ivec2 cluster)
+{
+    int entry = k < lightCounts.y ? k : cluster.x + (k - lightCounts.y);
+    return int(texelFetch(clusterLights, entry).r);
+}
 
 // PBR inputs
 uniform vec4 baseColorFactor; // rgba
@@ -87,13 +147,16 @@ void main() {
 
     vec3 Lo = vec3(0.0);
     float shadow = calculateShadow(lightSpaceMatrix * vec4(vWorldPos, 1.0));
-    for (int i=0;i<numLights;i++) {
-        if (lights[i].intensity <= 0.0) continue;
-        vec3 L = normalize(lights[i].position - vWorldPos);
+    ivec2 cluster = clusterLightRange(vWorldPos);
+    int lightTotal = lightCounts.y + cluster.y;
+    for (int k=0;k<lightTotal;k++) {
+        Light light = fetchLight(clusterLightIndex(k, cluster));
+        if (light.intensity <= 0.0) continue;
+        vec3 L = normalize(light.position - vWorldPos);
         vec3 H = normalize(V + L);
-        float dist = length(lights[i].position - vWorldPos);
-        float atten = 1.0 / (dist*dist);
-        vec3 radiance = lights[i].color * lights[i].intensity * atten;
+        float dist = length(light.position - vWorldPos);
+        float atten = rangeWindow(dist, light.range) / (dist*dist);
+        vec3 radiance = light.color * light.intensity * atten;
 
         float NDF = DistributionGGX(N, H, roughness);
         float G   = GeometrySmith(N, V, L, roughness);
@@ -7,8 +7,17 @@ layout(location = 3) in vec3 aTangent;
 uniform bool hasTangents = false;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Per-frame camera and tone-mapping state (std140, see uniform_buffers.h)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float exposure;
+    float gamma;
+    int toneMappingMode;
+    int shadingMode; // 0=Flat, 1=Gouraud
+};
 
 out vec3 vWorldPos;
 out vec2 vUV;
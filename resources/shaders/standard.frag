@@ -13,23 +13,76 @@ uniform mat4 lightSpaceMatrix;
 // For texturing & shading controls
 uniform sampler2D cowTexture;
 uniform bool useTexture;
-uniform int shadingMode;
 uniform vec3 objectColor; // fallback if no texture
+uniform bool unlit;       // output objectColor as-is (selection overlay)
+
+// Per-frame camera and tone-mapping state (std140, see uniform_buffers.h)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float exposure;
+    float gamma;
+    int toneMappingMode;
+    int shadingMode; // 0=Flat, 1=Gouraud
+};
 
 // ------------------------------------------------------------------------
-// Global ambient
-uniform vec4 globalAmbient; // .a is often unused, so we just use .rgb
+// Light grid (std140, see uniform_buffers.h); the lights themselves live in buffer textures (light_clusters.h)
+layout(std140) uniform LightBlock {
+    vec4 globalAmbient; // .a is often unused, so we just use .rgb
+    vec4 clusterDepth;  // x = scale, y = bias: slice = floor(log(view depth) * x + y)
+    ivec4 clusterDims;  // tiles across x, tiles across y, depth slices
+    ivec4 lightCounts;  // x = lights in lightData, y = unbounded lights heading clusterLights
+};
+
+// 4 texels per light: (position, intensity) (color, range) (direction, type) (cone cosines)
+uniform samplerBuffer lightData;
 
-// Light struct
 struct Light {
     vec3 position;
-    vec3 color;
     float intensity; // If 0, treat as disabled
+    vec3 color;
+    float range;     // 0 = unbounded
 };
 
-#define MAX_LIGHTS 10
-uniform int numLights;
-uniform Light lights[MAX_LIGHTS];
+Light fetchLight(int index)
+{
+    vec4 a = texelFetch(lightData, index * 4);
+    vec4 b = texelFetch(lightData, index * 4 + 1);
+    return Light(a.xyz, a.w, b.rgb, b.w);
+}
+
+// Smooth cutoff of ranged lights, 0 at the range (lightRangeWindow in light.h)
+float rangeWindow(float dist, float range)
+{
+    if (range <= 0.0) return 1.0;
+    float x = dist / range;
+    float w = clamp(1.0 - x * x * x * x, 0.0, 1.0);
+    return w * w;
+}
+
+// Per-cluster light lists, binned on the CPU every frame
+uniform usamplerBuffer clusterRanges; // (first, count) into clusterLights per cluster
+uniform usamplerBuffer clusterLights; // light indices: the unbounded lights, then every cluster's list
+
+// Cluster list of a visible world-space point as (first, count)
+ivec2 clusterLightRange(vec3 worldPos)
+{
+    vec4 viewSpace = view * vec4(worldPos, 1.0);
+    vec4 clip = projection * viewSpace;
+    ivec3 cell;
+    cell.xy = clamp(ivec2(floor((clip.xy / clip.w * 0.5 + 0.5) * vec2(clusterDims.xy))), ivec2(0), clusterDims.xy - 1);
+    cell.z = clamp(int(floor(log(max(-viewSpace.z, 1e-6)) * clusterDepth.x + clusterDepth.y)), 0, clusterDims.z - 1);
+    return ivec2(texelFetch(clusterRanges, (cell.z * clusterDims.y + cell.y) * clusterDims.x + cell.x).xy);
+}
+
+// k-th light reaching the point: unbounded lights first, then the cluster's own
+int clusterLightIndex(int k, ivec2 cluster)
+{
+    int entry = k < lightCounts.y ? k : cluster.x + (k - lightCounts.y);
+    return int(texelFetch(clusterLights, entry).r);
+}
 
 // ------------------------------------------------------------------------
 // Material struct
@@ -43,9 +96,6 @@ struct Material {
 };
 uniform Material material;
 
-// Camera position (for specular reflection in Gouraud)
-uniform vec3 viewPos;
-
 // ------------------------------------------------------------------------
 // Calculate Shadow
 float calculateShadow(vec4 fragPosLightSpace)
@@ -76,6 +126,10 @@ void main()
 {
     // Base color from either texture or fallback color
     vec3 baseColor = useTexture ? texture(cowTexture, UV).rgb : objectColor;
+    if (unlit) {
+        FragColor = vec4(baseColor, 1.0);
+        return;
+    }
 
     // Shadow factor
     float shadow = calculateShadow(lightSpaceMatrix * vec4(FragPos, 1.0));
@@ -87,11 +141,16 @@ void main()
         // ----- FLAT Shading -----
         vec3 faceNormal = normalize(cross(dFdx(FragPos), dFdy(FragPos)));
 
-        for (int i = 0; i < numLights; i++) {
-            if (lights[i].intensity <= 0.0) continue;
-            vec3 L = normalize(lights[i].position - FragPos);
+        ivec2 cluster = clusterLightRange(FragPos);
+        int lightTotal = lightCounts.y + cluster.y;
+        for (int k = 0; k < lightTotal; k++) {
+            Light light = fetchLight(clusterLightIndex(k, cluster));
+            if (light.intensity <= 0.0) continue;
+            vec3 toLight = light.position - FragPos;
+            vec3 L = normalize(toLight);
             float diff = max(dot(faceNormal, L), 0.0);
-            totalLight += shadow * material.diffuse * diff * lights[i].color * lights[i].intensity;
+            float window = rangeWindow(length(toLight), light.range);
+            totalLight += shadow * material.diffuse * diff * light.color * light.intensity * window;
         }
     }
     else if (shadingMode == 1) {
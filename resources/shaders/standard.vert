@@ -5,11 +5,17 @@ layout(location = 1) in vec3 aNormal;
 
 // Matrices
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
-// Shading mode: 0=Flat, 1=Gouraud
-uniform int shadingMode;
+// Per-frame camera and tone-mapping state (std140, see uniform_buffers.h)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float exposure;
+    float gamma;
+    int toneMappingMode;
+    int shadingMode; // 0=Flat, 1=Gouraud
+};
 
 // Outputs to the fragment shader
 out vec3 FragPos;
@@ -17,16 +23,39 @@ out vec3 Normal;
 out vec3 GouraudLight;
 out vec2 UV;
 
-// Lights
+// Light grid (std140, see uniform_buffers.h); the lights themselves live in buffer textures (light_clusters.h)
+layout(std140) uniform LightBlock {
+    vec4 globalAmbient; // .a is often unused, so we just use .rgb
+    vec4 clusterDepth;  // x = scale, y = bias: slice = floor(log(view depth) * x + y)
+    ivec4 clusterDims;  // tiles across x, tiles across y, depth slices
+    ivec4 lightCounts;  // x = lights in lightData, y = unbounded lights heading clusterLights
+};
+
+// 4 texels per light: (position, intensity) (color, range) (direction, type) (cone cosines)
+uniform samplerBuffer lightData;
+
 struct Light {
     vec3 position;
+    float intensity; // If 0, treat as disabled
     vec3 color;
-    float intensity;
+    float range;     // 0 = unbounded
 };
 
-#define MAX_LIGHTS 10
-uniform int numLights;
-uniform Light lights[MAX_LIGHTS];
+Light fetchLight(int index)
+{
+    vec4 a = texelFetch(lightData, index * 4);
+    vec4 b = texelFetch(lightData, index * 4 + 1);
+    return Light(a.xyz, a.w, b.rgb, b.w);
+}
+
+// Smooth cutoff of ranged lights, 0 at the range (lightRangeWindow in light.h)
+float rangeWindow(float dist, float range)
+{
+    if (range <= 0.0) return 1.0;
+    float x = dist / range;
+    float w = clamp(1.0 - x * x * x * x, 0.0, 1.0);
+    return w * w;
+}
 
 // Material for Gouraud specular
 struct Material {
@@ -39,7 +68,6 @@ struct Material {
 };
 
 uniform Material material;
-uniform vec3 viewPos; // Camera position in world space
 
 void main()
 {
@@ -61,17 +89,23 @@ void main()
         vec3 normal = normalize(Normal);
         vec3 viewDir = normalize(viewPos - FragPos);
 
-        for (int i = 0; i < numLights; i++) {
-            vec3 lightDir = normalize(lights[i].position - FragPos);
+        // Vertices of visible triangles can lie outside the view frustum, where there are no
+        // clusters, so the per-vertex path walks the whole light buffer
+        for (int i = 0; i < lightCounts.x; i++) {
+            Light light = fetchLight(i);
+            if (light.intensity <= 0.0) continue;
+            vec3 toLight = light.position - FragPos;
+            vec3 lightDir = normalize(toLight);
+            vec3 radiance = light.color * light.intensity * rangeWindow(length(toLight), light.range);
 
             // Diffuse
             float diff = max(dot(normal, lightDir), 0.0);
-            vec3 diffuse = material.diffuse * diff * lights[i].color * lights[i].intensity;
+            vec3 diffuse = material.diffuse * diff * radiance;
 
             // Specular (Phong reflection model but computed at vertex)
             vec3 reflectDir = reflect(-lightDir, normal);
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-            vec3 specular = material.specular * spec * lights[i].color * lights[i].intensity;
+            vec3 specular = material.specular * spec * radiance;
 
             GouraudLight += diffuse + specular;
         }